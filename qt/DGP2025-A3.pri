@@ -20,6 +20,8 @@ UTIL_DIR = $$SOURCEDIR/util
 WRL_DIR  = $$SOURCEDIR/wrl
 
 SOURCES += \
+	$$SOURCEDIR/core/ConcurrentPartition.cpp \
+	$$SOURCEDIR/core/CoordSoA.cpp \
 	$$SOURCEDIR/core/Edges.cpp \
 	$$SOURCEDIR/core/Faces.cpp \
 	$$SOURCEDIR/core/Geometry.cpp \
@@ -51,18 +53,26 @@ SOURCES += \
 #
         $$SOURCEDIR/io/AppLoader.cpp \
 	$$SOURCEDIR/io/AppSaver.cpp \
+	$$SOURCEDIR/io/FormatBuffer.cpp \
+	$$SOURCEDIR/io/LoaderDgp.cpp \
 	$$SOURCEDIR/io/LoaderPly.cpp \
 	$$SOURCEDIR/io/LoaderStl.cpp \
 	$$SOURCEDIR/io/LoaderWrl.cpp \
+	$$SOURCEDIR/io/SaverDgp.cpp \
 	$$SOURCEDIR/io/SaverPly.cpp \
 	$$SOURCEDIR/io/SaverStl.cpp \
 	$$SOURCEDIR/io/SaverWrl.cpp \
 	$$SOURCEDIR/io/Tokenizer.cpp \
+	$$SOURCEDIR/io/TokenizerBuffer.cpp \
 	$$SOURCEDIR/io/TokenizerFile.cpp \
 	$$SOURCEDIR/io/TokenizerString.cpp \
 #
 	$$SOURCEDIR/util/BBox.cpp \
+	$$SOURCEDIR/util/BitSet.cpp \
+	$$SOURCEDIR/util/DgpFile.cpp \
 	$$SOURCEDIR/util/Endian.cpp \
+	$$SOURCEDIR/util/MappedFile.cpp \
+	$$SOURCEDIR/util/Parallel.cpp \
 	$$SOURCEDIR/util/StaticRotation.cpp \
 #
 	$$SOURCEDIR/wrl/Ply.cpp \
@@ -88,6 +98,8 @@ SOURCES += \
         $$(NULL)
 
 HEADERS += \
+	$$SOURCEDIR/core/ConcurrentPartition.hpp \
+	$$SOURCEDIR/core/CoordSoA.hpp \
 	$$SOURCEDIR/core/Edges.hpp \
 	$$SOURCEDIR/core/Faces.hpp \
 	$$SOURCEDIR/core/Geometry.hpp \
@@ -122,22 +134,30 @@ HEADERS += \
 #
 	$$SOURCEDIR/io/AppLoader.hpp \
 	$$SOURCEDIR/io/AppSaver.hpp \
+	$$SOURCEDIR/io/FormatBuffer.hpp \
 	$$SOURCEDIR/io/Loader.hpp \
+	$$SOURCEDIR/io/LoaderDgp.hpp \
 	$$SOURCEDIR/io/LoaderPly.hpp \
 	$$SOURCEDIR/io/LoaderStl.hpp \
 	$$SOURCEDIR/io/LoaderWrl.hpp \
 	$$SOURCEDIR/io/Saver.hpp \
+	$$SOURCEDIR/io/SaverDgp.hpp \
 	$$SOURCEDIR/io/SaverPly.hpp \
 	$$SOURCEDIR/io/SaverStl.hpp \
 	$$SOURCEDIR/io/SaverWrl.hpp \
 	$$SOURCEDIR/io/StrException.hpp \
 	$$SOURCEDIR/io/Tokenizer.hpp \
+	$$SOURCEDIR/io/TokenizerBuffer.hpp \
 	$$SOURCEDIR/io/TokenizerFile.hpp \
 	$$SOURCEDIR/io/TokenizerString.hpp \
 #
 	$$SOURCEDIR/util/CastMacros.hpp \
 	$$SOURCEDIR/util/BBox.hpp \
+	$$SOURCEDIR/util/BitSet.hpp \
+	$$SOURCEDIR/util/DgpFile.hpp \
 	$$SOURCEDIR/util/Endian.hpp \
+	$$SOURCEDIR/util/MappedFile.hpp \
+	$$SOURCEDIR/util/Parallel.hpp \
 	$$SOURCEDIR/util/StaticRotation.hpp \
 #
 	$$SOURCEDIR/wrl/Ply.hpp \
@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// ConcurrentPartition.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "ConcurrentPartition.hpp"
+#include "util/Parallel.hpp"
+
+template<class Index>
+ConcurrentPartitionT<Index>::ConcurrentPartitionT(const Index nElements):
+  _nElements(0),
+  _nParts(0),
+  _parent() {
+  reset(nElements);
+}
+
+template<class Index>
+void ConcurrentPartitionT<Index>::reset(const Index nElements) {
+  _nElements = (nElements>0)?nElements:0;
+  _nParts.store(_nElements);
+  _parent.reset((_nElements>0)?new atomic<Index>[_nElements]:nullptr);
+  for(Index i=0;i<_nElements;i++)
+    _parent[i].store(i,memory_order_relaxed);
+}
+
+template<class Index>
+Index ConcurrentPartitionT<Index>::getNumberOfElements() const {
+  return _nElements;
+}
+
+template<class Index>
+Index ConcurrentPartitionT<Index>::getNumberOfParts() const {
+  return _nParts.load();
+}
+
+template<class Index>
+Index ConcurrentPartitionT<Index>::find(const Index i) {
+  if(i<0 || i>=_nElements) return -1;
+  Index j = i;
+  Index Pj = _parent[j].load(memory_order_acquire);
+  while(Pj!=j) {
+    Index PPj = _parent[Pj].load(memory_order_acquire);
+    // path halving: point j to its grandparent; a failure only means
+    // that another thread has already shortened the path
+    if(PPj!=Pj)
+      _parent[j].compare_exchange_weak(Pj,PPj,memory_order_acq_rel);
+    j  = PPj;
+    Pj = _parent[j].load(memory_order_acquire);
+  }
+  return j;
+}
+
+template<class Index>
+Index ConcurrentPartitionT<Index>::join(const Index i, const Index j) {
+  if(i<0 || i>=_nElements || j<0 || j>=_nElements) return -1;
+  Index Ri = i, Rj = j;
+  while(true) {
+    Ri = find(Ri);
+    Rj = find(Rj);
+    if(Ri==Rj) return Ri;
+    // link the root with the larger index to the other one
+    if(Ri<Rj) { Index R=Ri; Ri=Rj; Rj=R; }
+    Index expected = Ri;
+    if(_parent[Ri].compare_exchange_strong
+       (expected,Rj,memory_order_acq_rel)) {
+      _nParts.fetch_sub(1,memory_order_relaxed);
+      return Rj;
+    }
+    // Ri is no longer a root; try again
+  }
+}
+
+template<class Index>
+Index ConcurrentPartitionT<Index>::getPartLabels
+(vector<Index>& label, const int nThreads) {
+  const int nT = Parallel::getNumberOfThreads(nThreads,_nElements,1<<14);
+  label.resize(_nElements);
+  // 1) count the roots in each range
+  vector<Index> rangeFirstLabel(nT+1,0);
+  Parallel::forEachRange(nT,_nElements,[&](int iT, size_t i0, size_t i1) {
+      Index nRoots = 0;
+      for(size_t i=i0;i<i1;i++)
+        if(_parent[i].load(memory_order_relaxed)==static_cast<Index>(i))
+          nRoots++;
+      rangeFirstLabel[iT+1] = nRoots;
+    });
+  Parallel::prefixSum(rangeFirstLabel,1);
+  // 2) label the roots in increasing order
+  Parallel::forEachRange(nT,_nElements,[&](int iT, size_t i0, size_t i1) {
+      Index iLabel = rangeFirstLabel[iT];
+      for(size_t i=i0;i<i1;i++)
+        if(_parent[i].load(memory_order_relaxed)==static_cast<Index>(i))
+          label[i] = iLabel++;
+    });
+  // 3) every other element gets the label of its root
+  Parallel::forEachRange(nT,_nElements,[&](int, size_t i0, size_t i1) {
+      for(size_t i=i0;i<i1;i++) {
+        Index Ri = find(static_cast<Index>(i));
+        if(Ri!=static_cast<Index>(i)) label[i] = label[Ri];
+      }
+    });
+  return rangeFirstLabel[nT];
+}
+
+template class ConcurrentPartitionT<int>;
+template class ConcurrentPartitionT<int64_t>;
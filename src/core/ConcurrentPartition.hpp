@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// ConcurrentPartition.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef _CONCURRENT_PARTITION_HPP_
+#define _CONCURRENT_PARTITION_HPP_
+
+#include <cstdint>
+#include <vector>
+#include <atomic>
+#include <memory>
+
+using namespace std;
+
+template<class Index>
+class ConcurrentPartitionT {
+
+  // this class implements a lock-free variant of the Union-Find data
+  // structure implemented by the Partition class; the find() and
+  // join() methods can be called concurrently from multiple threads
+  //
+  // - the parent links are atomic, and a root is linked to another
+  //   root with a compare-and-swap operation, which fails and is
+  //   retried if a concurrent join() linked the first root before
+  // - the root with the larger index is always linked to the root
+  //   with the smaller index; as a result the ID of each part is the
+  //   smallest element of the part, and does not depend on the order
+  //   in which the join operations were performed
+  // - find() compresses paths by halving, i.e., by linking every
+  //   other node along the path to its grandparent
+  // - as for PartitionT, the Index type of the elements is int or
+  //   int64_t
+  //
+  // Reference
+  // https://en.wikipedia.org/wiki/Disjoint-set_data_structure
+
+public:
+
+  // create a partition of the N elements {0,1,2,...,N-1} where
+  // every element is a singleton {0},{1},{2},...,{N-1}
+          ConcurrentPartitionT(const Index nElements);
+
+  // same as Partition::reset(); should not be called concurrently
+  // with any other method
+  void    reset(const Index nElements);
+
+  Index   getNumberOfElements()          const;
+
+  // returns the current number of parts
+  Index   getNumberOfParts()             const;
+
+  // returns the part ID of the part containing element i, which is
+  // the smallest element of the part at the time of the call; if the
+  // element index is out of range this method returns -1
+  Index   find(const Index i);
+
+  // joins the parts containing elements i and j, and returns the ID
+  // of the joined part; if either one of the two element indices is
+  // out of range this method returns -1
+  Index   join(const Index i, const Index j);
+
+  // assigns consecutive labels 0<=label[i]<nParts to the parts, in
+  // increasing order of their smallest element, and returns nParts;
+  // should not be called concurrently with join(); the work is split
+  // amongst nThreads threads
+  Index   getPartLabels(vector<Index>& label, const int nThreads=0);
+
+private:
+
+  Index                       _nElements;
+  atomic<Index>               _nParts;
+  unique_ptr<atomic<Index>[]> _parent;
+
+};
+
+typedef ConcurrentPartitionT<int>     ConcurrentPartition;
+typedef ConcurrentPartitionT<int64_t> ConcurrentPartition64;
+
+extern template class ConcurrentPartitionT<int>;
+extern template class ConcurrentPartitionT<int64_t>;
+
+#endif /* _CONCURRENT_PARTITION_HPP_ */
@@ -0,0 +1,135 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// CoordSoA.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <new>
+#include "CoordSoA.hpp"
+#include "util/Parallel.hpp"
+
+CoordSoA::CoordSoA():
+  _nPoints(0),
+  _capacity(0),
+  _data((float*)0),
+  _x((float*)0),
+  _y((float*)0),
+  _z((float*)0),
+  _source((const float*)0) {
+}
+
+CoordSoA::CoordSoA(const vector<float>& coord, const int nThreads):
+  _nPoints(0),
+  _capacity(0),
+  _data((float*)0),
+  _x((float*)0),
+  _y((float*)0),
+  _z((float*)0),
+  _source((const float*)0) {
+  set(coord,nThreads);
+}
+
+CoordSoA::~CoordSoA() {
+  clear();
+}
+
+void CoordSoA::clear() {
+  if(_data!=(float*)0)
+    ::operator delete[](_data,align_val_t(ALIGNMENT));
+  _nPoints  = 0;
+  _capacity = 0;
+  _data     = (float*)0;
+  _x = _y = _z = (float*)0;
+  _source   = (const float*)0;
+}
+
+// private
+void CoordSoA::_allocate(const int nPoints) {
+  // round up to a multiple of 16 floats, i.e. of 64 bytes
+  const size_t capacity = (static_cast<size_t>(nPoints)+15)&~static_cast<size_t>(15);
+  if(capacity!=_capacity) {
+    clear();
+    if(capacity>0)
+      _data = static_cast<float*>
+        (::operator new[](3*capacity*sizeof(float),align_val_t(ALIGNMENT)));
+    _capacity = capacity;
+  }
+  _nPoints = nPoints;
+  _x = _data;
+  _y = (_data!=(float*)0)?_data+  _capacity:(float*)0;
+  _z = (_data!=(float*)0)?_data+2*_capacity:(float*)0;
+}
+
+void CoordSoA::set(const vector<float>& coord, const int nThreads) {
+  const int nPoints = static_cast<int>(coord.size()/3);
+  _allocate(nPoints);
+  _source = coord.data();
+  if(nPoints==0) return;
+  const float* src = coord.data();
+  const int nT = Parallel::getNumberOfThreads(nThreads,nPoints,1<<16);
+  Parallel::forEachRange(nT,nPoints,[&](int, size_t i0, size_t i1) {
+      for(size_t i=i0;i<i1;i++) {
+        _x[i] = src[3*i  ];
+        _y[i] = src[3*i+1];
+        _z[i] = src[3*i+2];
+      }
+    });
+  for(size_t i=nPoints;i<_capacity;i++) {
+    _x[i] = _x[0]; _y[i] = _y[0]; _z[i] = _z[0];
+  }
+}
+
+void CoordSoA::get(vector<float>& coord, const int nThreads) const {
+  coord.resize(3*static_cast<size_t>(_nPoints));
+  if(_nPoints==0) return;
+  float* dst = coord.data();
+  const int nT = Parallel::getNumberOfThreads(nThreads,_nPoints,1<<16);
+  Parallel::forEachRange(nT,_nPoints,[&](int, size_t i0, size_t i1) {
+      for(size_t i=i0;i<i1;i++) {
+        dst[3*i  ] = _x[i];
+        dst[3*i+1] = _y[i];
+        dst[3*i+2] = _z[i];
+      }
+    });
+}
+
+bool CoordSoA::isSynchronized(const vector<float>& coord) const {
+  return
+    _source==coord.data() &&
+    static_cast<size_t>(_nPoints)==coord.size()/3;
+}
@@ -0,0 +1,116 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// CoordSoA.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef _COORD_SOA_HPP_
+#define _COORD_SOA_HPP_
+
+#include <vector>
+#include <cstddef>
+
+using namespace std;
+
+class CoordSoA {
+
+  // structure-of-arrays copy of an array of interleaved 3D coordinates
+  // coord[3*iV+k]; the x, y, and z values are stored in three
+  // separate arrays, each one aligned to a 64 byte boundary and padded
+  // to a multiple of 16 floats, so that the geometry kernels can load
+  // and store full SIMD registers without any shuffles
+  //
+  // the object is a snapshot of the interleaved array at the time of
+  // the last call to set(); it is the responsibility of the caller to
+  // call set() again after the coordinates are modified; the
+  // isSynchronized() method can be used to detect changes in the
+  // number of points, or reallocations of the interleaved array, but
+  // not changes in the values
+
+public:
+
+  static const size_t ALIGNMENT = 64;
+
+          CoordSoA();
+  explicit CoordSoA(const vector<float>& coord, const int nThreads=0);
+         ~CoordSoA();
+
+  // the storage is owned, and not shared
+          CoordSoA(const CoordSoA& src) = delete;
+  CoordSoA& operator=(const CoordSoA& src) = delete;
+
+  void    clear();
+
+  // copies coord[3*iV+k] into the x, y, and z arrays; the work is
+  // split amongst nThreads threads
+  void    set(const vector<float>& coord, const int nThreads=0);
+
+  // copies the x, y, and z arrays back into an interleaved array
+  void    get(vector<float>& coord, const int nThreads=0) const;
+
+  // returns true if the last call to set() was made with this same
+  // array, and the array has not been resized or reallocated since
+  bool    isSynchronized(const vector<float>& coord) const;
+
+  int     getNumberOfPoints() const { return _nPoints; }
+
+  // the padding values, after the last point, are equal to the
+  // coordinates of the first point, so that they do not affect the
+  // bounding box computations
+  const float* getX() const { return _x; }
+  const float* getY() const { return _y; }
+  const float* getZ() const { return _z; }
+  float*       getX()       { return _x; }
+  float*       getY()       { return _y; }
+  float*       getZ()       { return _z; }
+
+private:
+
+  void    _allocate(const int nPoints);
+
+  int          _nPoints;
+  size_t       _capacity;
+  float*       _data;
+  float*       _x;
+  float*       _y;
+  float*       _z;
+  const float* _source;
+
+};
+
+#endif /* _COORD_SOA_HPP_ */
@@ -40,96 +40,382 @@
 // DAMAGE.
 
 #include <math.h>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include "Edges.hpp"
+#include "util/DgpFile.hpp"
+#include "util/Parallel.hpp"
+#include "io/StrException.hpp"
+
+// the message is a static object, since StrException keeps a
+// reference to it
+static const string errTooManyEdges
+("Edges: number of edges exceeds the range of the index type");
+static const string errTooManyCorners
+("Edges: coordIndex size exceeds the range of the index type");
 
 // public methods
 
-Edges::Edges(const int nV):
+template<class Index>
+EdgesT<Index>::EdgesT(const Index nV, const Backend backend):
   _first(),
-  _edge() {
+  _edge(),
+  _backend(backend),
+  _hash() {
   _reset(nV);
 }
 
-int Edges::getNumberOfVertices() const {
-  return static_cast<int>(_first.size());
+template<class Index>
+EdgesBase::Backend EdgesT<Index>::getBackend() const {
+  return _backend;
+}
+
+template<class Index>
+Index EdgesT<Index>::getNumberOfVertices() const {
+  return static_cast<Index>(_first.size());
 }
 
 // the _edge array contains a triple (iV0,iV1,next) for inserted edge
-int Edges::getNumberOfEdges() const {
-  return static_cast<int>(_edge.size()/3);
+template<class Index>
+Index EdgesT<Index>::getNumberOfEdges() const {
+  return static_cast<Index>(_edge.size()/3);
 }
 
-int Edges::getEdge(int iV0, int iV1) const {
+template<class Index>
+Index EdgesT<Index>::getEdge(Index iV0, Index iV1) const {
   // edges with the same ends are not allowed
   if(iV0==iV1) return -1;
   // check that vertices are not out of range
-  int nV = getNumberOfVertices();
+  Index nV = getNumberOfVertices();
   if(iV0<0 || nV<=iV0) return -1;
   if(iV1<0 || nV<=iV1) return -1;
   // make sure that iV0<iV1
-  if(iV0>iV1) { int iV=iV0; iV0=iV1; iV1=iV; }
-  // look for iV1 in the list of iV0
-  for(int j=_first[iV0];j>=0;j=/*next*/_edge[j+2])
-    if(/* _edge[j]==iV0 && */ _edge[j+1]==iV1)
-      // edge index is location of triple (iV0,iV1,next) in _edge
-      // array, regarded as an array of triples
-      return (j/3);
+  if(iV0>iV1) { Index iV=iV0; iV0=iV1; iV1=iV; }
+  if(_backend==HASH_TABLE)
+    return _hashFind(_packEdge(iV0,iV1));
+  // look for iV1 in the list of iV0; the edge index is the location
+  // of the triple (iV0,iV1,next) in the _edge array, regarded as an
+  // array of triples
+  for(Index iE=_first[iV0];iE>=0;iE=/*next*/_edge[3*static_cast<size_t>(iE)+2])
+    if(/* _edge[3*iE]==iV0 && */ _edge[3*static_cast<size_t>(iE)+1]==iV1)
+      return iE;
   return -1;
 }
 
-int Edges::getVertex0(const int iE) const {
-  int nE = getNumberOfEdges();
+template<class Index>
+Index EdgesT<Index>::getVertex0(const Index iE) const {
+  Index nE = getNumberOfEdges();
   if(iE<0 || iE>=nE) return -1;
-  return _edge[3*iE  ];
+  return _edge[3*static_cast<size_t>(iE)  ];
 }
 
-int Edges::getVertex1(const int iE) const {
-  int nE = getNumberOfEdges();
+template<class Index>
+Index EdgesT<Index>::getVertex1(const Index iE) const {
+  Index nE = getNumberOfEdges();
   if(iE<0 || iE>=nE) return -1;
-  return _edge[3*iE+1];
+  return _edge[3*static_cast<size_t>(iE)+1];
 }
 
 // protected methods
 
-void Edges::_reset(const int nV) {
+template<class Index>
+void EdgesT<Index>::_reset(const Index nV) {
   _edge.clear();
   _first.clear();
-  for(int iV=0;iV<nV;iV++)
+  for(Index iV=0;iV<nV;iV++)
     _first.push_back(-1);
+  _hash.clear();
+  if(_backend==HASH_TABLE)
+    _hashResize(16);
 }
 
-int Edges::_insertEdge(int iV0, int iV1, bool grow) {
+template<class Index>
+Index EdgesT<Index>::_insertEdge(Index iV0, Index iV1, bool grow) {
   // edges with the same ends are not allowed
   if(iV0==iV1) return -1;
   // check that vertices are not out of range
-  int nV = getNumberOfVertices();
+  Index nV = getNumberOfVertices();
   if(grow) {
     if(iV0>=nV) nV = iV0+1;
     if(iV1>=nV) nV = iV1+1;
-    while(static_cast<int>(_first.size())<nV)
+    while(static_cast<Index>(_first.size())<nV)
       _first.push_back(-1);
   } else {
     if(iV0<0 || nV<=iV0) return -1;
     if(iV1<0 || nV<=iV1) return -1;
   }
   // make sure that iV0<iV1
-  if(iV0>iV1) { int iV=iV0; iV0=iV1; iV1=iV; }
-  // if the edges has already been inserted, return the previously
-  // assigned edge index
-  int iE = getEdge(iV0,iV1); if(iE>=0) return iE;
+  if(iV0>iV1) { Index iV=iV0; iV0=iV1; iV1=iV; }
   // get the index of the next edge to be created
-  int j = static_cast<int>(_edge.size()); iE = j/3;
+  if(_edge.size()/3>=static_cast<size_t>(numeric_limits<Index>::max()))
+    throw new StrException(errTooManyEdges);
+  Index iE = static_cast<Index>(_edge.size()/3);
+  // if the edges has already been inserted, return the previously
+  // assigned edge index; the hash table indexes the new edge in the
+  // same probe sequence used to look it up, before it is appended, so
+  // that a resize of the table only reinserts the previous edges
+  if(_backend==HASH_TABLE) {
+    Index iEfound = _hashInsert(_packEdge(iV0,iV1),iE);
+    if(iEfound!=iE) return iEfound;
+  } else {
+    Index iEfound = getEdge(iV0,iV1);
+    if(iEfound>=0) return iEfound;
+  }
   // append a new triple (iV0,iV1,*) to the _edge array 
   // and link it to the list of iV0 as the first node
   _edge.push_back(iV0);
   _edge.push_back(iV1);
   _edge.push_back(_first[iV0]);
   // _first[iV0] ->  ... (.,.,-1)
-  _first[iV0] = j;
+  _first[iV0] = iE;
   // return the index of the new edge
   return iE;
 }
 
+template<class Index>
+void EdgesT<Index>::_buildFromFaces
+(const Index nV, const vector<int>& coordIndex, const int nThreads,
+ vector<Index>* firstCornerEdge, vector<Index>* cornerEdge) {
+  if(coordIndex.size()>static_cast<size_t>(numeric_limits<Index>::max()))
+    throw new StrException(errTooManyCorners);
+  _reset(nV);
+  const Index nC = static_cast<Index>(coordIndex.size());
+  const int nT = Parallel::getNumberOfThreads(nThreads,nC,1<<14);
+
+  // 1) the half edge of each corner iC, from coordIndex[iC] to the
+  //    next corner in the face, is represented by the packed key of
+  //    the pair (iV0,iV1) with iV0<iV1; corners which do not define a
+  //    valid half edge, including the face separators, get _hashEmpty
+  vector<uint64_t> key(nC);
+  Parallel::forEachRange(nT,nC,[&](int, size_t i0, size_t i1) {
+      Index iC,iCnext,iV0,iV1;
+      for(iC=static_cast<Index>(i0);iC<static_cast<Index>(i1);iC++) {
+        key[iC] = _hashEmpty;
+        if((iV0=coordIndex[iC])<0) continue;
+        // a face is terminated by a -1 separator, or by the end of the
+        // coordIndex array if the last -1 is missing
+        iCnext = iC+1;
+        if(iCnext>=nC || coordIndex[iCnext]<0)
+          for(iCnext=iC;iCnext>0 && coordIndex[iCnext-1]>=0;iCnext--);
+        iV1 = coordIndex[iCnext];
+        if(iV0==iV1 || iV0>=nV || iV1>=nV) continue;
+        key[iC] = (iV0<iV1)?_packEdge(iV0,iV1):_packEdge(iV1,iV0);
+      }
+    });
+
+  // 2) sort the valid corners by (key,iC)
+  vector<Index> corner;
+  if(nT<=1) {
+    // LSD radix sort, with the two 32-bit halves of the keys used as
+    // digits in the range [0:nV); each pass is a stable counting sort,
+    // and the corners are initially in increasing order
+    for(Index iC=0;iC<nC;iC++)
+      if(key[iC]!=_hashEmpty) corner.push_back(iC);
+    const size_t nH = corner.size();
+    vector<Index> cornerSorted(nH);
+    vector<size_t> count(static_cast<size_t>(nV)+1);
+    for(int shift=0;shift<=32;shift+=32) {
+      count.assign(count.size(),0);
+      for(size_t k=0;k<nH;k++)
+        count[((key[corner[k]]>>shift)&0xffffffffULL)+1]++;
+      for(Index iV=0;iV<nV;iV++)
+        count[iV+1] += count[iV];
+      for(size_t k=0;k<nH;k++)
+        cornerSorted[count[(key[corner[k]]>>shift)&0xffffffffULL]++] =
+          corner[k];
+      corner.swap(cornerSorted);
+    }
+  } else {
+    // parallel counting sort by iV0 into buckets, followed by a sort
+    // of each bucket by (iV1,iC); the order within each bucket before
+    // the second step depends on thread scheduling, but not after
+    vector<Index> first(static_cast<size_t>(nV)+1,0);
+    unique_ptr<atomic<Index>[]> count(new atomic<Index>[nV+1]());
+    Parallel::forEachRange(nT,nC,[&](int, size_t i0, size_t i1) {
+        for(size_t iC=i0;iC<i1;iC++)
+          if(key[iC]!=_hashEmpty)
+            count[(key[iC]>>32)+1].fetch_add(1,memory_order_relaxed);
+      });
+    for(Index iV=0;iV<nV;iV++)
+      first[iV+1] = count[iV+1].load(memory_order_relaxed);
+    Parallel::prefixSum(first,nT);
+    for(Index iV=0;iV<nV;iV++)
+      count[iV].store(first[iV],memory_order_relaxed);
+    corner.resize(first[nV]);
+    Parallel::forEachRange(nT,nC,[&](int, size_t i0, size_t i1) {
+        for(size_t iC=i0;iC<i1;iC++)
+          if(key[iC]!=_hashEmpty)
+            corner[count[key[iC]>>32].fetch_add(1,memory_order_relaxed)] =
+              static_cast<Index>(iC);
+      });
+    count.reset();
+    Parallel::forEachRange(nT,nV,[&](int, size_t i0, size_t i1) {
+        for(size_t iV=i0;iV<i1;iV++)
+          sort(corner.begin()+first[iV],corner.begin()+first[iV+1],
+               [&key](const Index iCa, const Index iCb) {
+                 return (key[iCa]<key[iCb] ||
+                         (key[iCa]==key[iCb] && iCa<iCb));
+               });
+      });
+  }
+  const size_t nH = corner.size();
+
+  // 3) each run of corners with the same key defines an edge; the
+  //    edge indices are assigned in the order of the runs
+  const int nTH = Parallel::getNumberOfThreads(nThreads,nH,1<<14);
+  vector<Index> rangeFirstEdge(nTH+1,0);
+  Parallel::forEachRange(nTH,nH,[&](int iT, size_t k0, size_t k1) {
+      Index nRuns = 0;
+      for(size_t k=k0;k<k1;k++)
+        if(k==0 || key[corner[k]]!=key[corner[k-1]]) nRuns++;
+      rangeFirstEdge[iT+1] = nRuns;
+    });
+  Parallel::prefixSum(rangeFirstEdge,1);
+  const Index nE = rangeFirstEdge[nTH];
+  _edge.resize(3*static_cast<size_t>(nE));
+  if(firstCornerEdge!=nullptr) firstCornerEdge->assign(nE+1,0);
+  Parallel::forEachRange(nTH,nH,[&](int iT, size_t k0, size_t k1) {
+      Index iE = rangeFirstEdge[iT];
+      for(size_t k=k0;k<k1;k++) {
+        if(k>0 && key[corner[k]]==key[corner[k-1]]) continue;
+        const size_t j = 3*static_cast<size_t>(iE);
+        _edge[j  ] = static_cast<Index>(key[corner[k]]>>32);
+        _edge[j+1] = static_cast<Index>(key[corner[k]]&0xffffffffULL);
+        if(firstCornerEdge!=nullptr)
+          (*firstCornerEdge)[iE] = static_cast<Index>(k);
+        iE++;
+      }
+    });
+  if(firstCornerEdge!=nullptr) (*firstCornerEdge)[nE] = static_cast<Index>(nH);
+
+  // 4) link consecutive triples with the same iV0, so that the list of
+  //    each vertex occupies a contiguous range of the _edge array
+  const int nTE = Parallel::getNumberOfThreads(nThreads,nE,1<<14);
+  Parallel::forEachRange(nTE,nE,[&](int, size_t i0, size_t i1) {
+      for(Index iE=static_cast<Index>(i0);iE<static_cast<Index>(i1);iE++) {
+        const size_t j = 3*static_cast<size_t>(iE);
+        Index iV0 = _edge[j];
+        _edge[j+2] = (iE+1<nE && _edge[j+3]==iV0)?iE+1:-1;
+        if(iE==0 || _edge[j-3]!=iV0) _first[iV0] = iE;
+      }
+    });
+
+  if(cornerEdge!=nullptr) cornerEdge->swap(corner);
+
+  // 5) index all the edges in the hash table at once
+  if(_backend==HASH_TABLE) {
+    size_t nSlots = 16;
+    while(nSlots<2*(static_cast<size_t>(nE)+1)) nSlots *= 2;
+    _hashResize(nSlots);
+  }
+}
+
+template<class Index>
+bool EdgesT<Index>::_renumberVertices
+(const Index nVout, const vector<Index>& vMap, const int nThreads) {
+  const Index nV = getNumberOfVertices();
+  if(static_cast<Index>(vMap.size())!=nV) return false;
+  Index iV,iVout,iVlast = -1;
+  for(iV=0;iV<nV;iV++) {
+    if((iVout=vMap[iV])<0) continue;
+    if(iVout<=iVlast || iVout>=nVout) return false;
+    iVlast = iVout;
+  }
+  const Index nE = getNumberOfEdges();
+  const int nT = Parallel::getNumberOfThreads(nThreads,nE,1<<14);
+  vector<int> isValid(nT,1);
+  Parallel::forEachRange(nT,nE,[&](int iT, size_t i0, size_t i1) {
+      for(size_t iE=i0;iE<i1;iE++) {
+        const size_t j = 3*iE;
+        if(vMap[_edge[j]]<0 || vMap[_edge[j+1]]<0) {
+          isValid[iT] = 0;
+          break;
+        }
+      }
+    });
+  for(int iT=0;iT<nT;iT++)
+    if(isValid[iT]==0) return false;
+
+  // the lists are not modified, only the vertex indices and the heads
+  vector<Index> first(nVout,-1);
+  for(iV=0;iV<nV;iV++)
+    if((iVout=vMap[iV])>=0) first[iVout] = _first[iV];
+  _first.swap(first);
+  Parallel::forEachRange(nT,nE,[&](int, size_t i0, size_t i1) {
+      for(size_t iE=i0;iE<i1;iE++) {
+        const size_t j = 3*iE;
+        _edge[j  ] = vMap[_edge[j  ]];
+        _edge[j+1] = vMap[_edge[j+1]];
+      }
+    });
+  // the hash keys depend on the vertex indices
+  if(_backend==HASH_TABLE) _hashResize(_hash.size());
+  return true;
+}
+
+template<class Index>
+void EdgesT<Index>::_writeEdges(DgpFile& file) const {
+  file.addSection("edges.first",_first);
+  file.addSection("edges.edge",_edge);
+}
+
+template<class Index>
+bool EdgesT<Index>::_readEdges
+(const DgpFile& file, const Index nV, const int nThreads) {
+  vector<Index> first,edge;
+  if(file.getSection("edges.first",first)==false ||
+     file.getSection("edges.edge",edge)==false) return false;
+  if(static_cast<Index>(first.size())!=nV || edge.size()%3!=0 ||
+     edge.size()/3>static_cast<size_t>(numeric_limits<Index>::max()))
+    return false;
+  // the values are checked before they are used; each edge (iV0,iV1)
+  // must satisfy 0<=iV0<iV1<nV, and must be reached exactly once by
+  // following the list of iV0, so that a corrupted file can neither
+  // index out of range nor make a list cyclic; each list is traversed
+  // by the thread which owns its first vertex, and each edge is only
+  // marked by the thread which owns its vertex iV0
+  const Index nE = static_cast<Index>(edge.size()/3);
+  vector<char> isReached(nE,0);
+  const int nT = Parallel::getNumberOfThreads(nThreads,nV,1<<14);
+  vector<Index> rangeCount(nT,0);
+  vector<int> isValid(nT,1);
+  Parallel::forEachRange(nT,nV,[&](int iT, size_t i0, size_t i1) {
+      Index iE,iV,iV1,nReached = 0;
+      for(iV=static_cast<Index>(i0);iV<static_cast<Index>(i1);iV++) {
+        for(iE=first[iV];iE!=-1;iE=edge[3*static_cast<size_t>(iE)+2]) {
+          if(iE<-1 || iE>=nE) { isValid[iT] = 0; return; }
+          const size_t j = 3*static_cast<size_t>(iE);
+          iV1 = edge[j+1];
+          if(edge[j]!=iV || iV1<=iV || iV1>=nV ||
+             edge[j+2]<-1 || edge[j+2]>=nE || isReached[iE]!=0) {
+            isValid[iT] = 0; return;
+          }
+          isReached[iE] = 1;
+          nReached++;
+        }
+      }
+      rangeCount[iT] = nReached;
+    });
+  Index nReached = 0;
+  for(int iT=0;iT<nT;iT++) {
+    if(isValid[iT]==0) return false;
+    nReached += rangeCount[iT];
+  }
+  if(nReached!=nE) return false;
+  _first.swap(first);
+  _edge.swap(edge);
+  // the hash table is not stored; all the edges are indexed at once
+  if(_backend==HASH_TABLE) {
+    const size_t nE = _edge.size()/3;
+    size_t nSlots = 16;
+    while(nSlots<2*(nE+1)) nSlots *= 2;
+    _hashResize(nSlots);
+  }
+  return true;
+}
+
 // makes an array of arrays
 // eFirst.size() == nV+1;
 // eFirst[0] == 0
@@ -140,14 +426,20 @@ int Edges::_insertEdge(int iV0, int iV1, bool grow) {
 //    with indices 2*iE for iV0, and 2*iE+1 for iV1;
 // subarray [eStar[iV+1]:eStar[iV]) contains the edge indices (2*iE,
 //    or 2*iE+1) corresponding to the edges incident to iV;
-void Edges::makeEdgeStars(vector<int>& eFirst, vector<int>& eStar) {
+template<class Index>
+void EdgesT<Index>::makeEdgeStars
+(vector<Index>& eFirst, vector<Index>& eStar) {
   eFirst.clear();
   eStar.clear();
 
-  int nV = getNumberOfVertices();
-  int nE = getNumberOfEdges();
+  Index nV = getNumberOfVertices();
+  Index nE = getNumberOfEdges();
+  // the values stored in the eStar array are 2*iE and 2*iE+1
+  if(static_cast<size_t>(nE)>
+     static_cast<size_t>(numeric_limits<Index>::max()/2))
+    throw new StrException(errTooManyEdges);
 
-  int iV,iV0,iV1,iE;
+  Index iV,iV0,iV1,iE;
 
   // initialize
   eFirst.reserve(nV+1);
@@ -160,10 +452,10 @@ void Edges::makeEdgeStars(vector<int>& eFirst, vector<int>& eStar) {
   }
 
   // count number of edges incident to each vertex
-  vector<int> valence(nV,0);
+  vector<Index> valence(nV,0);
   for(iE=0;iE<nE;iE++) {
-    iV0 = _edge[3*iE  ];
-    iV1 = _edge[3*iE+1];
+    iV0 = _edge[3*static_cast<size_t>(iE)  ];
+    iV1 = _edge[3*static_cast<size_t>(iE)+1];
     valence[iV0]++;
     valence[iV1]++;
   }
@@ -175,11 +467,73 @@ void Edges::makeEdgeStars(vector<int>& eFirst, vector<int>& eStar) {
   }
   // fill the eStar array
   for(iE=0;iE<nE;iE++) {
-    iV0 = _edge[3*iE  ];
+    iV0 = _edge[3*static_cast<size_t>(iE)  ];
     eStar[eFirst[iV0]+valence[iV0]] = 2*iE  ;
     valence[iV0]++;
-    iV1 = _edge[3*iE+1];
+    iV1 = _edge[3*static_cast<size_t>(iE)+1];
     eStar[eFirst[iV1]+valence[iV1]] = 2*iE+1;
     valence[iV1]++;
   }
 }
+
+// private methods : HASH_TABLE backend
+
+// assumes that 0<=iV0<iV1
+template<class Index>
+uint64_t EdgesT<Index>::_packEdge(const Index iV0, const Index iV1) {
+  return (static_cast<uint64_t>(iV0)<<32)|static_cast<uint64_t>(iV1);
+}
+
+// Fibonacci hashing; the high bits of the product are the best mixed
+template<class Index>
+size_t EdgesT<Index>::_hashSlot(const uint64_t key) const {
+  const uint64_t h = key*0x9E3779B97F4A7C15ULL;
+  return static_cast<size_t>(h>>32)&(_hash.size()-1);
+}
+
+template<class Index>
+Index EdgesT<Index>::_hashFind(const uint64_t key) const {
+  const size_t mask = _hash.size()-1;
+  // linear probing until the key or an empty slot is found
+  for(size_t h=_hashSlot(key);_hash[h].key!=_hashEmpty;h=(h+1)&mask)
+    if(_hash[h].key==key) return _hash[h].iE;
+  return -1;
+}
+
+// if the key is found in the table, returns the edge index stored
+// with it; otherwise stores the key with the edge index iE, which
+// should be equal to the current number of edges, and returns iE
+template<class Index>
+Index EdgesT<Index>::_hashInsert(const uint64_t key, const Index iE) {
+  // keep the load factor below 1/2
+  if(2*(static_cast<size_t>(iE)+1)>_hash.size())
+    _hashResize(2*_hash.size());
+  const size_t mask = _hash.size()-1;
+  size_t h = _hashSlot(key);
+  for(;_hash[h].key!=_hashEmpty;h=(h+1)&mask)
+    if(_hash[h].key==key) return _hash[h].iE;
+  _hash[h].key = key;
+  _hash[h].iE  = iE;
+  return iE;
+}
+
+// nSlots must be a power of 2; all the edges stored in the _edge
+// array are reinserted
+template<class Index>
+void EdgesT<Index>::_hashResize(const size_t nSlots) {
+  const HashSlot empty = { _hashEmpty, -1 };
+  _hash.assign(nSlots,empty);
+  const size_t mask = nSlots-1;
+  Index nE = getNumberOfEdges();
+  for(Index iE=0;iE<nE;iE++) {
+    const size_t j = 3*static_cast<size_t>(iE);
+    uint64_t key = _packEdge(_edge[j],_edge[j+1]);
+    size_t h = _hashSlot(key);
+    while(_hash[h].key!=_hashEmpty) h = (h+1)&mask;
+    _hash[h].key = key;
+    _hash[h].iE  = iE;
+  }
+}
+
+template class EdgesT<int>;
+template class EdgesT<int64_t>;
@@ -43,10 +43,35 @@
 #define _EDGES_HPP_
 
 #include <vector>
+#include <cstdint>
 
 using namespace std;
 
-class Edges {
+class DgpFile;
+
+// the parts of the Edges class which do not depend on the index type
+class EdgesBase {
+
+public:
+
+  // internal data structure used to look up edges by their end
+  // vertices
+  // - LINKED_LIST : array of single-linked lists, one per vertex;
+  //   compact, but lookups are linear in the vertex valence
+  // - HASH_TABLE  : the linked lists are complemented with an
+  //   open-addressing hash table keyed on the packed 64-bit (iV0,iV1)
+  //   pairs; lookups take constant expected time, which pays off on
+  //   meshes with high valence vertices, such as triangle fans; on
+  //   low valence meshes with good vertex locality the linked lists
+  //   are usually faster, since the table is accessed at random
+  // the edge indices assigned by _insertEdge() do not depend on the
+  // backend
+  enum Backend { LINKED_LIST, HASH_TABLE };
+
+};
+
+template<class Index>
+class EdgesT : public EdgesBase {
 
   // - the public interface to the Edges class only allows read-only
   //   access
@@ -54,32 +79,41 @@ class Edges {
   //   created
   // - the Graph class is identical to the Edges class with the
   //   insertEdge method made public
+  // - the Index type of the vertices and of the edges is int or
+  //   int64_t; the two instantiations, Edges and Edges64, are
+  //   compiled in Edges.cpp; with int64_t indices the number of edges
+  //   is not limited to 2^31-1, but the vertex indices are still the
+  //   int values of a coordIndex array, and the edge lookup tables
+  //   take twice as much memory
   
 public:
 
   // create a graph with nV vertices and no edges;
   // the range of valid vertex indices is 0<=iV<nV
-          Edges(const int nV=0);
+          EdgesT(const Index nV=0, const Backend backend=LINKED_LIST);
+
+  // returns the backend selected in the constructor
+  Backend getBackend()                              const;
 
   // returns the number of vertices
-  int     getNumberOfVertices()                     const;
+  Index   getNumberOfVertices()                     const;
 
   // returns the number of edges nE at the time of the call;
   // at any particular time, the range of valid vertex indices is
   // 0<=iE<getNumberOfEdges()
-  int     getNumberOfEdges()                        const;
+  Index   getNumberOfEdges()                        const;
 
   // returns -1 if iV0==iV1 or one of the vertex indices is out of
   // range; also returns -1 if the edge (iV0,iV1) has not been
   // inserted into the Edges yet; otherwise it returns the edge index iE
   // assigned to the edge when inserted
-  int     getEdge(const int iV0, const int iV1)     const;
+  Index   getEdge(const Index iV0, const Index iV1) const;
 
   // an edge is stored internally as a pair of vertex indices
   // (iV0,iV1) so that iV0<iV1; getVertex0(iE) returns iV0, and
   // getVertex1(iE) returns iV1.
-  int     getVertex0(const int iE)                  const;
-  int     getVertex1(const int iE)                  const;
+  Index   getVertex0(const Index iE)                const;
+  Index   getVertex1(const Index iE)                const;
 
   // Edges Traversal sample code
   //
@@ -101,12 +135,13 @@ public:
   //    with indices 2*iE for iV0, and 2*iE+1 for iV1;
   // subarray [eStar[iV+1]:eStar[iV]) contains the edge indices (2*iE,
   //    or 2*iE+1) corresponding to the edges incident to iV;
-  void makeEdgeStars(vector<int>& eFirst, vector<int>& eStar);
+  // throws a StrException if 2*nE+1 does not fit in an Index
+  void makeEdgeStars(vector<Index>& eFirst, vector<Index>& eStar);
 
 protected:
 
   // remove all the edges, and change the number of vertices
-  void    _reset(const int nV);
+  void    _reset(const Index nV);
 
   // - if iV0==iV1 or one of the two vertex indices is out of range,
   //   _insertEdge() returns -1 ;
@@ -114,22 +149,100 @@ protected:
   //   _insertEdge() returns iE;
   // - otherwise a new edge index iE is assigned to the edge, and
   //   _isertEdge() returns the new index iE
-  int     _insertEdge(int iV0, int iV1, bool grow=false);
+  // - throws a StrException if the number of edges would exceed the
+  //   range of the Index type
+  Index   _insertEdge(Index iV0, Index iV1, bool grow=false);
+
+  // - removes all the edges, changes the number of vertices to nV,
+  //   and inserts all the edges of the faces defined by the
+  //   coordIndex array, where faces are separated by -1's
+  // - the corner pairs (iV0,iV1) of all the faces are collected as
+  //   packed 64-bit keys and radix sorted, so that the edge table is
+  //   built in one pass, without growing the _edge array one edge at
+  //   a time
+  // - with nThreads>1 the keys are computed, sorted and emitted by
+  //   that many threads; if nThreads<=0 the default number of threads
+  //   returned by Parallel::getDefaultNumberOfThreads() is used; the
+  //   result does not depend on the number of threads
+  // - the edge indices are assigned in lexicographic order of the
+  //   pairs (iV0,iV1) with iV0<iV1, and do not depend on the order of
+  //   the faces in the coordIndex array
+  // - as in _insertEdge(), corners with out of range vertex indices,
+  //   and pairs with iV0==iV1, are ignored
+  // - the list of each vertex iV0 ends up occupying a contiguous
+  //   range of the _edge array, sorted by iV1; the lists can still be
+  //   extended later by calling _insertEdge()
+  // - if the two optional arrays are provided, they are filled with
+  //   the half-edge to edge incidence relation, as an array of arrays
+  //   of size nE; the corners whose half edges are incident to edge
+  //   iE are cornerEdge[k] for firstCornerEdge[iE]<=k<firstCornerEdge[iE+1],
+  //   in increasing order
+  // - throws a StrException if coordIndex.size() exceeds the range of
+  //   the Index type
+  void    _buildFromFaces(const Index nV, const vector<int>& coordIndex,
+                          const int nThreads=0,
+                          vector<Index>* firstCornerEdge=nullptr,
+                          vector<Index>* cornerEdge=nullptr);
+
+  // changes the number of vertices to nVout, and replaces each
+  // vertex index iV in the edge table by vMap[iV]; vMap must be of
+  // size getNumberOfVertices(), with vMap[iV]==-1 only for vertices
+  // without edges, and strictly increasing on the other vertices, so
+  // that the lexicographic order of the edges, and hence the edge
+  // indices, are preserved; returns false, leaving the edges
+  // unchanged, if vMap does not satisfy these conditions
+  bool    _renumberVertices(const Index nVout, const vector<Index>& vMap,
+                            const int nThreads=0);
+
+  // the edge tables can be written to, and read back from, a
+  // DgpFile; used by the topology cache of the PolygonMesh class;
+  // the arrays are recorded by reference, and must not be modified
+  // until the file is saved; _readEdges() returns false, leaving the
+  // edges unchanged, if the sections are missing, inconsistent with
+  // nV, or contain out of range indices or malformed edge lists
+  void    _writeEdges(DgpFile& file) const;
+  bool    _readEdges(const DgpFile& file, const Index nV,
+                     const int nThreads=0);
 
 private:
 
   // representation: array of single-linked lists
 
-  // _first[iV0] is the index into _edge array corresponding to first
-  // edge (iV0,iV1) so that iV0<iV1; _first[iV0]==-1 if the list is
-  // empty
-  vector<int> _first;
-  // stores triples (iV0,iV1,next), where the next value is an index
-  // into _edge array corresponding to next edge (iV0,iV1) so that
-  // iV0<iV1; next==-1 indicates the end of the list; the order of the
-  // triples in each list is not specified
-  vector<int> _edge;
+  // _first[iV0] is the index of the first edge (iV0,iV1) so that
+  // iV0<iV1; _first[iV0]==-1 if the list is empty
+  vector<Index> _first;
+  // stores triples (iV0,iV1,next), where the next value is the index
+  // of the next edge (iV0,iV1) so that iV0<iV1; next==-1 indicates
+  // the end of the list; the order of the triples in each list is not
+  // specified, except after _buildFromFaces() is called; the triple
+  // of edge iE starts at position 3*iE, which is computed as a size_t
+  // since it may not fit in an Index
+  vector<Index> _edge;
+
+  Backend          _backend;
+
+  // HASH_TABLE backend: the key of a slot is either the packed pair
+  // (iV0<<32)|iV1 of an edge with iV0<iV1, or _hashEmpty; keys and
+  // edge indices share the slot so that a probe touches a single
+  // cache line; the number of slots is a power of 2, and the load
+  // factor is kept below 1/2
+  struct HashSlot { uint64_t key; Index iE; };
+  vector<HashSlot> _hash;
+
+  static constexpr uint64_t _hashEmpty = ~static_cast<uint64_t>(0);
+
+  static uint64_t _packEdge(const Index iV0, const Index iV1);
+  size_t          _hashSlot(const uint64_t key)    const;
+  Index           _hashFind(const uint64_t key)    const;
+  Index           _hashInsert(const uint64_t key, const Index iE);
+  void            _hashResize(const size_t nSlots);
 
 };
 
+typedef EdgesT<int>     Edges;
+typedef EdgesT<int64_t> Edges64;
+
+extern template class EdgesT<int>;
+extern template class EdgesT<int64_t>;
+
 #endif /* _EDGES_HPP_ */
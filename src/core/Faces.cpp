@@ -37,46 +37,58 @@
 #include <math.h>
 #include "Faces.hpp"
   
-Faces::Faces(const int nV, const vector<int>& coordIndex) {
+template<class Index>
+FacesT<Index>::FacesT(const Index nV, const vector<int>& coordIndex) {
   // TODO
 }
 
-int Faces::getNumberOfVertices() const {
+template<class Index>
+Index FacesT<Index>::getNumberOfVertices() const {
   // TODO
   return 0;
 }
 
-int Faces::getNumberOfFaces() const {
+template<class Index>
+Index FacesT<Index>::getNumberOfFaces() const {
   // TODO
   return 0;
 }
 
-int Faces::getNumberOfCorners() const {
+template<class Index>
+Index FacesT<Index>::getNumberOfCorners() const {
   // TODO
   return 0;
 }
 
-int Faces::getFaceSize(const int iF) const {
+template<class Index>
+Index FacesT<Index>::getFaceSize(const Index iF) const {
   // TODO
   return 0;
 }
 
-int Faces::getFaceFirstCorner(const int iF) const {
+template<class Index>
+Index FacesT<Index>::getFaceFirstCorner(const Index iF) const {
   // TODO
   return -1;
 }
 
-int Faces::getFaceVertex(const int iF, const int j) const {
+template<class Index>
+Index FacesT<Index>::getFaceVertex(const Index iF, const Index j) const {
   // TODO
   return -1;
 }
 
-int Faces::getCornerFace(const int iC) const {
+template<class Index>
+Index FacesT<Index>::getCornerFace(const Index iC) const {
   // TODO
   return -1;
 }
 
-int Faces::getNextCorner(const int iC) const {
+template<class Index>
+Index FacesT<Index>::getNextCorner(const Index iC) const {
   // TODO
   return -1;
 }
+
+template class FacesT<int>;
+template class FacesT<int64_t>;
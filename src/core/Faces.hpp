@@ -37,62 +37,74 @@
 #ifndef _FACES_HPP_
 #define _FACES_HPP_
 
+#include <cstdint>
 #include <vector>
 
 using namespace std;
 
-class Faces {
+// the Index type of the faces and corners is int or int64_t, as for
+// the HalfEdgesT class; the two instantiations are compiled in
+// Faces.cpp
+
+template<class Index>
+class FacesT {
   
 public:
   
-          Faces(const int nV, const vector<int>& coordIndex);
+          FacesT(const Index nV, const vector<int>& coordIndex);
 
   // The constructor should compare the nV value passed as a parameter
   // with the non-negative values in stored in the coordIndex index
   // array, and update the value of nV stored internally if
   // necessary. This value returns the updated value;
-  int     getNumberOfVertices()                    const;
+  Index   getNumberOfVertices()                    const;
 
   // The faces are conted in the constructor by counting the number of
   // -1's in the coordIndex array. If coordIndex is not empty, the
   // last value of coordIndex should be -1.
-  int     getNumberOfFaces()                       const;
+  Index   getNumberOfFaces()                       const;
 
   // The number of corners is defined as the size of the coordIndex
   // array.  Including the -1 face separators as corners simplify many
   // of the algorithms.
-  int     getNumberOfCorners()                     const;
+  Index   getNumberOfCorners()                     const;
 
   // If iF is a valid face index, this method returns the number of
   // corners of the face iF. Otherwise it returns 0.
-  int     getFaceSize(const int iF)                const;
+  Index   getFaceSize(const Index iF)              const;
 
   // If iF is a valid face index, this method returns the index of the
   // coordIndex entry corresponding to the first corner of the face
   // iF. Otherwise it returns -1.
-  int     getFaceFirstCorner(const int iF)         const;
+  Index   getFaceFirstCorner(const Index iF)       const;
 
   // If iF is a valid face index, and j is a valid corner index for
   // face iF, this method returns the value stored in the
   // corresponding coordIndex entry.
-  int     getFaceVertex(const int iF, const int j) const;
+  Index   getFaceVertex(const Index iF, const Index j) const;
 
   // If iC is a valid corner index, and it does not correspond to a -1
   // separator, this method returns the index of the face which
   // contains the given corner. Otherwise it returns -1.
-  int     getCornerFace(const int iC)              const;
+  Index   getCornerFace(const Index iC)            const;
 
   // If iC is a valid corner index, and it does not correspond to a -1
   // separator, this method returns the next corner index within the
   // cyclical order of the face which contains the given
   // corner. Otherwise it returns -1.
-  int     getNextCorner(const int iC)              const;
+  Index   getNextCorner(const Index iC)            const;
 
 private:
 
-  int          _nV;
-  vector<int>  _coordIndex;
-  vector<int>  _faceFirstCorner;
+  Index         _nV;
+  vector<int>   _coordIndex;
+  vector<Index> _faceFirstCorner;
 };
 
+typedef FacesT<int>     Faces;
+typedef FacesT<int64_t> Faces64;
+
+extern template class FacesT<int>;
+extern template class FacesT<int64_t>;
+
 #endif /* _FACES_HPP_ */
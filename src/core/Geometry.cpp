@@ -37,7 +37,17 @@
 // #include <iostream>
 // #include <iomanip>
 #include <math.h>
+#include <atomic>
 #include "Geometry.hpp"
+#include "CoordSoA.hpp"
+#include "util/Parallel.hpp"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define DGP_SSE2
+#endif
 
 // private static
 void Geometry::_computeFaceNormal
@@ -445,3 +455,366 @@ void Geometry::invertOrientation(vector<int>& propertyIndex) {
     i0 = i1+1; // iF++;
   }
 }
+
+//////////////////////////////////////////////////////////////////////
+// structure-of-arrays kernels
+
+// minimum and maximum of x[i0<=i<i1], with i0<i1
+static void minMaxRange
+(const float* x, const size_t i0, const size_t i1, float& xMin, float& xMax) {
+  size_t i = i0;
+  xMin = xMax = x[i0];
+#if defined(__AVX2__)
+  if(i1-i0>=8) {
+    __m256 vMin = _mm256_loadu_ps(x+i);
+    __m256 vMax = vMin;
+    for(i+=8;i+8<=i1;i+=8) {
+      const __m256 v = _mm256_loadu_ps(x+i);
+      vMin = _mm256_min_ps(vMin,v);
+      vMax = _mm256_max_ps(vMax,v);
+    }
+    float tMin[8],tMax[8];
+    _mm256_storeu_ps(tMin,vMin);
+    _mm256_storeu_ps(tMax,vMax);
+    for(int k=0;k<8;k++) {
+      if(tMin[k]<xMin) xMin = tMin[k];
+      if(tMax[k]>xMax) xMax = tMax[k];
+    }
+  }
+#elif defined(DGP_SSE2)
+  if(i1-i0>=4) {
+    __m128 vMin = _mm_loadu_ps(x+i);
+    __m128 vMax = vMin;
+    for(i+=4;i+4<=i1;i+=4) {
+      const __m128 v = _mm_loadu_ps(x+i);
+      vMin = _mm_min_ps(vMin,v);
+      vMax = _mm_max_ps(vMax,v);
+    }
+    float tMin[4],tMax[4];
+    _mm_storeu_ps(tMin,vMin);
+    _mm_storeu_ps(tMax,vMax);
+    for(int k=0;k<4;k++) {
+      if(tMin[k]<xMin) xMin = tMin[k];
+      if(tMax[k]>xMax) xMax = tMax[k];
+    }
+  }
+#endif
+  for(;i<i1;i++) {
+    if(x[i]<xMin) xMin = x[i]; else if(x[i]>xMax) xMax = x[i];
+  }
+}
+
+// normalizes the vectors (x[i],y[i],z[i]) for i0<=i<i1; as in the
+// interleaved version, zero vectors are left unchanged
+static void normalizeRange
+(float* x, float* y, float* z, const size_t i0, const size_t i1) {
+  size_t i = i0;
+#if defined(__AVX2__)
+  const __m256 zero = _mm256_setzero_ps();
+  for(;i+8<=i1;i+=8) {
+    const __m256 vx = _mm256_loadu_ps(x+i);
+    const __m256 vy = _mm256_loadu_ps(y+i);
+    const __m256 vz = _mm256_loadu_ps(z+i);
+    const __m256 ww =
+      _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx,vx),_mm256_mul_ps(vy,vy)),
+                    _mm256_mul_ps(vz,vz));
+    const __m256 w    = _mm256_sqrt_ps(ww);
+    const __m256 mask = _mm256_cmp_ps(ww,zero,_CMP_GT_OQ);
+    _mm256_storeu_ps(x+i,_mm256_blendv_ps(vx,_mm256_div_ps(vx,w),mask));
+    _mm256_storeu_ps(y+i,_mm256_blendv_ps(vy,_mm256_div_ps(vy,w),mask));
+    _mm256_storeu_ps(z+i,_mm256_blendv_ps(vz,_mm256_div_ps(vz,w),mask));
+  }
+#elif defined(DGP_SSE2)
+  const __m128 zero = _mm_setzero_ps();
+  for(;i+4<=i1;i+=4) {
+    const __m128 vx = _mm_loadu_ps(x+i);
+    const __m128 vy = _mm_loadu_ps(y+i);
+    const __m128 vz = _mm_loadu_ps(z+i);
+    const __m128 ww =
+      _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx,vx),_mm_mul_ps(vy,vy)),
+                 _mm_mul_ps(vz,vz));
+    const __m128 w    = _mm_sqrt_ps(ww);
+    const __m128 mask = _mm_cmpgt_ps(ww,zero);
+    // blend without SSE4.1
+    _mm_storeu_ps(x+i,_mm_or_ps(_mm_and_ps(mask,_mm_div_ps(vx,w)),
+                                _mm_andnot_ps(mask,vx)));
+    _mm_storeu_ps(y+i,_mm_or_ps(_mm_and_ps(mask,_mm_div_ps(vy,w)),
+                                _mm_andnot_ps(mask,vy)));
+    _mm_storeu_ps(z+i,_mm_or_ps(_mm_and_ps(mask,_mm_div_ps(vz,w)),
+                                _mm_andnot_ps(mask,vz)));
+  }
+#endif
+  for(;i<i1;i++) {
+    float ww = x[i]*x[i]+y[i]*y[i]+z[i]*z[i];
+    if(ww>0.0f) {
+      ww = sqrt(ww);
+      x[i]/=ww; y[i]/=ww; z[i]/=ww;
+    }
+  }
+}
+
+// returns true if coordIndex is made of triangles only, i.e. if it
+// is a sequence of quadruples (iV0,iV1,iV2,-1) with iV0,iV1,iV2>=0
+static bool isTriangleMesh(const vector<int>& coordIndex, const int nThreads) {
+  const size_t nC = coordIndex.size();
+  if(nC==0 || nC%4!=0) return false;
+  const size_t nF = nC/4;
+  const int* ci = coordIndex.data();
+  atomic<bool> isTri(true);
+  const int nT = Parallel::getNumberOfThreads(nThreads,nF,1<<16);
+  Parallel::forEachRange(nT,nF,[&](int, size_t f0, size_t f1) {
+      for(size_t iF=f0;iF<f1 && isTri.load(memory_order_relaxed);iF++) {
+        const int* c = ci+4*iF;
+        if(c[0]<0 || c[1]<0 || c[2]<0 || c[3]>=0)
+          isTri.store(false,memory_order_relaxed);
+      }
+    });
+  return isTri.load();
+}
+
+// area weighted normals (nx[iF],ny[iF],nz[iF]) of the triangles
+// iF0<=iF<iF1 of a triangle mesh
+static void triangleNormalsRange
+(const CoordSoA& coord, const int* ci,
+ float* nx, float* ny, float* nz, const size_t iF0, const size_t iF1) {
+  const float* x = coord.getX();
+  const float* y = coord.getY();
+  const float* z = coord.getZ();
+  size_t iF = iF0;
+#if defined(__AVX2__)
+  // the corners of 8 consecutive triangles are gathered with a stride
+  // of 4 ints
+  const __m256i stride = _mm256_setr_epi32(0,4,8,12,16,20,24,28);
+  for(;iF+8<=iF1;iF+=8) {
+    const int* c = ci+4*iF;
+    const __m256i v0 = _mm256_i32gather_epi32(c  ,stride,4);
+    const __m256i v1 = _mm256_i32gather_epi32(c+1,stride,4);
+    const __m256i v2 = _mm256_i32gather_epi32(c+2,stride,4);
+    const __m256 x0 = _mm256_i32gather_ps(x,v0,4);
+    const __m256 y0 = _mm256_i32gather_ps(y,v0,4);
+    const __m256 z0 = _mm256_i32gather_ps(z,v0,4);
+    const __m256 u0 = _mm256_sub_ps(_mm256_i32gather_ps(x,v1,4),x0);
+    const __m256 u1 = _mm256_sub_ps(_mm256_i32gather_ps(y,v1,4),y0);
+    const __m256 u2 = _mm256_sub_ps(_mm256_i32gather_ps(z,v1,4),z0);
+    const __m256 w0 = _mm256_sub_ps(_mm256_i32gather_ps(x,v2,4),x0);
+    const __m256 w1 = _mm256_sub_ps(_mm256_i32gather_ps(y,v2,4),y0);
+    const __m256 w2 = _mm256_sub_ps(_mm256_i32gather_ps(z,v2,4),z0);
+    // n = u x w
+    _mm256_storeu_ps(nx+iF,_mm256_sub_ps(_mm256_mul_ps(u1,w2),_mm256_mul_ps(w1,u2)));
+    _mm256_storeu_ps(ny+iF,_mm256_sub_ps(_mm256_mul_ps(u2,w0),_mm256_mul_ps(w2,u0)));
+    _mm256_storeu_ps(nz+iF,_mm256_sub_ps(_mm256_mul_ps(u0,w1),_mm256_mul_ps(w0,u1)));
+  }
+#endif
+  for(;iF<iF1;iF++) {
+    const int* c = ci+4*iF;
+    const int iV0 = c[0], iV1 = c[1], iV2 = c[2];
+    const float u0 = x[iV1]-x[iV0], u1 = y[iV1]-y[iV0], u2 = z[iV1]-z[iV0];
+    const float w0 = x[iV2]-x[iV0], w1 = y[iV2]-y[iV0], w2 = z[iV2]-z[iV0];
+    nx[iF] = u1*w2-w1*u2;
+    ny[iF] = u2*w0-w2*u0;
+    nz[iF] = u0*w1-w0*u1;
+  }
+}
+
+// area weighted normal of the polygon coordIndex[i0<=i<i1], computed
+// as in Geometry::_computeFaceNormal()
+static void polygonNormal
+(const CoordSoA& coord, const int* ci, const int i0, const int i1,
+ float& w0, float& w1, float& w2) {
+  const float* x = coord.getX();
+  const float* y = coord.getY();
+  const float* z = coord.getZ();
+  w0 = w1 = w2 = 0.0f;
+  const int niF = i1-i0;
+  if(niF==3) {
+    const int iV0 = ci[i0], iV1 = ci[i0+1], iV2 = ci[i0+2];
+    const float u0 = x[iV1]-x[iV0], u1 = y[iV1]-y[iV0], u2 = z[iV1]-z[iV0];
+    const float v0 = x[iV2]-x[iV0], v1 = y[iV2]-y[iV0], v2 = z[iV2]-z[iV0];
+    w0 = u1*v2-v1*u2;
+    w1 = u2*v0-v2*u0;
+    w2 = u0*v1-v0*u1;
+  } else if(niF>3) {
+    float x0=0.0f,x1=0.0f,x2=0.0f;
+    for(int i=i0;i<i1;i++) {
+      x0 += x[ci[i]]; x1 += y[ci[i]]; x2 += z[ci[i]];
+    }
+    x0 /= ((float)niF); x1 /= ((float)niF); x2 /= ((float)niF);
+    for(int i=i0;i<i1;i++) {
+      const int iV1 = ci[i];
+      const int iV2 = ci[(i+1==i1)?i0:i+1];
+      const float u0 = x[iV1]-x0, u1 = y[iV1]-x1, u2 = z[iV1]-x2;
+      const float v0 = x[iV2]-x0, v1 = y[iV2]-x1, v2 = z[iV2]-x2;
+      w0 += u1*v2-v1*u2;
+      w1 += u2*v0-v2*u0;
+      w2 += u0*v1-v0*u1;
+    }
+  }
+}
+
+// area weighted normals of all the faces, in structure-of-arrays
+// layout; faceFirstCorner is filled only if the mesh has faces which
+// are not triangles, and otherwise left empty
+static void faceNormals
+(const CoordSoA& coord, const vector<int>& coordIndex,
+ vector<float>& nx, vector<float>& ny, vector<float>& nz,
+ vector<int>& faceFirstCorner, const int nThreads) {
+  faceFirstCorner.clear();
+  const int* ci = coordIndex.data();
+  size_t nF;
+  if(isTriangleMesh(coordIndex,nThreads)) {
+    nF = coordIndex.size()/4;
+  } else {
+    const int nC = static_cast<int>(coordIndex.size());
+    faceFirstCorner.push_back(0);
+    for(int iC=0;iC<nC;iC++)
+      if(ci[iC]<0) faceFirstCorner.push_back(iC+1);
+    nF = faceFirstCorner.size()-1;
+  }
+  nx.resize(nF); ny.resize(nF); nz.resize(nF);
+  const int nT = Parallel::getNumberOfThreads(nThreads,nF,1<<14);
+  Parallel::forEachRange(nT,nF,[&](int, size_t f0, size_t f1) {
+      if(faceFirstCorner.size()==0) {
+        triangleNormalsRange(coord,ci,nx.data(),ny.data(),nz.data(),f0,f1);
+      } else {
+        for(size_t iF=f0;iF<f1;iF++)
+          polygonNormal(coord,ci,faceFirstCorner[iF],faceFirstCorner[iF+1]-1,
+                        nx[iF],ny[iF],nz[iF]);
+      }
+    });
+}
+
+// normalizes the vectors, and stores them in interleaved layout
+static void normalizeAndInterleave
+(vector<float>& nx, vector<float>& ny, vector<float>& nz,
+ vector<float>& normal, const int nThreads) {
+  const size_t n = nx.size();
+  normal.resize(3*n);
+  const int nT = Parallel::getNumberOfThreads(nThreads,n,1<<16);
+  Parallel::forEachRange(nT,n,[&](int, size_t i0, size_t i1) {
+      normalizeRange(nx.data(),ny.data(),nz.data(),i0,i1);
+      for(size_t i=i0;i<i1;i++) {
+        normal[3*i  ] = nx[i];
+        normal[3*i+1] = ny[i];
+        normal[3*i+2] = nz[i];
+      }
+    });
+}
+
+// public static
+void Geometry::computeBoundingBox
+(const CoordSoA& coord, vector<float>& bbox, const int nThreads) {
+  bbox.clear();
+  const size_t nP = static_cast<size_t>(coord.getNumberOfPoints());
+  if(nP==0) return;
+  const int nT = Parallel::getNumberOfThreads(nThreads,nP,1<<16);
+  vector<float> rangeBox(6*nT);
+  Parallel::forEachRange(nT,nP,[&](int iT, size_t i0, size_t i1) {
+      float* b = rangeBox.data()+6*iT;
+      minMaxRange(coord.getX(),i0,i1,b[0],b[3]);
+      minMaxRange(coord.getY(),i0,i1,b[1],b[4]);
+      minMaxRange(coord.getZ(),i0,i1,b[2],b[5]);
+    });
+  bbox.insert(bbox.end(),rangeBox.begin(),rangeBox.begin()+6);
+  for(int iT=1;iT<nT;iT++)
+    for(int k=0;k<3;k++) {
+      if(rangeBox[6*iT+k  ]<bbox[k  ]) bbox[k  ] = rangeBox[6*iT+k  ];
+      if(rangeBox[6*iT+k+3]>bbox[k+3]) bbox[k+3] = rangeBox[6*iT+k+3];
+    }
+}
+
+// public static
+float Geometry::computeDiameter(const CoordSoA& coord, const int nThreads) {
+  float coordDiameter = 0.0f;
+  if(coord.getNumberOfPoints()>1) {
+    vector<float> bbox;
+    computeBoundingBox(coord,bbox,nThreads);
+    float d0,d1,d2,diamSq = 0.0f;
+    d0 = bbox[3]-bbox[0]; diamSq += d0*d0;
+    d1 = bbox[4]-bbox[1]; diamSq += d1*d1;
+    d2 = bbox[5]-bbox[2]; diamSq += d2*d2;
+    coordDiameter = std::sqrt(diamSq);
+  }
+  return coordDiameter;
+}
+
+// public static
+void Geometry::computeNormalsPerFace
+(const CoordSoA& coord, const vector<int>& coordIndex,
+ vector<float>& normal, const int nThreads) {
+  vector<float> nx,ny,nz;
+  vector<int>   faceFirstCorner;
+  faceNormals(coord,coordIndex,nx,ny,nz,faceFirstCorner,nThreads);
+  normalizeAndInterleave(nx,ny,nz,normal,nThreads);
+}
+
+// public static
+void Geometry::computeNormalsPerVertex
+(const CoordSoA& coord, const vector<int>& coordIndex,
+ vector<float>& normal, const int nThreads) {
+  vector<float> fx,fy,fz;
+  vector<int>   faceFirstCorner;
+  faceNormals(coord,coordIndex,fx,fy,fz,faceFirstCorner,nThreads);
+
+  // accumulate; each face adds its normal to all its corners, which
+  // are in general owned by different threads
+  const int nV = coord.getNumberOfPoints();
+  vector<float> nx(nV,0.0f),ny(nV,0.0f),nz(nV,0.0f);
+  const int* ci = coordIndex.data();
+  const int nF = static_cast<int>(fx.size());
+  for(int iF=0;iF<nF;iF++) {
+    const int i0 = (faceFirstCorner.size()>0)?faceFirstCorner[iF  ]  :4*iF;
+    const int i1 = (faceFirstCorner.size()>0)?faceFirstCorner[iF+1]-1:4*iF+3;
+    for(int i=i0;i<i1;i++) {
+      const int iV = ci[i];
+      nx[iV] += fx[iF];
+      ny[iV] += fy[iF];
+      nz[iV] += fz[iF];
+    }
+  }
+
+  normalizeAndInterleave(nx,ny,nz,normal,nThreads);
+}
+
+// public static
+void Geometry::computeEdgeLengths
+(const CoordSoA& coord, const Edges& edges,
+ vector<float>& edgeLengths, const int nThreads) {
+  const float* x = coord.getX();
+  const float* y = coord.getY();
+  const float* z = coord.getZ();
+  const size_t nE = static_cast<size_t>(edges.getNumberOfEdges());
+  edgeLengths.resize(nE);
+  const int nT = Parallel::getNumberOfThreads(nThreads,nE,1<<16);
+  Parallel::forEachRange(nT,nE,[&](int, size_t e0, size_t e1) {
+      size_t iE = e0;
+#if defined(__AVX2__)
+      alignas(32) int iV0[8],iV1[8];
+      for(;iE+8<=e1;iE+=8) {
+        for(int k=0;k<8;k++) {
+          iV0[k] = edges.getVertex0(static_cast<int>(iE)+k);
+          iV1[k] = edges.getVertex1(static_cast<int>(iE)+k);
+        }
+        const __m256i v0 = _mm256_load_si256((const __m256i*)iV0);
+        const __m256i v1 = _mm256_load_si256((const __m256i*)iV1);
+        const __m256 dx0 =
+          _mm256_sub_ps(_mm256_i32gather_ps(x,v1,4),_mm256_i32gather_ps(x,v0,4));
+        const __m256 dx1 =
+          _mm256_sub_ps(_mm256_i32gather_ps(y,v1,4),_mm256_i32gather_ps(y,v0,4));
+        const __m256 dx2 =
+          _mm256_sub_ps(_mm256_i32gather_ps(z,v1,4),_mm256_i32gather_ps(z,v0,4));
+        const __m256 dd =
+          _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dx0,dx0),_mm256_mul_ps(dx1,dx1)),
+                        _mm256_mul_ps(dx2,dx2));
+        _mm256_storeu_ps(edgeLengths.data()+iE,_mm256_sqrt_ps(dd));
+      }
+#endif
+      for(;iE<e1;iE++) {
+        const int jV0 = edges.getVertex0(static_cast<int>(iE));
+        const int jV1 = edges.getVertex1(static_cast<int>(iE));
+        const float dx0 = x[jV1]-x[jV0];
+        const float dx1 = y[jV1]-y[jV0];
+        const float dx2 = z[jV1]-z[jV0];
+        edgeLengths[iE] = sqrt(dx0*dx0+dx1*dx1+dx2*dx2);
+      }
+    });
+}
@@ -42,6 +42,8 @@
 
 using namespace std;
 
+class CoordSoA;
+
 class Geometry {
 
 private:
@@ -93,6 +95,34 @@ public:
   static void invertOrientation
   (vector<int>& propertyIndex);
 
+  // the following methods compute the same values as the ones above,
+  // up to floating point rounding, from a structure-of-arrays copy of
+  // the coordinates; they use SIMD instructions (AVX2 if the library
+  // is built with DGP_ENABLE_AVX2, SSE2 on x86-64 otherwise, and plain
+  // C++ on other platforms), and the work is split amongst nThreads
+  // threads; the accumulation of face normals onto the vertices is
+  // done serially, in the same order as in the interleaved version
+
+  // bbox = { xMin, yMin, zMin, xMax, yMax, zMax }; empty if there are
+  // no points
+  static void computeBoundingBox
+  (const CoordSoA& coord, vector<float>& bbox, const int nThreads=0);
+
+  static float computeDiameter
+  (const CoordSoA& coord, const int nThreads=0);
+
+  static void computeNormalsPerFace
+  (const CoordSoA& coord, const vector<int>& coordIndex,
+   vector<float>& normalPerFace, const int nThreads=0);
+
+  static void computeNormalsPerVertex
+  (const CoordSoA& coord, const vector<int>& coordIndex,
+   vector<float>& normalPerVertex, const int nThreads=0);
+
+  static void computeEdgeLengths
+  (const CoordSoA& coord, const Edges& edges,
+   vector<float>& edgeLengths, const int nThreads=0);
+
 };
 
 #endif /* _GEOMETRY_HPP_ */
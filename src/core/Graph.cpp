@@ -42,7 +42,7 @@
 #include <math.h>
 #include "Graph.hpp"
 
-Graph::Graph(const int nV):Edges(nV) {
+Graph::Graph(const int nV, const Backend backend):Edges(nV,backend) {
 }
 
 void Graph::reset(const int nV) {
@@ -52,3 +52,8 @@ void Graph::reset(const int nV) {
 int Graph::insertEdge(int iV0, int iV1, bool grow) {
   return _insertEdge(iV0,iV1,grow);
 }
+
+void Graph::buildFromFaces
+(const int nV, const vector<int>& coordIndex, const int nThreads) {
+  _buildFromFaces(nV,coordIndex,nThreads);
+}
@@ -62,12 +62,17 @@ public:
   // int     getVertex0(const int iE)                  const;
   // int     getVertex1(const int iE)                  const;
 
-          Graph(const int nV=0);
+          Graph(const int nV=0, const Backend backend=LINKED_LIST);
 
   void    reset(const int nV);
 
   int     insertEdge(int iV0, int iV1, bool grow=false);
 
+  // replaces the edges by the edges of the faces defined by the
+  // coordIndex array; see Edges::_buildFromFaces()
+  void    buildFromFaces(const int nV, const vector<int>& coordIndex,
+                         const int nThreads=0);
+
 };
 
 #endif /* _GRAPH_HPP_ */
@@ -42,71 +42,477 @@
 // DAMAGE.
 
 #include <math.h>
+#include <limits>
+#include <algorithm>
 #include "HalfEdges.hpp"
-// #include "Graph.hpp"
+#include "util/DgpFile.hpp"
+#include "util/Parallel.hpp"
+#include "io/StrException.hpp"
 
-// TODO Mon Mar 6 2023
-// - merge your code from Assignment 2
+// the message is a static object, since StrException keeps a
+// reference to it
+static const string errTooManyCorners
+("HalfEdges: coordIndex size exceeds the range of the index type");
 
-HalfEdges::HalfEdges(const int nVertices, const vector<int>&  coordIndex):
-  Edges(nVertices),
+template<class Index>
+HalfEdgesT<Index>::HalfEdgesT
+(const Index nVertices, const vector<int>&  coordIndex,
+ const Backend backend, const int nThreads):
+  HalfEdgesT(nVertices,coordIndex,backend,nThreads,true) {
+}
+
+template<class Index>
+HalfEdgesT<Index>::HalfEdgesT
+(const Index nVertices, const vector<int>&  coordIndex,
+ const Backend backend, const int nThreads, const bool build):
+  EdgesT<Index>(nVertices,backend),
   _coordIndex(coordIndex),
-  _twin()
+  _twin(),
+  _face(),
+  _firstCornerEdge(),
+  _cornerEdge(),
+  _nThreads(nThreads),
+  _nFaces(0),
+  _isTriangleMesh(false),
+  _isBoundaryEdge(),
+  _isRegularEdge(),
+  _isSingularEdge(),
+  _nBoundaryEdges(0),
+  _nRegularEdges(0),
+  _nSingularEdges(0)
 {
-  // TODO
+  if(coordIndex.size()>static_cast<size_t>(numeric_limits<Index>::max()))
+    throw new StrException(errTooManyCorners);
+  if(build) _build();
+}
+
+template<class Index>
+void HalfEdgesT<Index>::_build() {
+  const Index nC = getNumberOfCorners();
+  const vector<int>& coordIndex = _coordIndex;
+
+  // 1) edges, and the half-edge to edge incidence relation
+  _buildFromFaces(getNumberOfVertices(),_coordIndex,_nThreads,
+                  &_firstCornerEdge,&_cornerEdge);
+
+  // 2) corner to face map; the faces of each range of corners are
+  //    counted first, and the face index of the first corner of each
+  //    range is determined by a prefix sum; for triangle meshes the
+  //    map is implicit, and only the pattern of separators is checked
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nC,1<<14);
+  _isTriangleMesh = false;
+  if(nC>0 && nC%4==0) {
+    vector<int> isTriangleRange(nT,1);
+    Parallel::forEachRange(nT,nC,[&](int iT, size_t i0, size_t i1) {
+        for(size_t iC=i0;iC<i1;iC++)
+          if((coordIndex[iC]<0)!=((iC&3)==3)) {
+            isTriangleRange[iT] = 0;
+            break;
+          }
+      });
+    _isTriangleMesh = true;
+    for(int iT=0;iT<nT;iT++)
+      if(isTriangleRange[iT]==0) _isTriangleMesh = false;
+  }
+  if(_isTriangleMesh) {
+    _face.clear();
+    _face.shrink_to_fit();
+    _nFaces = nC/4;
+  } else {
+    _face.resize(nC);
+    vector<Index> rangeFirstFace(nT+1,0);
+    Parallel::forEachRange(nT,nC,[&](int iT, size_t i0, size_t i1) {
+        Index nF = 0;
+        for(size_t iC=i0;iC<i1;iC++)
+          if(coordIndex[iC]<0) nF++;
+        rangeFirstFace[iT+1] = nF;
+      });
+    Parallel::prefixSum(rangeFirstFace,1);
+    Parallel::forEachRange(nT,nC,[&](int iT, size_t i0, size_t i1) {
+        Index iF = rangeFirstFace[iT];
+        for(size_t iC=i0;iC<i1;iC++)
+          if(coordIndex[iC]<0) {
+            _face[iC] = -1; iF++;
+          } else {
+            _face[iC] = iF;
+          }
+      });
+    _nFaces = rangeFirstFace[nT];
+    // the last face may be missing its -1 separator
+    if(nC>0 && coordIndex[nC-1]>=0) _nFaces++;
+  }
+
+  // 3) twins
+  const Index nE = getNumberOfEdges();
+  _twin.assign(nC,-1);
+  const int nTE = Parallel::getNumberOfThreads(_nThreads,nE,1<<14);
+  Parallel::forEachRange(nTE,nE,[&](int, size_t i0, size_t i1) {
+      for(size_t iE=i0;iE<i1;iE++) {
+        Index k = _firstCornerEdge[iE];
+        if(_firstCornerEdge[iE+1]-k==2) {
+          _twin[_cornerEdge[k  ]] = _cornerEdge[k+1];
+          _twin[_cornerEdge[k+1]] = _cornerEdge[k  ];
+        }
+      }
+    });
+
+  // 4) edge classification
+  _classifyEdges();
+}
+
+// the words of the three arrays of bits are split amongst the
+// threads, so that each word is written by a single thread
+template<class Index>
+void HalfEdgesT<Index>::_classifyEdges() {
+  const Index nE = getNumberOfEdges();
+  _isBoundaryEdge.resize(nE);
+  _isRegularEdge.resize(nE);
+  _isSingularEdge.resize(nE);
+  const size_t nW = _isBoundaryEdge.getNumberOfWords();
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nW,1<<8);
+  vector<Index> rangeCount(3*nT,0); // boundary, regular, singular
+  Parallel::forEachRange(nT,nW,[&](int iT, size_t w0, size_t w1) {
+      for(size_t iW=w0;iW<w1;iW++) {
+        uint64_t b = 0, r = 0, s = 0;
+        const size_t iE0 = iW<<6;
+        const size_t iE1 = (iE0+64<static_cast<size_t>(nE))?iE0+64:nE;
+        for(size_t iE=iE0;iE<iE1;iE++) {
+          const Index nH = _firstCornerEdge[iE+1]-_firstCornerEdge[iE];
+          const uint64_t bit = static_cast<uint64_t>(1)<<(iE-iE0);
+          if(nH==1)      b |= bit;
+          else if(nH==2) r |= bit;
+          else if(nH>2)  s |= bit;
+        }
+        _isBoundaryEdge.setWord(iW,b);
+        _isRegularEdge.setWord(iW,r);
+        _isSingularEdge.setWord(iW,s);
+        rangeCount[3*iT  ] += BitSet::popcount(b);
+        rangeCount[3*iT+1] += BitSet::popcount(r);
+        rangeCount[3*iT+2] += BitSet::popcount(s);
+      }
+    });
+  _nBoundaryEdges = _nRegularEdges = _nSingularEdges = 0;
+  for(int iT=0;iT<nT;iT++) {
+    _nBoundaryEdges += rangeCount[3*iT  ];
+    _nRegularEdges  += rangeCount[3*iT+1];
+    _nSingularEdges += rangeCount[3*iT+2];
+  }
 }
 
-int HalfEdges::getNumberOfCorners() const {
-  return static_cast<int>(_coordIndex.size());
+template<class Index>
+void HalfEdgesT<Index>::_writeHalfEdges
+(DgpFile& file, vector<Index>& info) const {
+  _writeEdges(file);
+  // the edge classification is not stored, since it is cheaper to
+  // recompute it from the half-edge to edge incidence relation
+  info.resize(2);
+  info[0] = _nFaces;
+  info[1] = (_isTriangleMesh)?1:0;
+  file.addSection("he.info",info);
+  file.addSection("he.twin",_twin);
+  file.addSection("he.face",_face);
+  file.addSection("he.firstCorner",_firstCornerEdge);
+  file.addSection("he.cornerEdge",_cornerEdge);
 }
 
-int HalfEdges::getFace(const int iC) const {
-  // TODO
-  return -1;
+// next corner of the face loop of corner iC, which should not be a
+// separator; used to validate the tables read from a file, before
+// _isTriangleMesh is set
+template<class Index>
+static Index nextCorner
+(const vector<int>& coordIndex, const bool isTriangleMesh, const Index iC) {
+  if(isTriangleMesh) return ((iC&3)==2)?iC-2:iC+1;
+  const Index nC = static_cast<Index>(coordIndex.size());
+  if(iC+1<nC && coordIndex[iC+1]>=0) return iC+1;
+  Index iCnext = iC;
+  while(iCnext>0 && coordIndex[iCnext-1]>=0) iCnext--;
+  return iCnext;
 }
 
-int HalfEdges::getSrc(const int iC) const {
-  // TODO
-  return -1;
+template<class Index>
+bool HalfEdgesT<Index>::_readHalfEdges(const DgpFile& file) {
+  const size_t nC = _coordIndex.size();
+  vector<Index> info,twin,face,firstCornerEdge,cornerEdge;
+  if(file.getSection("he.info",info)==false || info.size()!=2 ||
+     file.getSection("he.twin",twin)==false || twin.size()!=nC ||
+     file.getSection("he.face",face)==false ||
+     face.size()!=((info[1]!=0)?0:nC) ||
+     file.getSection("he.firstCorner",firstCornerEdge)==false ||
+     file.getSection("he.cornerEdge",cornerEdge)==false)
+    return false;
+  const bool  isTriangleMesh = (info[1]!=0);
+  const Index nF             = info[0];
+  if(nF<0 || (isTriangleMesh && (nC%4!=0 || static_cast<size_t>(nF)!=nC/4)))
+    return false;
+
+  // the values are checked before they are used, so that a corrupted
+  // file makes the caller rebuild the tables instead of indexing out
+  // of range: twins are in [-1,nC), faces are in [0,nF) for corners
+  // and -1 for separators, and the separators of a triangle mesh are
+  // every fourth corner; a twin is a corner, not a separator, whose
+  // twin is the original corner, and the two half edges span the same
+  // edge, in opposite directions if the two faces are consistently
+  // oriented, and in the same direction otherwise
+  const vector<int>& coordIndex = _coordIndex;
+  const Index nCi = static_cast<Index>(nC);
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nC,1<<14);
+  vector<int> isValid(nT,1);
+  Parallel::forEachRange(nT,nC,[&](int iT, size_t i0, size_t i1) {
+      for(Index iC=static_cast<Index>(i0);iC<static_cast<Index>(i1);iC++) {
+        const bool  isSeparator = (coordIndex[iC]<0);
+        const Index iCt         = twin[iC];
+        if(iCt<-1 || iCt>=nCi ||
+           (isTriangleMesh && isSeparator!=((iC&3)==3)) ||
+           (isTriangleMesh==false &&
+            (isSeparator?(face[iC]!=-1):(face[iC]<0 || face[iC]>=nF)))) {
+          isValid[iT] = 0; return;
+        }
+        if(iCt<0) continue;
+        if(isSeparator || coordIndex[iCt]<0 || twin[iCt]!=iC) {
+          isValid[iT] = 0; return;
+        }
+        const Index iV0  = coordIndex[iC];
+        const Index iV1  = coordIndex[nextCorner(coordIndex,isTriangleMesh,iC)];
+        const Index iV0t = coordIndex[iCt];
+        const Index iV1t =
+          coordIndex[nextCorner(coordIndex,isTriangleMesh,iCt)];
+        if(iV0==iV1 ||
+           !((iV0t==iV1 && iV1t==iV0) || (iV0t==iV0 && iV1t==iV1))) {
+          isValid[iT] = 0; return;
+        }
+      }
+    });
+  for(int iT=0;iT<nT;iT++)
+    if(isValid[iT]==0) return false;
+
+  if(_readEdges(file,getNumberOfVertices(),_nThreads)==false) return false;
+
+  // the half-edge to edge incidence relation is an array of arrays of
+  // corners; firstCornerEdge must be non-decreasing, starting at 0
+  // and ending at cornerEdge.size(), and the corners in [0,nC)
+  const size_t nE = static_cast<size_t>(getNumberOfEdges());
+  if(firstCornerEdge.size()!=nE+1 || firstCornerEdge[0]!=0 ||
+     static_cast<size_t>(firstCornerEdge[nE])!=cornerEdge.size() ||
+     cornerEdge.size()>nC)
+    return false;
+  for(size_t iE=0;iE<nE;iE++)
+    if(firstCornerEdge[iE+1]<firstCornerEdge[iE]) return false;
+  for(size_t k=0;k<cornerEdge.size();k++)
+    if(cornerEdge[k]<0 || static_cast<size_t>(cornerEdge[k])>=nC)
+      return false;
+
+  // each corner of an edge is not a separator, and its half edge
+  // spans the edge; the two corners of a regular edge are twins, and
+  // the corners of the other edges have no twin
+  const int nTE = Parallel::getNumberOfThreads(_nThreads,nE,1<<14);
+  isValid.assign(nTE,1);
+  Parallel::forEachRange(nTE,nE,[&](int iT, size_t e0, size_t e1) {
+      for(Index iE=static_cast<Index>(e0);iE<static_cast<Index>(e1);iE++) {
+        const Index iV0 = getVertex0(iE);
+        const Index iV1 = getVertex1(iE);
+        const Index k0  = firstCornerEdge[iE];
+        const Index k1  = firstCornerEdge[iE+1];
+        if(k1==k0) { isValid[iT] = 0; return; }
+        for(Index k=k0;k<k1;k++) {
+          const Index iC = cornerEdge[k];
+          const Index iW0 = coordIndex[iC];
+          if(iW0<0) { isValid[iT] = 0; return; }
+          const Index iW1 =
+            coordIndex[nextCorner(coordIndex,isTriangleMesh,iC)];
+          if(!((iW0==iV0 && iW1==iV1) || (iW0==iV1 && iW1==iV0)) ||
+             twin[iC]!=((k1-k0==2)?cornerEdge[k0+k1-1-k]:-1)) {
+            isValid[iT] = 0; return;
+          }
+        }
+      }
+    });
+  for(int iT=0;iT<nTE;iT++)
+    if(isValid[iT]==0) return false;
+
+  // every corner which defines a half edge between two different
+  // vertices in range belongs to exactly one edge, and the others to
+  // none
+  const Index nV = getNumberOfVertices();
+  vector<unsigned char> nCornerEdges(nC,0);
+  for(size_t k=0;k<cornerEdge.size();k++)
+    if(nCornerEdges[cornerEdge[k]]++>0) return false;
+  isValid.assign(nT,1);
+  Parallel::forEachRange(nT,nC,[&](int iT, size_t i0, size_t i1) {
+      for(Index iC=static_cast<Index>(i0);iC<static_cast<Index>(i1);iC++) {
+        const Index iV0 = coordIndex[iC];
+        const Index iV1 = (iV0<0)?-1:
+          coordIndex[nextCorner(coordIndex,isTriangleMesh,iC)];
+        const bool isHalfEdge =
+          (iV0>=0 && iV1>=0 && iV0<nV && iV1<nV && iV0!=iV1);
+        if(nCornerEdges[iC]!=((isHalfEdge)?1:0)) {
+          isValid[iT] = 0; return;
+        }
+      }
+    });
+  for(int iT=0;iT<nT;iT++)
+    if(isValid[iT]==0) return false;
+
+  _nFaces           = nF;
+  _isTriangleMesh   = isTriangleMesh;
+  _twin.swap(twin);
+  _face.swap(face);
+  _firstCornerEdge.swap(firstCornerEdge);
+  _cornerEdge.swap(cornerEdge);
+  _classifyEdges();
+  return true;
 }
 
-int HalfEdges::getDst(const int iC) const {
-  // TODO
-  return -1;
+template<class Index>
+bool HalfEdgesT<Index>::_getFaceCorners
+(const vector<bool>& flipped, vector<Index>& faceCorner) const {
+  faceCorner.clear();
+  if(static_cast<Index>(flipped.size())!=_nFaces) return false;
+  if(_isTriangleMesh) {
+    for(Index iF=0;iF<_nFaces;iF++)
+      if(flipped[iF])
+        for(Index iC=4*iF;iC<4*iF+3;iC++)
+          faceCorner.push_back(iC);
+    return true;
+  }
+  // there is no face to corner map; the corner to face map is scanned
+  const Index nC = getNumberOfCorners();
+  for(Index iC=0;iC<nC;iC++)
+    if(_face[iC]>=0 && flipped[_face[iC]])
+      faceCorner.push_back(iC);
+  return true;
 }
 
-int HalfEdges::getNext(const int iC) const {
-  // TODO
-  return -1;
+template<class Index>
+bool HalfEdgesT<Index>::_patchCornerLists
+(const vector<Index>& first, vector<Index>& list,
+ const vector< pair<Index,Index> >& newCorner, const vector<bool>& flipped,
+ const bool apply) const {
+  const size_t nNew = newCorner.size();
+  size_t k0,k1;
+  for(k0=0;k0<nNew;k0=k1) {
+    const Index iL = newCorner[k0].first;
+    for(k1=k0+1;k1<nNew && newCorner[k1].first==iL;k1++);
+    // the old corners of the list are replaced one by one
+    size_t k = k0;
+    for(Index j=first[iL];j<first[iL+1];j++) {
+      if(flipped[_cornerFace(list[j])]==false) continue;
+      if(k==k1) return false;
+      if(apply) list[j] = newCorner[k].second;
+      k++;
+    }
+    if(k!=k1) return false;
+    if(apply) sort(list.begin()+first[iL],list.begin()+first[iL+1]);
+  }
+  return true;
 }
 
-int HalfEdges::getPrev(const int iC) const {
-  // TODO
-  return -1;
+template<class Index>
+bool HalfEdgesT<Index>::_updateFlippedFaces
+(const vector<bool>& flipped, const vector<Index>& faceCorner,
+ const vector< pair<Index,Index> >& edgeCorner) {
+  // 1) the lists of corners of the edges
+  if(_patchCornerLists(_firstCornerEdge,_cornerEdge,edgeCorner,
+                       flipped,false)==false)
+    return false;
+  _patchCornerLists(_firstCornerEdge,_cornerEdge,edgeCorner,flipped,true);
+
+  // 2) the twins of the corners of the patched edges
+  for(const Index iC : faceCorner)
+    _twin[iC] = -1;
+  const size_t nEC = edgeCorner.size();
+  for(size_t k=0;k<nEC;k++) {
+    const Index iE = edgeCorner[k].first;
+    if(k>0 && edgeCorner[k-1].first==iE) continue;
+    const Index j = _firstCornerEdge[iE];
+    if(_firstCornerEdge[iE+1]-j==2) {
+      _twin[_cornerEdge[j  ]] = _cornerEdge[j+1];
+      _twin[_cornerEdge[j+1]] = _cornerEdge[j  ];
+    }
+  }
+  return true;
 }
 
-int HalfEdges::getTwin(const int iC) const {
-  // TODO
-  return -1;
+template<class Index>
+Index HalfEdgesT<Index>::getNumberOfCorners() const {
+  return static_cast<Index>(_coordIndex.size());
+}
+
+template<class Index>
+bool HalfEdgesT<Index>::isTriangleMesh() const {
+  return _isTriangleMesh;
+}
+
+template<class Index>
+Index HalfEdgesT<Index>::getFace(const Index iC) const {
+  Index nC = getNumberOfCorners();
+  if(iC<0 || iC>=nC) return -1;
+  if(_isTriangleMesh) return ((iC&3)==3)?-1:(iC>>2);
+  return _face[iC];
+}
+
+template<class Index>
+Index HalfEdgesT<Index>::getSrc(const Index iC) const {
+  Index nC = getNumberOfCorners();
+  if(iC<0 || iC>=nC) return -1;
+  return (_coordIndex[iC]<0)?-1:_coordIndex[iC];
+}
+
+template<class Index>
+Index HalfEdgesT<Index>::getDst(const Index iC) const {
+  Index iCnext = getNext(iC);
+  return (iCnext<0)?-1:_coordIndex[iCnext];
+}
+
+template<class Index>
+Index HalfEdgesT<Index>::getNext(const Index iC) const {
+  Index nC = getNumberOfCorners();
+  if(iC<0 || iC>=nC || _coordIndex[iC]<0) return -1;
+  if(_isTriangleMesh) return ((iC&3)==2)?iC-2:iC+1;
+  if(iC+1<nC && _coordIndex[iC+1]>=0) return iC+1;
+  // last corner of the face: go back to the first corner
+  Index iCnext = iC;
+  while(iCnext>0 && _coordIndex[iCnext-1]>=0) iCnext--;
+  return iCnext;
+}
+
+template<class Index>
+Index HalfEdgesT<Index>::getPrev(const Index iC) const {
+  Index nC = getNumberOfCorners();
+  if(iC<0 || iC>=nC || _coordIndex[iC]<0) return -1;
+  if(_isTriangleMesh) return ((iC&3)==0)?iC+2:iC-1;
+  if(iC>0 && _coordIndex[iC-1]>=0) return iC-1;
+  // first corner of the face: go forward to the last corner
+  Index iCprev = iC;
+  while(iCprev+1<nC && _coordIndex[iCprev+1]>=0) iCprev++;
+  return iCprev;
+}
+
+template<class Index>
+Index HalfEdgesT<Index>::getTwin(const Index iC) const {
+  Index nC = getNumberOfCorners();
+  return (iC<0 || iC>=nC)?-1:_twin[iC];
 }
 
 // represent the half edge as an array of lists, with one list
 // associated with each edge
 
-int HalfEdges::getNumberOfEdgeHalfEdges(const int iE) const {
-  // TODO
-  return 0;  
+template<class Index>
+Index HalfEdgesT<Index>::getNumberOfEdgeHalfEdges(const Index iE) const {
+  Index nE = getNumberOfEdges();
+  if(iE<0 || iE>=nE) return 0;
+  return _firstCornerEdge[iE+1]-_firstCornerEdge[iE];
 }
 
-int HalfEdges::getEdgeHalfEdge(const int iE, const int j) const {
-  // TODO
-  return -1;
+template<class Index>
+Index HalfEdgesT<Index>::getEdgeHalfEdge(const Index iE, const Index j) const {
+  Index nE = getNumberOfEdges();
+  if(iE<0 || iE>=nE) return -1;
+  if(j<0 || j>=_firstCornerEdge[iE+1]-_firstCornerEdge[iE]) return -1;
+  return _cornerEdge[_firstCornerEdge[iE]+j];
 }
-
-// TODO Mon Mar 6 2023
-// - new functions to implement
 
-bool HalfEdges::isOriented(const int iC) const {
+template<class Index>
+bool HalfEdgesT<Index>::isOriented(const Index iC) const {
   // iC     : iV00->iV01
   // iCtwin : iV10->iV11
 
@@ -125,50 +531,78 @@ bool HalfEdges::isOriented(const int iC) const {
   /*  / iV11 <-- iV10  \  */
   /* /                  \ */
   // return false;
+
+  Index iCtwin = getTwin(iC);
+  if(iCtwin<0) return false;
+  return (getSrc(iC)==getDst(iCtwin));
 }
 
 // half-edge method getFaceSize()
-int HalfEdges::getFaceSize(const int iC) const {
-  // TODO
-  return 0;
+template<class Index>
+Index HalfEdgesT<Index>::getFaceSize(const Index iC) const {
+  Index nC = getNumberOfCorners();
+  if(iC<0 || iC>=nC || _coordIndex[iC]<0) return -1;
+  if(_isTriangleMesh) return 3;
+  Index iC0,iC1;
+  for(iC0=iC;iC0>0 && _coordIndex[iC0-1]>=0;iC0--);
+  for(iC1=iC;iC1<nC && _coordIndex[iC1]>=0;iC1++);
+  return iC1-iC0;
 }
   
-int HalfEdges::getNumberOfFacesEdge(const int iE) const {
-  // TODO
-  return 0;
+template<class Index>
+Index HalfEdgesT<Index>::getNumberOfFacesEdge(const Index iE) const {
+  Index nE = getNumberOfEdges();
+  if(iE<0 || iE>=nE) return -1;
+  return getNumberOfEdgeHalfEdges(iE);
 }
 
-bool HalfEdges::isBoundaryEdge(const int iE) const {
-  // TODO
-  return false;
+template<class Index>
+bool HalfEdgesT<Index>::isBoundaryEdge(const Index iE) const {
+  return (0<=iE && iE<getNumberOfEdges() && _isBoundaryEdge.test(iE));
 }
 
-bool HalfEdges::isRegularEdge(const int iE) const {
-  // TODO
-  return false;
+template<class Index>
+bool HalfEdgesT<Index>::isRegularEdge(const Index iE) const {
+  return (0<=iE && iE<getNumberOfEdges() && _isRegularEdge.test(iE));
 }
 
-bool HalfEdges::isSingularEdge(const int iE) const {
-  // TODO
-  return false;
+template<class Index>
+bool HalfEdgesT<Index>::isSingularEdge(const Index iE) const {
+  return (0<=iE && iE<getNumberOfEdges() && _isSingularEdge.test(iE));
 }
 
-// HINTS
+// the return values of these methods are determined in the
+// constructor
 
-// - it is best to determine the return values of these methods in the
-//   constructor and save them in private variables
+template<class Index>
+bool HalfEdgesT<Index>::hasBoundaryEdges() const {
+  return (_nBoundaryEdges>0);
+}
 
-bool HalfEdges::hasBoundaryEdges() const {
-  // TODO
-  return false;
+template<class Index>
+bool HalfEdgesT<Index>::hasRegularEdges() const {
+  return (_nRegularEdges>0);
 }
 
-bool HalfEdges::hasRegularEdges() const {
-  // TODO
-  return false;
+template<class Index>
+bool HalfEdgesT<Index>::hasSingularEdges() const {
+  return (_nSingularEdges>0);
 }
 
-bool HalfEdges::hasSingularEdges() const {
-  // TODO
-  return false;
+template<class Index>
+Index HalfEdgesT<Index>::getNumberOfBoundaryEdges() const {
+  return _nBoundaryEdges;
 }
+
+template<class Index>
+Index HalfEdgesT<Index>::getNumberOfRegularEdges() const {
+  return _nRegularEdges;
+}
+
+template<class Index>
+Index HalfEdgesT<Index>::getNumberOfSingularEdges() const {
+  return _nSingularEdges;
+}
+
+template class HalfEdgesT<int>;
+template class HalfEdgesT<int64_t>;
@@ -44,30 +44,71 @@
 #ifndef _HALF_EDGES_HPP_
 #define _HALF_EDGES_HPP_
 
+#include <utility>
 #include <vector>
 #include "Edges.hpp"
+#include "util/BitSet.hpp"
 
 using namespace std;
 
-class HalfEdges : public Edges {
+template<class Index>
+class HalfEdgesT : public EdgesT<Index> {
 
 public:
 
-  // methods inherited from Edges
+  // methods inherited from Edges; the base class depends on the
+  // Index type, so its members have to be brought into scope
   //
-  // int     getNumberOfVertices()                     const;
-  // int     getNumberOfEdges()                        const;
-  // int     getEdge(const int iV0, const int iV1)     const;
-  // int     getVertex0(const int iE)                  const;
-  // int     getVertex1(const int iE)                  const;
+  // Index   getNumberOfVertices()                     const;
+  // Index   getNumberOfEdges()                        const;
+  // Index   getEdge(const Index iV0, const Index iV1) const;
+  // Index   getVertex0(const Index iE)                const;
+  // Index   getVertex1(const Index iE)                const;
+
+  typedef EdgesBase::Backend Backend;
+
+  using EdgesT<Index>::getNumberOfVertices;
+  using EdgesT<Index>::getNumberOfEdges;
+  using EdgesT<Index>::getEdge;
+  using EdgesT<Index>::getVertex0;
+  using EdgesT<Index>::getVertex1;
+
+  // constructor performs most of the work; the backend argument
+  // selects the data structure used to look up the edges; the edges,
+  // the corner to face map, the twins, and the half-edge to edge
+  // incidence relation are computed by nThreads threads, or by
+  // Parallel::getDefaultNumberOfThreads() threads if nThreads<=0; the
+  // result does not depend on the number of threads; corners, edges,
+  // and faces are numbered with Index values, and a StrException is
+  // thrown if coordIndex.size() does not fit in an Index; the int
+  // instantiation is HalfEdges, and HalfEdges64 handles meshes with
+  // 2^31 or more corners, at the cost of twice the memory for the
+  // tables
+
+          HalfEdgesT(const Index nV, const vector<int>& coordIndex,
+                     const Backend backend=EdgesBase::LINKED_LIST,
+                     const int nThreads=0);
 
-  // constructor performs most of the work
+  // returns the number of elements of the coordIndex array
 
-          HalfEdges(const int nV, const vector<int>& coordIndex);
+  Index   getNumberOfCorners() const;
 
-  // returns the number of elements of the coordIndex array
+  // returns true if all the faces are triangles, each one followed by
+  // a -1 separator, i.e., if the coordIndex array is a sequence of
+  // quadruples (iV0,iV1,iV2,-1); in that case corner iC belongs to
+  // face iC/4, the face loops are followed arithmetically, and the
+  // corner to face map is not stored
+  //
+  // this is a run time mode of this class, not a separate class; the
+  // corners keep the coordIndex numbering, separators included, and
+  // the twins and the half-edge to edge incidence relation are stored
+  // as for any other mesh; for a closed triangle mesh, with about
+  // 1.5 edges and 0.5 vertices per face, the tables of this class and
+  // of the LINKED_LIST edge tables take about 17.5 ints per face, 4
+  // of which are the corner to face map, so the triangle mode saves
+  // a little less than a quarter of them, rather than one half
 
-  int     getNumberOfCorners() const;
+  bool    isTriangleMesh() const;
 
   // half-edges are in one-to-one correspondence with the corners of a
   // mesh, i.e., with the indices of the coordIndex array which do not
@@ -75,32 +116,32 @@ public:
   // the range 0<=iC<coordIndex.size(), or coordIndex[iC]<0, these
   // methods return -1; these two methods return vertex indices;
 
-  int     getSrc(const int iC) const;
-  int     getDst(const int iC) const;
+  Index   getSrc(const Index iC) const;
+  Index   getDst(const Index iC) const;
 
   // the mesh faces define loops of half edges; these two methods can
   // be used to move back and forth along these loops;
 
-  int     getNext(const int iC) const;
-  int     getPrev(const int iC) const;
+  Index   getNext(const Index iC) const;
+  Index   getPrev(const Index iC) const;
 
   // a regular edge of a mesh has exactly two incident half-edges; if
   // the half-edge associated with corner iC corresponds to a regular
   // edge of the mesh, this methods returns the other half edge;
   // otherwie it returns -1
 
-  int     getTwin(const int iC) const;
+  Index   getTwin(const Index iC) const;
 
   // if the edge index iE is in range, this method returns the number
   // of half edges incident to the given edge; otherwise it returns 0
                                    
-  int     getNumberOfEdgeHalfEdges(const int iE) const;
+  Index   getNumberOfEdgeHalfEdges(const Index iE) const;
 
   // if the edge index iE is in range, and
   // 0<=j<getNumberOfEdgeHalfEdges(iE), this method returns the j-th
   // corner corresponding to a half edge incident to the given edge
 
-  int     getEdgeHalfEdge(const int iE, const int j) const;
+  Index   getEdgeHalfEdge(const Index iE, const Index j) const;
 
   // TODO Mon Mar 6 2023
   // - new functions 
@@ -110,38 +151,121 @@ public:
   // of range, or it corresponds to a face separator, this method
   // returns -1;
 
-  int     getFace(const int iC) const;
+  Index   getFace(const Index iC) const;
 
   // returns the size of the face containing the half edge
   // corresponding to the corner index iC; if the corner index is out
   // of range, or it corresponds to a face separator, this method
   // returns -1;
   
-  int     getFaceSize(const int iC) const;
+  Index   getFaceSize(const Index iC) const;
 
   // returns true if the corresponding edge is regular and the twin is
   // consistently oriented; otherwise it returns false
 
-  bool    isOriented(const int iC) const;
+  bool    isOriented(const Index iC) const;
 
   // returns the number of faces incident to an edge if the edge index
   // is in the valid range, i.e., if 0<=iE<getNumberOfEdges();
   // otherwise it returns -1
 
-  int     getNumberOfFacesEdge(const int iE) const;
+  Index   getNumberOfFacesEdge(const Index iE) const;
 
-  // classification of edges
+  // classification of edges; the edges are classified by the
+  // constructor into packed arrays of bits, and the number of edges
+  // of each class is counted at the same time, so that all these
+  // methods take constant time
 
   bool    hasBoundaryEdges() const;
   bool    hasRegularEdges() const;
   bool    hasSingularEdges() const;
 
-  bool    isBoundaryEdge(const int iE) const;
-  bool    isRegularEdge(const int iE) const;
-  bool    isSingularEdge(const int iE) const;
+  Index   getNumberOfBoundaryEdges() const;
+  Index   getNumberOfRegularEdges() const;
+  Index   getNumberOfSingularEdges() const;
+
+  bool    isBoundaryEdge(const Index iE) const;
+  bool    isRegularEdge(const Index iE) const;
+  bool    isSingularEdge(const Index iE) const;
   
 protected:
 
+  // same as the public constructor, but the edges, the twins, and the
+  // corner to face map are only computed if build==true; otherwise
+  // the subclass is expected to call _build(), or to read them with
+  // _readHalfEdges()
+
+          HalfEdgesT(const Index nV, const vector<int>& coordIndex,
+                     const Backend backend, const int nThreads,
+                     const bool build);
+
+  using EdgesT<Index>::_buildFromFaces;
+  using EdgesT<Index>::_renumberVertices;
+  using EdgesT<Index>::_writeEdges;
+  using EdgesT<Index>::_readEdges;
+
+  // computes the edges, the twins, the corner to face map, and the
+  // edge classification
+
+  void    _build();
+
+  // fills the edge classification tables from the half-edge to edge
+  // incidence relation; called by _build() and _readHalfEdges()
+
+  void    _classifyEdges();
+
+  // the half-edge tables, including the edge tables, can be written
+  // to, and read back from, a DgpFile; _readHalfEdges() returns false
+  // if the sections are missing, inconsistent with the coordIndex
+  // array, or contain out of range indices, or if the twins and the
+  // corners of the edges are not the ones _build() would compute, in
+  // which case the tables should be rebuilt
+
+  void    _writeHalfEdges(DgpFile& file, vector<Index>& info) const;
+  bool    _readHalfEdges(const DgpFile& file);
+
+  // incremental update after the corners of some faces have been
+  // reversed in place in the coordIndex array, as done to orient a
+  // mesh; flipped is indexed by face, and is of size nF
+  // - _getFaceCorners() fills faceCorner with the corners of the
+  //   faces with flipped[iF]==true, in increasing order; it returns
+  //   false if flipped is not of size nF
+  // - _updateFlippedFaces() patches the lists of corners of the
+  //   edges of the faces in faceCorner, and their twins; edgeCorner
+  //   is the sorted array of pairs (iE,iC), where iE is the edge of
+  //   the half edge of corner iC, for the corners of faceCorner which
+  //   do not define degenerate half edges; the edges and their
+  //   classification do not change; it returns false, leaving the
+  //   tables unchanged, if the edges of the modified faces do not
+  //   match the ones they had before
+
+  bool    _getFaceCorners(const vector<bool>& flipped,
+                          vector<Index>& faceCorner) const;
+  bool    _updateFlippedFaces(const vector<bool>& flipped,
+                              const vector<Index>& faceCorner,
+                              const vector< pair<Index,Index> >& edgeCorner);
+
+  // replaces, in the array of arrays (first,list), the corners which
+  // belong to faces with flipped[iF]==true, by the corners of
+  // newCorner, where each element is a pair (iL,iC) specifying that
+  // iC belongs to list iL; the lists are kept in increasing order;
+  // newCorner must be sorted; if apply==false the lists are not modified;
+  // returns false if the number of corners replaced in some list
+  // differs from the number of corners previously in it
+
+  bool    _patchCornerLists(const vector<Index>& first,
+                            vector<Index>& list,
+                            const vector< pair<Index,Index> >& newCorner,
+                            const vector<bool>& flipped,
+                            const bool apply) const;
+
+  // face containing corner iC, for 0<=iC<nC and coordIndex[iC]>=0;
+  // there are no range checks
+
+  Index   _cornerFace(const Index iC) const {
+    return (_isTriangleMesh)?(iC>>2):_face[iC];
+  }
+
   // reference to the coordIndex passed as argument
   const vector<int>& _coordIndex;
 
@@ -149,20 +273,40 @@ protected:
   // - feel free to use different private variables
 
   // array of twin corners
-  vector<int>  _twin;
+  vector<Index> _twin;
 
-  // mapping from corners to faces
-        vector<int> _face;
+  // mapping from corners to faces; empty for triangle meshes
+        vector<Index> _face;
 
   // the half-edge to edge incidence relations is represented as an
   // arrray of arrays
-        vector<int> _firstCornerEdge;
-        vector<int> _cornerEdge;
+        vector<Index> _firstCornerEdge;
+        vector<Index> _cornerEdge;
 
-  // TODO Mon Mar 6 2023
-  //
-  // - add any additional variables you need to make it work
+  // number of threads requested in the constructor, also used by
+  // the subclasses
+        int         _nThreads;
+
+  // number of faces, i.e., number of -1's in the coordIndex array
+        Index       _nFaces;
+
+  // see isTriangleMesh()
+        bool        _isTriangleMesh;
+
+  // edge classification, determined in the constructor
+        BitSet      _isBoundaryEdge;
+        BitSet      _isRegularEdge;
+        BitSet      _isSingularEdge;
+        Index       _nBoundaryEdges;
+        Index       _nRegularEdges;
+        Index       _nSingularEdges;
 
 };
 
+typedef HalfEdgesT<int>     HalfEdges;
+typedef HalfEdgesT<int64_t> HalfEdges64;
+
+extern template class HalfEdgesT<int>;
+extern template class HalfEdgesT<int64_t>;
+
 #endif /* _HALF_EDGES_HPP_ */
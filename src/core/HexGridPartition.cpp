@@ -45,7 +45,11 @@
 
 #include <cmath>
 #include <iostream>
+#include <algorithm>
+#include <limits>
+#include <map>
 #include "HexGridPartition.hpp"
+#include "util/Parallel.hpp"
 
 HexGridPartition::HexGridPartition
 (const Vec3f& min, const Vec3f& max, const int resolution):
@@ -54,10 +58,15 @@ HexGridPartition::HexGridPartition
   _resolution(resolution),
   _nPointsInsideBox(0),
   _nPointsOutsideBox(0),
+  _cellId(),
+  _cellFirst(),
+  _cellPoint(),
   _next(),
-  _first(),
   _coord(nullptr),
-  _normal(nullptr) {
+  _normal(nullptr),
+  _streamCell(),
+  _streamHash(),
+  _streamHasNormal(false) {
 
 }
 
@@ -69,10 +78,15 @@ HexGridPartition::HexGridPartition
   _resolution(resolution),
   _nPointsInsideBox(0),
   _nPointsOutsideBox(0),
+  _cellId(),
+  _cellFirst(),
+  _cellPoint(),
   _next(),
-  _first(),
   _coord(nullptr),
-  _normal(nullptr) {
+  _normal(nullptr),
+  _streamCell(),
+  _streamHash(),
+  _streamHasNormal(false) {
   float dx=size.x/2.0f, dy=size.y/2.0f, dz=size.z/2.0f;
   float dMax = dx; if(dy>dMax) dMax=dy; if(dz>dMax) dMax=dz;
   if(cube      ) { dx = dy = dz = dMax; }
@@ -84,8 +98,10 @@ HexGridPartition::HexGridPartition
 bool HexGridPartition::insertPoints(const vector<float>& coord) {
   _nPointsInsideBox = 0;
   _nPointsOutsideBox = 0;
+  _cellId.clear();
+  _cellFirst.clear();
+  _cellPoint.clear();
   _next.clear();
-  _first.clear();
   if(_resolution<1) return false; // failure
   int nPoints = static_cast<int>(coord.size()/3);
   float dx = _max.x-_min.x;
@@ -100,90 +116,67 @@ bool HexGridPartition::insertPoints(const vector<float>& coord) {
   _coord  = &coord;
   _next.resize(nPoints,-1);
 
+  // 1) determine the cell containing each point
   int N  = _resolution;
-  int n0 = N;
-  int n1 = N;
-  int n2 = N;
-  int iCell,iPoint,ix,iy,iz;
-  float x,y,z;
+  int iPoint;
+  int64_t iCell;
+  vector<int64_t> pointCell(nPoints);
   for(iPoint=0;iPoint<nPoints;iPoint++) {
-    if((x = (*_coord)[3*iPoint  ])<_min.x || x>_max.x) continue;
-    if((y = (*_coord)[3*iPoint+1])<_min.y || y>_max.y) continue;
-    if((z = (*_coord)[3*iPoint+2])<_min.z || z>_max.z) continue;
-    ix = static_cast<int>((n0*(x-_min.x))/dx);
-    iy = static_cast<int>((n1*(y-_min.y))/dy);
-    iz = static_cast<int>((n2*(z-_min.z))/dz);
-    if(ix<0 || ix>=n0 || iy<0 || iy>=n0 || iz<0 || iz>=n0) {
+    iCell = _getPointCellId((*_coord)[3*iPoint  ],
+                            (*_coord)[3*iPoint+1],
+                            (*_coord)[3*iPoint+2]);
+    if(iCell<0) {
       _nPointsOutsideBox++;
       continue;
     }
+    pointCell[_nPointsInsideBox] = iCell;
+    _cellPoint.push_back(iPoint);
     _nPointsInsideBox++;
-    iCell = ix+n0*(iy+n1*iz); // 0<=iCell<(N+1)*(N+1)*(N+1)
-    if(_first.count(iCell)==1) {
-      _next[iPoint] = _first[iCell];
-    } /* else { _next[iPoint] = -1; } */
-    _first[iCell] = iPoint;
   }
 
+  // 2) LSD radix sort of the points by cell id, 16 bits per pass;
+  //    only the passes needed to cover 0<=iCell<N*N*N are performed;
+  //    since each pass is stable, the points of each cell end up in
+  //    increasing order
+  const int nInside = _nPointsInsideBox;
+  pointCell.resize(nInside);
+  const int64_t nCells = static_cast<int64_t>(N)*N*N;
+  vector<int>     pointSorted(nInside);
+  vector<int64_t> cellSorted(nInside);
+  vector<int>     count(65537);
+  for(int shift=0;(nCells-1)>>shift>0;shift+=16) {
+    count.assign(count.size(),0);
+    for(int k=0;k<nInside;k++)
+      count[((pointCell[k]>>shift)&0xffff)+1]++;
+    for(int d=0;d<65536;d++)
+      count[d+1] += count[d];
+    for(int k=0;k<nInside;k++) {
+      int j = count[(pointCell[k]>>shift)&0xffff]++;
+      pointSorted[j] = _cellPoint[k];
+      cellSorted[j]  = pointCell[k];
+    }
+    _cellPoint.swap(pointSorted);
+    pointCell.swap(cellSorted);
+  }
+
+  // 3) one entry per occupied cell
+  for(int k=0;k<nInside;k++) {
+    if(k==0 || pointCell[k]!=pointCell[k-1]) {
+      _cellId.push_back(pointCell[k]);
+      _cellFirst.push_back(k);
+    } else {
+      _next[_cellPoint[k-1]] = _cellPoint[k];
+    }
+  }
+  _cellFirst.push_back(nInside);
+
   return true; // success
 }
 
 bool HexGridPartition::sample
-(vector<float>& coordSample, vector<int>* vMap) {
-
+(vector<float>& coordSample, vector<int>* vMap, const int nThreads) {
   if(_coord==nullptr) return false;
-
-  coordSample.clear();
-
-  if(vMap!=nullptr) {
-    vMap->clear();
-    int nPoints = static_cast<int>(_coord->size()/3);
-    vMap->resize(nPoints,-1);
-  }
-  
-  // int N=_resolution,n0=N,n1=N,n2=N,ix,iy,iz,iCell;
-  int k,iPointFirst,iPoint,nPointsCell,iPointMin,iSamplePoint;
-  float xMean,yMean,zMean,fPointsInCell,dx,dy,dz,dPoint2,dMin2;
-  map<int,int>::iterator iMap = _first.begin();
-  for(;iMap!=_first.end();iMap++) {
-    // iCell = iMap->first;
-    iPointFirst = iMap->second;
-    iSamplePoint = static_cast<int>(coordSample.size()/3);
-
-    // count number of points in cell
-    // and mean coords of points contained in the cell
-    nPointsCell = 0;
-    xMean=yMean=zMean=0.0f;
-    for(iPoint=iPointFirst;iPoint>=0;iPoint=_next[iPoint]) {
-      xMean += (*_coord)[3*iPoint  ];
-      yMean += (*_coord)[3*iPoint+1];
-      zMean += (*_coord)[3*iPoint+2];
-      nPointsCell++;
-      if(vMap!=nullptr) (*vMap)[iPoint] = iSamplePoint;
-    }
-    fPointsInCell = static_cast<float>(nPointsCell);
-    xMean /= fPointsInCell;
-    yMean /= fPointsInCell;
-    zMean /= fPointsInCell;
-
-    // find amongst the points contained in the cell, the closest to the mean
-    dMin2 = std::numeric_limits<float>::max();
-    iPointMin = -1;
-    for(iPoint=iPointFirst;iPoint>=0;iPoint=_next[iPoint]) {
-      dx = (*_coord)[3*iPoint  ]-xMean;
-      dy = (*_coord)[3*iPoint+1]-yMean;
-      dz = (*_coord)[3*iPoint+2]-zMean;
-      dPoint2 = dx*dx+dy*dy+dz*dz;
-      if(dPoint2<dMin2) {
-        dMin2 = dPoint2;
-        iPointMin = iPoint;
-      }
-    }
-    for(k=0;k<3;k++) {
-      coordSample.push_back((*_coord)[3*iPointMin+k]);
-    }
-  }
-  return true;
+  return _sample(coordSample,nullptr,vMap,nThreads);
 }
 
 bool HexGridPartition::insertPoints
@@ -205,62 +198,224 @@ bool HexGridPartition::insertPoints
 }
 
 bool HexGridPartition::sample
-(vector<float>& coordSample, vector<float>& normalSample, vector<int>* vMap) {
-
+(vector<float>& coordSample, vector<float>& normalSample,
+ vector<int>* vMap, const int nThreads) {
   if(_coord==nullptr || _normal==nullptr) return false;
+  return _sample(coordSample,&normalSample,vMap,nThreads);
+}
 
-  coordSample.clear();
-  normalSample.clear();
+// number of independent partial sums and partial minima used in the
+// per cell reductions; the inner loops over the lanes carry no
+// dependencies, and are vectorized by the compiler
+static const int _nLanes = 8;
+
+// mean of the n points (x[j],y[j],z[j])
+static void _cellMean
+(const float* x, const float* y, const float* z, const int n,
+ float& xMean, float& yMean, float& zMean) {
+  float sx[_nLanes],sy[_nLanes],sz[_nLanes];
+  int j,l;
+  for(l=0;l<_nLanes;l++)
+    sx[l] = sy[l] = sz[l] = 0.0f;
+  for(j=0;j+_nLanes<=n;j+=_nLanes)
+    for(l=0;l<_nLanes;l++) {
+      sx[l] += x[j+l];
+      sy[l] += y[j+l];
+      sz[l] += z[j+l];
+    }
+  for(l=0;j<n;j++,l++) {
+    sx[l] += x[j];
+    sy[l] += y[j];
+    sz[l] += z[j];
+  }
+  xMean = yMean = zMean = 0.0f;
+  for(l=0;l<_nLanes;l++) {
+    xMean += sx[l];
+    yMean += sy[l];
+    zMean += sz[l];
+  }
+  float fn = static_cast<float>(n);
+  xMean /= fn;
+  yMean /= fn;
+  zMean /= fn;
+}
 
+// position 0<=j<n of the point closest to (xMean,yMean,zMean); ties
+// are resolved in favor of the smallest position
+static int _cellClosest
+(const float* x, const float* y, const float* z, const int n,
+ const float xMean, const float yMean, const float zMean) {
+  float dMin2[_nLanes],dx,dy,dz,d2;
+  int   jMin[_nLanes],j,l;
+  for(l=0;l<_nLanes;l++) {
+    dMin2[l] = std::numeric_limits<float>::infinity();
+    jMin[l]  = -1;
+  }
+  for(j=0;j+_nLanes<=n;j+=_nLanes)
+    for(l=0;l<_nLanes;l++) {
+      dx = x[j+l]-xMean;
+      dy = y[j+l]-yMean;
+      dz = z[j+l]-zMean;
+      d2 = dx*dx+dy*dy+dz*dz;
+      if(d2<dMin2[l]) { dMin2[l] = d2; jMin[l] = j+l; }
+    }
+  for(l=0;j<n;j++,l++) {
+    dx = x[j]-xMean;
+    dy = y[j]-yMean;
+    dz = z[j]-zMean;
+    d2 = dx*dx+dy*dy+dz*dz;
+    if(d2<dMin2[l]) { dMin2[l] = d2; jMin[l] = j; }
+  }
+  float dBest2 = 0.0f;
+  int   jBest  = -1;
+  for(l=0;l<_nLanes;l++) {
+    if(jMin[l]<0) continue;
+    if(jBest<0 || dMin2[l]<dBest2 || (dMin2[l]==dBest2 && jMin[l]<jBest)) {
+      dBest2 = dMin2[l];
+      jBest  = jMin[l];
+    }
+  }
+  return (jBest<0)?0:jBest;
+}
+
+bool HexGridPartition::_sample
+(vector<float>& coordSample, vector<float>* normalSample,
+ vector<int>* vMap, const int nThreads) {
+
+  const int nPoints = static_cast<int>(_coord->size()/3);
+  const int nInside = static_cast<int>(_cellPoint.size());
+  const int nCells  = getNumberOfCells();
+
+  coordSample.clear();
+  coordSample.resize(3*nCells);
+  if(normalSample!=nullptr) {
+    normalSample->clear();
+    normalSample->resize(3*nCells);
+  }
   if(vMap!=nullptr) {
     vMap->clear();
-    int nPoints = static_cast<int>(_coord->size()/3);
     vMap->resize(nPoints,-1);
   }
-  
-  // int N=_resolution,n0=N,n1=N,n2=N,ix,iy,iz,iCell;
-  int k,iPointFirst,iPoint,nPointsCell,iPointMin,iSamplePoint;
-  float xMean,yMean,zMean,fPointsInCell,dx,dy,dz,dPoint2,dMin2;
-  map<int,int>::iterator iMap = _first.begin();
-  for(;iMap!=_first.end();iMap++) {
-    // iCell = iMap->first;
-    iPointFirst = iMap->second;
-    iSamplePoint = static_cast<int>(coordSample.size()/3);
-
-    // count number of points in cell
-    // and mean coords of points contained in the cell
-    nPointsCell = 0;
-    xMean=yMean=zMean=0.0f;
-    for(iPoint=iPointFirst;iPoint>=0;iPoint=_next[iPoint]) {
-      xMean += (*_coord)[3*iPoint  ];
-      yMean += (*_coord)[3*iPoint+1];
-      zMean += (*_coord)[3*iPoint+2];
-      nPointsCell++;
-      if(vMap!=nullptr) (*vMap)[iPoint] = iSamplePoint;
-    }
-    fPointsInCell = static_cast<float>(nPointsCell);
-    xMean /= fPointsInCell;
-    yMean /= fPointsInCell;
-    zMean /= fPointsInCell;
-
-    // find amongst the points contained in the cell, the closest to the mean
-    dMin2 = std::numeric_limits<float>::max();
-    iPointMin = -1;
-    for(iPoint=iPointFirst;iPoint>=0;iPoint=_next[iPoint]) {
-      dx = (*_coord)[3*iPoint  ]-xMean;
-      dy = (*_coord)[3*iPoint+1]-yMean;
-      dz = (*_coord)[3*iPoint+2]-zMean;
-      dPoint2 = dx*dx+dy*dy+dz*dz;
-      if(dPoint2<dMin2) {
-        dMin2 = dPoint2;
-        iPointMin = iPoint;
+
+  // 1) gather the coordinates of the points contained in the cells
+  //    into separate x, y, and z arrays, in cell order, so that the
+  //    points of each cell are contiguous in memory
+  const float* coord = _coord->data();
+  vector<float> x(nInside),y(nInside),z(nInside);
+  int nT = Parallel::getNumberOfThreads(nThreads,nInside,1<<14);
+  Parallel::forEachRange
+    (nT,nInside,[&](int /*iT*/, size_t k0, size_t k1) {
+      for(size_t k=k0;k<k1;k++) {
+        const float* p = coord+3*_cellPoint[k];
+        x[k] = p[0];
+        y[k] = p[1];
+        z[k] = p[2];
+      }
+    });
+
+  // 2) one sample per cell; each cell writes only its own sample
+  //    and the vMap entries of its own points
+  nT = Parallel::getNumberOfThreads(nThreads,nCells,1<<10);
+  Parallel::forEachRange
+    (nT,nCells,[&](int /*iT*/, size_t i0, size_t i1) {
+      float xMean,yMean,zMean;
+      int   i,k,k0,n,iPointMin;
+      for(i=static_cast<int>(i0);i<static_cast<int>(i1);i++) {
+        k0 = _cellFirst[i];
+        n  = _cellFirst[i+1]-k0;
+        _cellMean(&x[k0],&y[k0],&z[k0],n,xMean,yMean,zMean);
+        iPointMin =
+          _cellPoint[k0+_cellClosest(&x[k0],&y[k0],&z[k0],n,
+                                     xMean,yMean,zMean)];
+        for(k=0;k<3;k++)
+          coordSample[3*i+k] = coord[3*iPointMin+k];
+        if(normalSample!=nullptr)
+          for(k=0;k<3;k++)
+            (*normalSample)[3*i+k] = (*_normal)[3*iPointMin+k];
+        if(vMap!=nullptr)
+          for(k=k0;k<k0+n;k++)
+            (*vMap)[_cellPoint[k]] = i;
+      }
+    });
+
+  return true;
+}
+
+void HexGridPartition::beginStream() {
+  _streamCell.clear();
+  _streamResize(1024);
+  _streamHasNormal = true;
+}
+
+// coord and normal point to 3*nPoints floats each; normal may be
+// null, in which case endStream() will not be able to return normals;
+// returns the number of points contained in the bounding box
+int HexGridPartition::insertStreamPoints
+(const float* coord, const float* normal, const int nPoints) {
+  if(_resolution<1 || coord==nullptr || nPoints<=0) return 0;
+  if(_max.x<=_min.x || _max.y<=_min.y || _max.z<=_min.z) return 0;
+  if(_streamHash.size()==0) beginStream();
+  if(normal==nullptr) _streamHasNormal = false;
+  int iPoint,i,k,nInside = 0;
+  int64_t iCell;
+  double mean[3],dNew2,dOld2,d;
+  for(iPoint=0;iPoint<nPoints;iPoint++) {
+    const float* p = coord+3*iPoint;
+    if((iCell=_getPointCellId(p[0],p[1],p[2]))<0) continue;
+    nInside++;
+    StreamCell& cell = _streamCell[_streamFindOrInsert(iCell)];
+    cell.nPoints++;
+    for(k=0;k<3;k++) cell.sum[k] += p[k];
+    if(cell.nPoints>1) {
+      // keep the candidate if it is at least as close to the
+      // updated mean as the new point
+      dNew2 = dOld2 = 0.0;
+      for(k=0;k<3;k++) {
+        mean[k] = cell.sum[k]/static_cast<double>(cell.nPoints);
+        d = p[k]-mean[k];          dNew2 += d*d;
+        d = cell.coord[k]-mean[k]; dOld2 += d*d;
       }
+      if(dNew2>=dOld2) continue;
     }
-    for(k=0;k<3;k++) {
-      coordSample.push_back((*_coord)[3*iPointMin+k]);
-      normalSample.push_back((*_normal)[3*iPointMin+k]);
+    for(k=0;k<3;k++) cell.coord[k] = p[k];
+    if(normal!=nullptr)
+      for(i=3*iPoint,k=0;k<3;k++) cell.normal[k] = normal[i+k];
+  }
+  return nInside;
+}
+
+int HexGridPartition::insertStreamPoints(const vector<float>& coord) {
+  return insertStreamPoints(coord.data(),nullptr,
+                            static_cast<int>(coord.size()/3));
+}
+
+int HexGridPartition::insertStreamPoints
+(const vector<float>& coord, const vector<float>& normal) {
+  if(normal.size()!=coord.size()) return 0;
+  return insertStreamPoints(coord.data(),normal.data(),
+                            static_cast<int>(coord.size()/3));
+}
+
+bool HexGridPartition::endStream
+(vector<float>& coordSample, vector<float>* normalSample) {
+  if(normalSample!=nullptr && _streamHasNormal==false) return false;
+  sort(_streamCell.begin(),_streamCell.end(),
+       [](const StreamCell& a, const StreamCell& b) {
+         return a.iCell<b.iCell;
+       });
+  const size_t nCells = _streamCell.size();
+  coordSample.resize(3*nCells);
+  if(normalSample!=nullptr) normalSample->resize(3*nCells);
+  for(size_t i=0;i<nCells;i++) {
+    for(int k=0;k<3;k++) {
+      coordSample[3*i+k] = _streamCell[i].coord[k];
+      if(normalSample!=nullptr)
+        (*normalSample)[3*i+k] = _streamCell[i].normal[k];
     }
   }
+  // release the accumulators
+  vector<StreamCell>().swap(_streamCell);
+  vector<StreamSlot>().swap(_streamHash);
   return true;
 }
 
@@ -272,11 +427,10 @@ int HexGridPartition::getNumberOfPoints() {
 }
 
 int HexGridPartition::getFirst(const int ix, const int iy, const int iz) {
-  int N  = _resolution, n0 = N, n1 = N /*, n2 = N*/;
+  int N  = _resolution, n0 = N;
   if(ix<0 || ix>=n0 || iy<0 || iy>=n0 || iz<0 || iz>=n0) return -1;
-  int iCell = ix+n0*(iy+n1*iz); // 0<=iCell<(N+1)*(N+1)*(N+1)
-  if(_first.count(iCell)==0) return -1; 
-  return _first[iCell];
+  int i = _findCell(_getCellId(ix,iy,iz));
+  return (i<0)?-1:_cellPoint[_cellFirst[i]];
 }
 
 int HexGridPartition::getNext(const int iPoint) {
@@ -288,26 +442,24 @@ int HexGridPartition::getNext(const int iPoint) {
 
 int HexGridPartition::getNumberOfVertices() {
   int nV = 0;
-  int h,h0,h1,h2,iCell,iC,iCx,iCy,iCz,iVx,iVy,iVz,iVertex;
-  int N = _resolution;
-  map<int,int> vMap;
-  map<int,int>::iterator iMap;
-  for(iMap=_first.begin();iMap!=_first.end();iMap++) {
-    iCell       = iMap->first;
-    iC = iCell; iCx = iC%N; iC/=N; iCy = iC%N; iC/=N; iCz = iC;
-    //
-    // 0 ---- 1
-    // |\     |\
-    // | 2 ---- 3
-    // 4 +--- 5 |
-    //  \|     \|
-    //   6 ---- 7
-    //
+  int h,h0,h1,h2,iCx,iCy,iCz,iVx,iVy,iVz;
+  int64_t iVertex,N1 = _resolution+1;
+  map<int64_t,int> vMap;
+  for(CellIterator iCell=cellsBegin();iCell!=cellsEnd();iCell++) {
+    getCellIndices(*iCell,iCx,iCy,iCz);
+    /*            */
+    /* 0 ---- 1   */
+    /* |\     |\  */
+    /* | 2 ---- 3 */
+    /* 4 +--- 5 | */
+    /*  \|     \| */
+    /*   6 ---- 7 */
+    /*            */
     for(h=0;h<8;h++) {
       h0 = (h  )%2; iVx = iCx+h0;
       h1 = (h/2)%2; iVy = iCy+h1;
       h2 = (h/4)%2; iVz = iCz+h2;
-      iVertex = iVx+(N+1)*(iVy+(N+1)*iVz);
+      iVertex = iVx+N1*(iVy+N1*iVz);
       if(vMap.count(iVertex)==0) {
         vMap[iVertex] = nV++;
       }
@@ -315,3 +467,93 @@ int HexGridPartition::getNumberOfVertices() {
   }
   return nV;
 }
+
+int64_t HexGridPartition::getCellId(const int i) const {
+  return (i<0 || i>=static_cast<int>(_cellId.size()))?-1:_cellId[i];
+}
+
+int HexGridPartition::getCellNumberOfPoints(const int i) const {
+  if(i<0 || i>=static_cast<int>(_cellId.size())) return 0;
+  return _cellFirst[i+1]-_cellFirst[i];
+}
+
+int HexGridPartition::getCellPoint(const int i, const int j) const {
+  if(j<0 || j>=getCellNumberOfPoints(i)) return -1;
+  return _cellPoint[_cellFirst[i]+j];
+}
+
+void HexGridPartition::getCellIndices
+(const int64_t iCell, int& ix, int& iy, int& iz) const {
+  const int64_t N = _resolution;
+  int64_t iC = iCell;
+  ix = static_cast<int>(iC%N); iC /= N;
+  iy = static_cast<int>(iC%N); iC /= N;
+  iz = static_cast<int>(iC);
+}
+
+// 0<=iCell<N*N*N does not overflow for resolutions above 1290
+int64_t HexGridPartition::_getCellId
+(const int ix, const int iy, const int iz) const {
+  const int64_t N = _resolution;
+  return ix+N*(iy+N*static_cast<int64_t>(iz));
+}
+
+// returns -1 if the point is not contained in the bounding box
+int64_t HexGridPartition::_getPointCellId
+(const float x, const float y, const float z) const {
+  // written so that NaN coordinates are also rejected
+  if(!(x>=_min.x && x<=_max.x)) return -1;
+  if(!(y>=_min.y && y<=_max.y)) return -1;
+  if(!(z>=_min.z && z<=_max.z)) return -1;
+  const int N = _resolution;
+  int ix = static_cast<int>((N*(x-_min.x))/(_max.x-_min.x));
+  int iy = static_cast<int>((N*(y-_min.y))/(_max.y-_min.y));
+  int iz = static_cast<int>((N*(z-_min.z))/(_max.z-_min.z));
+  if(ix<0 || ix>=N || iy<0 || iy>=N || iz<0 || iz>=N) return -1;
+  return _getCellId(ix,iy,iz);
+}
+
+// if the cell is found in the hash table, returns its position in
+// the _streamCell array; otherwise appends a new empty cell to the
+// array, stores it in the table, and returns its position
+int HexGridPartition::_streamFindOrInsert(const int64_t iCell) {
+  // keep the load factor below 1/2
+  if(2*(_streamCell.size()+1)>_streamHash.size())
+    _streamResize(2*_streamHash.size());
+  const size_t mask = _streamHash.size()-1;
+  const uint64_t key = static_cast<uint64_t>(iCell)*0x9E3779B97F4A7C15ULL;
+  size_t h = static_cast<size_t>(key>>32)&mask;
+  for(;_streamHash[h].i>=0;h=(h+1)&mask)
+    if(_streamHash[h].iCell==iCell) return _streamHash[h].i;
+  StreamCell cell = { iCell, 0, { 0.0, 0.0, 0.0 },
+                      { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } };
+  _streamHash[h].iCell = iCell;
+  _streamHash[h].i     = static_cast<int>(_streamCell.size());
+  _streamCell.push_back(cell);
+  return _streamHash[h].i;
+}
+
+// nSlots must be a power of 2; all the cells stored in the
+// _streamCell array are reinserted
+void HexGridPartition::_streamResize(const size_t nSlots) {
+  const StreamSlot empty = { -1, -1 };
+  _streamHash.assign(nSlots,empty);
+  const size_t mask = nSlots-1;
+  const int nCells = static_cast<int>(_streamCell.size());
+  for(int i=0;i<nCells;i++) {
+    const int64_t iCell = _streamCell[i].iCell;
+    const uint64_t key = static_cast<uint64_t>(iCell)*0x9E3779B97F4A7C15ULL;
+    size_t h = static_cast<size_t>(key>>32)&mask;
+    while(_streamHash[h].i>=0) h = (h+1)&mask;
+    _streamHash[h].iCell = iCell;
+    _streamHash[h].i     = i;
+  }
+}
+
+// binary search; returns the position of the cell in the _cellId
+// array, or -1 if the cell is not occupied
+int HexGridPartition::_findCell(const int64_t iCell) const {
+  CellIterator i = lower_bound(_cellId.begin(),_cellId.end(),iCell);
+  if(i==_cellId.end() || *i!=iCell) return -1;
+  return static_cast<int>(i-_cellId.begin());
+}
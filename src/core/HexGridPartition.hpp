@@ -47,7 +47,7 @@
 #define HEX_GRID_PARTITION_HPP
 
 #include <vector>
-#include <map>
+#include <cstdint>
 #include "wrl/Types.hpp"
 
 using namespace std;
@@ -65,23 +65,70 @@ public:
   bool   insertPoints
   (const vector<float>& coord);
   bool   sample
-  (vector<float>& coordSample, vector<int>* vMap=nullptr);
+  (vector<float>& coordSample, vector<int>* vMap=nullptr,
+   const int nThreads=0);
 
   bool   insertPoints
   (const vector<float>& coord, const vector<float>& normal);
   bool   sample
   (vector<float>& coordSample, vector<float>& normalSample,
-   vector<int>* vMap=nullptr);
+   vector<int>* vMap=nullptr, const int nThreads=0);
+
+  // both sample() methods produce one sample per occupied cell, in
+  // the order of the cells, which is the point of the cell closest
+  // to the mean of the points contained in the cell; if vMap is not
+  // null, (*vMap)[iPoint] is set to the index of the sample of the
+  // cell containing the point, or to -1 if the point is outside of
+  // the bounding box; the cells are processed in parallel by
+  // nThreads threads (see util/Parallel.hpp), and the result does
+  // not depend on the number of threads
+
+  // streaming mode, for point sets too large to be kept in memory;
+  // the points are inserted in chunks of arbitrary size, between
+  // calls to beginStream() and endStream(), and only per cell
+  // accumulators are stored: the number of points, the sum of their
+  // coordinates, and a candidate sample point (and its normal); a
+  // point replaces the candidate if it is closer than the candidate
+  // to the running mean of the points inserted so far in the cell,
+  // so that the result approximates the one produced by sample();
+  // endStream() returns one sample per occupied cell, in the same
+  // cell order as sample(), and releases the accumulators
+  void   beginStream();
+  int    insertStreamPoints
+  (const float* coord, const float* normal, const int nPoints);
+  int    insertStreamPoints
+  (const vector<float>& coord);
+  int    insertStreamPoints
+  (const vector<float>& coord, const vector<float>& normal);
+  bool   endStream
+  (vector<float>& coordSample, vector<float>* normalSample=nullptr);
 
-  int    getNumberOfCells() { return static_cast<int>(_first.size()); }
+  int    getNumberOfStreamCells()
+  { return static_cast<int>(_streamCell.size()); }
+
+  int    getNumberOfCells() { return static_cast<int>(_cellId.size()); }
   int    getNumberOfVertices();
 
   int    getNumberOfPoints();
   int    getFirst(const int ix, const int iy, const int iz);
-  map<int,int>& getFirstMap() { return _first; }
 
   int    getNext(const int iPoint);
 
+  // the occupied cells are stored in increasing order of their 64-bit
+  // ids iCell = ix+N*(iy+N*iz), where N is the resolution; the points
+  // contained in the i-th occupied cell are getCellPoint(i,j), for
+  // 0<=j<getCellNumberOfPoints(i), in increasing order
+  typedef vector<int64_t>::const_iterator CellIterator;
+
+  CellIterator cellsBegin() const { return _cellId.begin(); }
+  CellIterator cellsEnd()   const { return _cellId.end();   }
+
+  int64_t getCellId(const int i) const;
+  int     getCellNumberOfPoints(const int i) const;
+  int     getCellPoint(const int i, const int j) const;
+  void    getCellIndices
+          (const int64_t iCell, int& ix, int& iy, int& iz) const;
+
   Vec3f& getMin()   { return   _min; }
   Vec3f& getMax()   { return   _max; }
 
@@ -95,11 +142,44 @@ private:
   int          _nPointsInsideBox;
   int          _nPointsOutsideBox;
 
-  vector<int>  _next;
-  map<int,int> _first;
+  // the points are counting sorted by cell into an array of arrays:
+  // the points contained in the i-th occupied cell _cellId[i] are
+  // _cellPoint[k] for _cellFirst[i]<=k<_cellFirst[i+1]; _next links
+  // each point to the next point in the same cell, or to -1
+  vector<int64_t> _cellId;
+  vector<int>     _cellFirst;
+  vector<int>     _cellPoint;
+  vector<int>     _next;
 
   const vector<float>* _coord;
   const vector<float>* _normal;
+
+  // streaming mode accumulators; the occupied cells are stored in
+  // insertion order in _streamCell, and located through an open
+  // addressing hash table with linear probing, keyed by cell id
+  struct StreamCell {
+    int64_t iCell;
+    int64_t nPoints;
+    double  sum[3];
+    float   coord[3];
+    float   normal[3];
+  };
+  struct StreamSlot {
+    int64_t iCell;
+    int     i;
+  };
+  vector<StreamCell> _streamCell;
+  vector<StreamSlot> _streamHash;
+  bool               _streamHasNormal;
+
+  bool    _sample
+          (vector<float>& coordSample, vector<float>* normalSample,
+           vector<int>* vMap, const int nThreads);
+  int64_t _getCellId(const int ix, const int iy, const int iz) const;
+  int64_t _getPointCellId(const float x, const float y, const float z) const;
+  int     _streamFindOrInsert(const int64_t iCell);
+  void    _streamResize(const size_t nSlots);
+  int     _findCell(const int64_t iCell) const;
 };
 
 #endif // HEX_GRID_PARTITION_HPP
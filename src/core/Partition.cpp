@@ -41,7 +41,8 @@
 
 #include "Partition.hpp"
 
-Partition::Partition(const int nElements):
+template<class Index>
+PartitionT<Index>::PartitionT(const Index nElements):
   _nParts(0),
   _parent(),
   _size()
@@ -49,31 +50,35 @@ Partition::Partition(const int nElements):
   reset(nElements);
 }
 
-void Partition::reset(const int nElements) {
+template<class Index>
+void PartitionT<Index>::reset(const Index nElements) {
   _nParts = 0;
   _parent.clear();
   _size.clear();
   if(nElements>0) {
     _nParts = nElements;
-    for(int i=0;i<nElements;i++) {
+    for(Index i=0;i<nElements;i++) {
       _parent.push_back(i);
       _size.push_back(1);
     }
   }
 }
 
-int Partition::getNumberOfElements() const {
-  return static_cast<int>(_parent.size());
+template<class Index>
+Index PartitionT<Index>::getNumberOfElements() const {
+  return static_cast<Index>(_parent.size());
 }
 
-int Partition::getNumberOfParts() const {
+template<class Index>
+Index PartitionT<Index>::getNumberOfParts() const {
   return _nParts;
 }
 
-int Partition::find(const int i) {
+template<class Index>
+Index PartitionT<Index>::find(const Index i) {
   if(i<0) return -1;
   if(i>=getNumberOfElements()) return -1;
-  int Ri,Pj,j;
+  Index Ri,Pj,j;
   // traverse path and find root node
   for(Ri=i;_parent[Ri]!=Ri;Ri=_parent[Ri]);
   // compress the path:
@@ -83,10 +88,12 @@ int Partition::find(const int i) {
   return Ri;
 }
 
-int Partition::join(const int i, const int j) {
-  int Ri,Rj,part;
+template<class Index>
+Index PartitionT<Index>::join(const Index i, const Index j) {
+  Index Ri,Rj,part;
   Ri = find(i);
   Rj = find(j);
+  if(Ri<0 || Rj<0) return -1;
   if((part=Ri)!=Rj) {
     _nParts--;
     if(_size[Ri]>=_size[Rj]) {
@@ -100,7 +107,11 @@ int Partition::join(const int i, const int j) {
   return part;
 }
 
-int Partition::getSize(const int i) const {
-  return (i<0 || i>=static_cast<int>(_parent.size()))?0:_size[i];
+template<class Index>
+Index PartitionT<Index>::getSize(const Index i) const {
+  return (i<0 || i>=static_cast<Index>(_parent.size()))?0:_size[i];
 
 }
+
+template class PartitionT<int>;
+template class PartitionT<int64_t>;
@@ -46,14 +46,19 @@
 #ifndef _PARTITION_HPP_
 #define _PARTITION_HPP_
 
+#include <cstdint>
 #include <vector>
 
 using namespace std;
 
-class Partition {
+template<class Index>
+class PartitionT {
 
   // this class implements the Fast Union-Find data structure
   //
+  // the Index type of the elements is int or int64_t; the two
+  // instantiations are compiled in Partition.cpp
+  //
   // Reference
   // https://en.wikipedia.org/wiki/Disjoint-set_data_structure
   
@@ -61,28 +66,28 @@ public:
 
   // create a partition of the N elements {0,1,2,...,N-1} where
   // every element is a singleton {0},{1},{2},...,{N-1}
-          Partition(const int nElements);
+          PartitionT(const Index nElements);
 
   // delete the current partition and create a new partition of the N
   // elements {0,1,2,...,N-1} where every element is a singleton
   // {0},{1},{2},...,{N-1}; the number of elements N can be different
   // from the one previously set by the constructor or by a previous
   // call to this method
-  virtual void reset(const int nElements);
+  virtual void reset(const Index nElements);
 
   // returns the current number of elements; i.e. the value of the
   // parameter N passed to the constructore or to the reset(N) method 
-  int     getNumberOfElements()          const;
+  Index   getNumberOfElements()          const;
 
   // returns the current number of parts; immediately after
   // constructed or reset, the the number of parts should be equal to
   // the number of elements because each element becomes a singleton
-  int     getNumberOfParts()             const;
+  Index   getNumberOfParts()             const;
 
   // the class assigns each part a unique non-negative ID number; this
   // method return the part ID number of the part containing element i;
   // if the element index is out of range this method returns -1
-  int     find(const int i);
+  Index   find(const Index i);
 
   // if elements i and j belong to the same part, this method returns
   // the ID of the part containing the two elements; otherwise, the
@@ -92,18 +97,24 @@ public:
   // IDs of the original two parts; the old IDs are not longer valid;
   // if either one of the two element indices is out of range this
   // method returns -1
-  virtual int join(const int i, const int j);
+  virtual Index join(const Index i, const Index j);
 
   // returns the number of elements in the part containing the element
   // i; if the element index is out of range this method returns 0
-  int     getSize(const int i)           const;
+  Index   getSize(const Index i)         const;
   
 protected: // so that they accesible to SplittablePartition methods
 
-  int         _nParts;
-  vector<int> _parent;
-  vector<int> _size;
+  Index         _nParts;
+  vector<Index> _parent;
+  vector<Index> _size;
 
 };
 
+typedef PartitionT<int>     Partition;
+typedef PartitionT<int64_t> Partition64;
+
+extern template class PartitionT<int>;
+extern template class PartitionT<int64_t>;
+
 #endif /* _PARTITION_HPP_ */
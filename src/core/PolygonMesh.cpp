@@ -39,31 +39,278 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
 // DAMAGE.
 
+#include <cstdio>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <iostream>
 #include "PolygonMesh.hpp"
 #include "Partition.hpp"
+#include "ConcurrentPartition.hpp"
+#include "util/DgpFile.hpp"
+#include "util/Parallel.hpp"
+#include "io/StrException.hpp"
 
-// TODO Mon Mar 6 2023
-// - merge your code from Assignment 2
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
 
-PolygonMesh::PolygonMesh(const int nVertices, const vector<int>& coordIndex):
-  HalfEdges(nVertices,coordIndex),
+// the message is a static object, since StrException keeps a
+// reference to it
+static const string errTooManyFaces
+("PolygonMesh: twice the number of faces exceeds the range of the index type");
+static const string errTooManyEdges
+("PolygonMesh: twice the number of edges exceeds the range of the index type");
+
+// shared by the int and int64_t instantiations
+static string cacheDirectory = "";
+
+template<class Index>
+void PolygonMeshT<Index>::setCacheDirectory(const string& directory) {
+  cacheDirectory = directory;
+}
+
+template<class Index>
+const string& PolygonMeshT<Index>::getCacheDirectory() {
+  return cacheDirectory;
+}
+
+template<class Index>
+PolygonMeshT<Index>::PolygonMeshT
+(const Index nVertices, const vector<int>& coordIndex,
+ const Backend backend, const int nThreads):
+  HalfEdgesT<Index>(nVertices,coordIndex,backend,nThreads,false),
   _nPartsVertex(),
-  _isBoundaryVertex()
+  _isBoundaryVertex(),
+  _isSingularVertex(),
+  _isIsolatedVertex(),
+  _nBoundaryVertices(0),
+  _nSingularVertices(0),
+  _nIsolatedVertices(0),
+  _firstVertexCorner(),
+  _vertexCorner(),
+  _firstVertexEdge(),
+  _vertexEdge()
 {
-  int nV = getNumberOfVertices();
-  int nE = getNumberOfEdges(); // Edges method
-  // int nF = getNumberOfFaces();
-  int nC = getNumberOfCorners();
-
-  // 1) classify the vertices as boundary or internal
-  for(int iV=0;iV<nV;iV++)
-    _isBoundaryVertex.push_back(false);
-  // TODO
-  // - for edge boundary iE label its two end vertices as boundary 
+  // the tables are read from the topology cache if possible;
+  // otherwise they are computed, and written to the cache
+  string cacheFile = "";
+  uint64_t key = 0;
+  if(cacheDirectory.empty()==false) {
+    key = hashTopology(nVertices,coordIndex,nThreads);
+    // the tables of the two instantiations are stored in different
+    // files, since their sections have different types
+    char name[32];
+    snprintf(name,32,"%016llx.topo%s",static_cast<unsigned long long>(key),
+             (sizeof(Index)==8)?"64":"");
+    cacheFile = cacheDirectory+"/"+name;
+  }
+
+  if(cacheFile.empty() || _readCache(cacheFile,key)==false) {
+    _build();
+    if(cacheFile.empty()==false) _writeCache(cacheFile,key);
+  }
+
+  // the number of parts of each vertex is recomputed from the
+  // half-edge tables, so that it is always consistent with them; the
+  // vertex stars, and the vertex classification tables which depend
+  // on them, are cheaper to build than to read
+  _classifyVertices();
+  _buildVertexStars();
+  _packVertexClassification();
+}
+
+// sorts the range [i0:i1) of an array of arrays; most stars are
+// short, and insertion sort is used for them
+template<class Index>
+static void sortStar(vector<Index>& star, const Index i0, const Index i1) {
+  if(i1-i0>32) {
+    sort(star.begin()+i0,star.begin()+i1);
+    return;
+  }
+  for(Index i=i0+1;i<i1;i++) {
+    Index x = star[i], j = i;
+    for(;j>i0 && star[j-1]>x;j--) star[j] = star[j-1];
+    star[j] = x;
+  }
+}
+
+// fills the vertex->corner and vertex->edge arrays of arrays
+// - with one thread the elements of each star are inserted in
+//   increasing order
+// - with multiple threads the counts and the insertions are done with
+//   atomic increments, and each star is sorted afterwards, so that the
+//   result does not depend on the number of threads
+template<class Index>
+void PolygonMeshT<Index>::_buildVertexStars() {
+  const Index nV = getNumberOfVertices();
+  const Index nE = getNumberOfEdges();
+  const Index nC = getNumberOfCorners();
+
+  // vertex->edge values are edge indices, and there are 2*nE of them
+  if(static_cast<size_t>(nE)>
+     static_cast<size_t>(numeric_limits<Index>::max()/2))
+    throw new StrException(errTooManyEdges);
+
+  _firstVertexCorner.assign(nV+1,0);
+  _firstVertexEdge.assign(nV+1,0);
+
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nC,1<<14);
+  if(nT<=1) {
+    Index iC,iE,iV;
+    for(iC=0;iC<nC;iC++)
+      if((iV=_coordIndex[iC])>=0 && iV<nV) _firstVertexCorner[iV+1]++;
+    for(iE=0;iE<nE;iE++) {
+      _firstVertexEdge[getVertex0(iE)+1]++;
+      _firstVertexEdge[getVertex1(iE)+1]++;
+    }
+    Parallel::prefixSum(_firstVertexCorner,1);
+    Parallel::prefixSum(_firstVertexEdge,1);
+    _vertexCorner.resize(_firstVertexCorner[nV]);
+    _vertexEdge.resize(_firstVertexEdge[nV]);
+    vector<Index> pos(_firstVertexCorner.begin(),_firstVertexCorner.end()-1);
+    for(iC=0;iC<nC;iC++)
+      if((iV=_coordIndex[iC])>=0 && iV<nV) _vertexCorner[pos[iV]++] = iC;
+    pos.assign(_firstVertexEdge.begin(),_firstVertexEdge.end()-1);
+    for(iE=0;iE<nE;iE++) {
+      iV = getVertex0(iE); _vertexEdge[pos[iV]++] = iE;
+      iV = getVertex1(iE); _vertexEdge[pos[iV]++] = iE;
+    }
+    return;
+  }
+
+  const int nTE = Parallel::getNumberOfThreads(nT,nE,1<<14);
+  const int nTV = Parallel::getNumberOfThreads(nT,nV,1<<14);
+
+  // 1) count
+  unique_ptr<atomic<Index>[]> nVC(new atomic<Index>[nV]());
+  unique_ptr<atomic<Index>[]> nVE(new atomic<Index>[nV]());
+  Parallel::forEachRange(nT,nC,[&](int, size_t i0, size_t i1) {
+      Index iV;
+      for(size_t iC=i0;iC<i1;iC++)
+        if((iV=_coordIndex[iC])>=0 && iV<nV)
+          nVC[iV].fetch_add(1,memory_order_relaxed);
+    });
+  Parallel::forEachRange(nTE,nE,[&](int, size_t i0, size_t i1) {
+      for(size_t iE=i0;iE<i1;iE++) {
+        nVE[getVertex0(static_cast<Index>(iE))]
+          .fetch_add(1,memory_order_relaxed);
+        nVE[getVertex1(static_cast<Index>(iE))]
+          .fetch_add(1,memory_order_relaxed);
+      }
+    });
+
+  // 2) offsets; the counters are reset to be used as insertion points
+  Parallel::forEachRange(nTV,nV,[&](int, size_t i0, size_t i1) {
+      for(size_t iV=i0;iV<i1;iV++) {
+        _firstVertexCorner[iV+1] = nVC[iV].exchange(0,memory_order_relaxed);
+        _firstVertexEdge[iV+1]   = nVE[iV].exchange(0,memory_order_relaxed);
+      }
+    });
+  Parallel::prefixSum(_firstVertexCorner,nT);
+  Parallel::prefixSum(_firstVertexEdge,nT);
+  _vertexCorner.resize(_firstVertexCorner[nV]);
+  _vertexEdge.resize(_firstVertexEdge[nV]);
+
+  // 3) insert
+  Parallel::forEachRange(nT,nC,[&](int, size_t i0, size_t i1) {
+      Index iV;
+      for(size_t iC=i0;iC<i1;iC++)
+        if((iV=_coordIndex[iC])>=0 && iV<nV)
+          _vertexCorner[_firstVertexCorner[iV]+
+                        nVC[iV].fetch_add(1,memory_order_relaxed)] =
+            static_cast<Index>(iC);
+    });
+  Parallel::forEachRange(nTE,nE,[&](int, size_t i0, size_t i1) {
+      Index iV;
+      for(size_t iE=i0;iE<i1;iE++) {
+        iV = getVertex0(static_cast<Index>(iE));
+        _vertexEdge[_firstVertexEdge[iV]+nVE[iV].fetch_add(1,memory_order_relaxed)] =
+          static_cast<Index>(iE);
+        iV = getVertex1(static_cast<Index>(iE));
+        _vertexEdge[_firstVertexEdge[iV]+nVE[iV].fetch_add(1,memory_order_relaxed)] =
+          static_cast<Index>(iE);
+      }
+    });
+
+  // 4) restore the increasing order within each star
+  Parallel::forEachRange(nTV,nV,[&](int, size_t i0, size_t i1) {
+      for(size_t iV=i0;iV<i1;iV++) {
+        sortStar(_vertexCorner,_firstVertexCorner[iV],_firstVertexCorner[iV+1]);
+        sortStar(_vertexEdge,_firstVertexEdge[iV],_firstVertexEdge[iV+1]);
+      }
+    });
+}
+
+// fills the vertex classification tables
+// - a vertex is boundary if one of its edges is a boundary edge,
+//   singular if its corners form more than one part, and isolated if
+//   it has no corners
+// - the words of the arrays of bits are split amongst the threads,
+//   so that each word is written by a single thread
+template<class Index>
+void PolygonMeshT<Index>::_packVertexClassification() {
+  const Index nV = getNumberOfVertices();
+  _isBoundaryVertex.resize(nV);
+  _isSingularVertex.resize(nV);
+  _isIsolatedVertex.resize(nV);
+  const size_t nW = _isBoundaryVertex.getNumberOfWords();
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nW,1<<8);
+  vector<Index> rangeCount(3*nT,0); // boundary, singular, isolated
+  Parallel::forEachRange(nT,nW,[&](int iT, size_t w0, size_t w1) {
+      for(size_t iW=w0;iW<w1;iW++) {
+        uint64_t b = 0, s = 0, z = 0;
+        const Index iV0 = static_cast<Index>(iW<<6);
+        const Index iV1 = (iV0+64<nV)?iV0+64:nV;
+        for(Index iV=iV0;iV<iV1;iV++) {
+          const uint64_t bit = static_cast<uint64_t>(1)<<(iV-iV0);
+          for(Index k=_firstVertexEdge[iV];k<_firstVertexEdge[iV+1];k++)
+            if(_isBoundaryEdge.test(_vertexEdge[k])) { b |= bit; break; }
+          if(_nPartsVertex[iV]>1) s |= bit;
+          if(_firstVertexCorner[iV+1]==_firstVertexCorner[iV]) z |= bit;
+        }
+        _isBoundaryVertex.setWord(iW,b);
+        _isSingularVertex.setWord(iW,s);
+        _isIsolatedVertex.setWord(iW,z);
+        rangeCount[3*iT  ] += BitSet::popcount(b);
+        rangeCount[3*iT+1] += BitSet::popcount(s);
+        rangeCount[3*iT+2] += BitSet::popcount(z);
+      }
+    });
+  _nBoundaryVertices = _nSingularVertices = _nIsolatedVertices = 0;
+  for(int iT=0;iT<nT;iT++) {
+    _nBoundaryVertices += rangeCount[3*iT  ];
+    _nSingularVertices += rangeCount[3*iT+1];
+    _nIsolatedVertices += rangeCount[3*iT+2];
+  }
+}
+
+template<class Index>
+void PolygonMeshT<Index>::_classifyVertices() {
+  Index nV = getNumberOfVertices();
+  Index nE = getNumberOfEdges(); // Edges method
+  // Index nF = getNumberOfFaces();
+  Index nC = getNumberOfCorners();
+
+  // 1) the vertices are classified as boundary or internal later,
+  //    by _packVertexClassification(), from the vertex stars
+
+  // with multiple threads, steps 2) to 4) are performed on a
+  // ConcurrentPartition, with the regular edges split amongst the
+  // threads; the resulting parts do not depend on the order of the
+  // join operations
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nE,1<<14);
+  if(nT>1) {
+    _countVertexPartsConcurrent(nT);
+    return;
+  }
   
   // 2) create a partition of the corners in the stack
-  Partition partition(nC);
+  PartitionT<Index> partition(nC);
   // 3) for each regular edge
   //    - get the two half edges incident to the edge
   //    - join the two pairs of corresponding corners accross the edge
@@ -93,6 +340,12 @@ PolygonMesh::PolygonMesh(const int nVertices, const vector<int>& coordIndex):
   // note that the partition will end up with the corner separators as
   // singletons, but it doesn't matter for the last step, and
   // the partition will be deleteted upon return
+  Index iE,iCpair[4];
+  for(iE=0;iE<nE;iE++) {
+    if(_getOppositeCorners(iE,iCpair)==false) continue;
+    partition.join(iCpair[0],iCpair[1]);
+    partition.join(iCpair[2],iCpair[3]);
+  }
   
   // 4) count number of parts per vertex
   //    - initialize _nPartsVertex array to 0's
@@ -101,51 +354,325 @@ PolygonMesh::PolygonMesh(const int nVertices, const vector<int>& coordIndex):
   //    - note that all the corners in each subset share a common
   //      vertex index, but multiple subsets may correspond to the
   //      same vertex index, indicating that the vertex is singular
+  _nPartsVertex.assign(nV,0);
+  Index iC,iV;
+  for(iC=0;iC<nC;iC++)
+    if((iV=_coordIndex[iC])>=0 && iV<nV && partition.find(iC)==iC)
+      _nPartsVertex[iV]++;
 }
 
-int PolygonMesh::getNumberOfFaces() const {
-  // TODO
-  return 0;
+// the header section of a cache file : version, nV, nC, and the two
+// halves of the hash key
+static const int cacheVersion = 6;
+
+template<class Index>
+static void makeCacheHeader
+(vector<Index>& header, const Index nV, const Index nC, const uint64_t key) {
+  header.resize(5);
+  header[0] = cacheVersion;
+  header[1] = nV;
+  header[2] = nC;
+  header[3] = static_cast<Index>(static_cast<uint32_t>(key));
+  header[4] = static_cast<Index>(static_cast<uint32_t>(key>>32));
+}
+
+template<class Index>
+bool PolygonMeshT<Index>::_readCache
+(const string& filename, const uint64_t key) {
+  DgpFile file;
+  if(file.open(filename.c_str())==false) return false;
+  const Index nV = getNumberOfVertices();
+  vector<Index> header,expected;
+  makeCacheHeader(expected,nV,getNumberOfCorners(),key);
+  if(file.getSection("cache.header",header)==false || header!=expected)
+    return false;
+  return _readHalfEdges(file);
 }
 
-int PolygonMesh::getNumberOfEdgeFaces(const int iE) const {
+// the file is written under a temporary name, and renamed once
+// complete, so that other processes never read a partial file; the
+// temporary name includes the process id and a per-process counter,
+// so that processes and threads writing the same key concurrently do
+// not write to the same temporary file
+template<class Index>
+bool PolygonMeshT<Index>::_writeCache
+(const string& filename, const uint64_t key) const {
+  const Index nV = getNumberOfVertices();
+  vector<Index> header,info;
+  makeCacheHeader(header,nV,getNumberOfCorners(),key);
+  DgpFile file;
+  file.addSection("cache.header",header);
+  _writeHalfEdges(file,info);
+  static atomic<unsigned> tmpCounter(0);
+  char suffix[48];
+  snprintf(suffix,48,".%ld.%u.tmp",static_cast<long>(getpid()),
+           tmpCounter.fetch_add(1));
+  const string tmpname = filename+suffix;
+  if(file.save(tmpname.c_str())==false) {
+    remove(tmpname.c_str());
+    return false;
+  }
+  if(rename(tmpname.c_str(),filename.c_str())!=0) {
+    remove(tmpname.c_str());
+    return false;
+  }
+  return true;
+}
+
+// one round of a multiply-rotate hash function
+static uint64_t hashRound(uint64_t h, const uint64_t value) {
+  h ^= value*0xC2B2AE3D27D4EB4FULL;
+  h  = (h<<31)|(h>>33);
+  return h*0x9E3779B185EBCA87ULL;
+}
+
+// the coordIndex array is split into blocks of fixed size, which are
+// hashed in parallel, and the block hashes are combined in order, so
+// that the result does not depend on the number of threads
+template<class Index>
+uint64_t PolygonMeshT<Index>::hashTopology
+(const Index nV, const vector<int>& coordIndex, const int nThreads) {
+  const size_t nC        = coordIndex.size();
+  const size_t blockSize = static_cast<size_t>(1)<<16;
+  const size_t nB        = (nC+blockSize-1)/blockSize;
+  vector<uint64_t> blockHash(nB);
+  const int nT = Parallel::getNumberOfThreads(nThreads,nB,4);
+  Parallel::forEachRange(nT,nB,[&](int, size_t b0, size_t b1) {
+      for(size_t b=b0;b<b1;b++) {
+        const size_t i1 = (nC<(b+1)*blockSize)?nC:(b+1)*blockSize;
+        uint64_t h = b+1;
+        for(size_t i=b*blockSize;i<i1;i++)
+          h = hashRound(h,static_cast<uint32_t>(coordIndex[i]));
+        blockHash[b] = h;
+      }
+    });
+  uint64_t h = hashRound(hashRound(0,static_cast<uint32_t>(nV)),nC);
+  for(size_t b=0;b<nB;b++)
+    h = hashRound(h,blockHash[b]);
+  // final mixing
+  h ^= h>>33; h *= 0xFF51AFD7ED558CCDULL;
+  h ^= h>>33; h *= 0xC4CEB9FE1A85EC53ULL;
+  h ^= h>>33;
+  return h;
+}
+
+// if iE is a regular edge, fills iCpair with the two pairs of corners
+// (iCpair[0],iCpair[1]) and (iCpair[2],iCpair[3]) which point to the
+// same vertex accross the edge, and returns true; otherwise returns
+// false
+template<class Index>
+bool PolygonMeshT<Index>::_getOppositeCorners
+(const Index iE, Index iCpair[4]) const {
+  if(isRegularEdge(iE)==false) return false;
+  Index iC00 = getEdgeHalfEdge(iE,0), iC01 = getNext(iC00);
+  Index iC10 = getEdgeHalfEdge(iE,1), iC11 = getNext(iC10);
+  if(getSrc(iC00)==getDst(iC10)) { // consistently oriented
+    iCpair[0] = iC00; iCpair[1] = iC11;
+    iCpair[2] = iC01; iCpair[3] = iC10;
+  } else { // oposite orientation
+    iCpair[0] = iC00; iCpair[1] = iC10;
+    iCpair[2] = iC01; iCpair[3] = iC11;
+  }
+  return true;
+}
+
+// steps 2) to 4) of the constructor, performed by nT threads
+template<class Index>
+void PolygonMeshT<Index>::_countVertexPartsConcurrent(const int nT) {
+  Index nV = getNumberOfVertices();
+  Index nE = getNumberOfEdges();
+  Index nC = getNumberOfCorners();
+  ConcurrentPartitionT<Index> partition(nC);
+  Parallel::forEachRange(nT,nE,[&](int, size_t i0, size_t i1) {
+      Index iCpair[4];
+      for(size_t iE=i0;iE<i1;iE++) {
+        if(_getOppositeCorners(static_cast<Index>(iE),iCpair)==false)
+          continue;
+        partition.join(iCpair[0],iCpair[1]);
+        partition.join(iCpair[2],iCpair[3]);
+      }
+    });
+  unique_ptr<atomic<Index>[]> nParts(new atomic<Index>[nV]());
+  const int nTC = Parallel::getNumberOfThreads(nT,nC,1<<14);
+  Parallel::forEachRange(nTC,nC,[&](int, size_t i0, size_t i1) {
+      Index iC,iV;
+      for(iC=static_cast<Index>(i0);iC<static_cast<Index>(i1);iC++)
+        if((iV=_coordIndex[iC])>=0 && iV<nV && partition.find(iC)==iC)
+          nParts[iV].fetch_add(1,memory_order_relaxed);
+    });
+  _nPartsVertex.resize(nV);
+  for(Index iV=0;iV<nV;iV++)
+    _nPartsVertex[iV] = nParts[iV].load(memory_order_relaxed);
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getNumberOfFaces() const {
+  return _nFaces;
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getNumberOfEdgeFaces(const Index iE) const {
   return getNumberOfEdgeHalfEdges(iE);
 }
 
-int PolygonMesh::getEdgeFace(const int iE, const int j) const {
-  // TODO
-  return -1;
+template<class Index>
+Index PolygonMeshT<Index>::getEdgeFace(const Index iE, const Index j) const {
+  return getFace(getEdgeHalfEdge(iE,j));
 }
 
-bool PolygonMesh::isEdgeFace(const int iE, const int iF) const {
-  // TODO
+template<class Index>
+bool PolygonMeshT<Index>::isEdgeFace(const Index iE, const Index iF) const {
+  if(iF<0 || iF>=getNumberOfFaces()) return false;
+  Index nEF = getNumberOfEdgeFaces(iE);
+  for(Index j=0;j<nEF;j++)
+    if(getEdgeFace(iE,j)==iF) return true;
   return false;
 }
 
 // classification of vertices
 
-bool PolygonMesh::isBoundaryVertex(const int iV) const {
-  int nV = getNumberOfVertices();
-  return (0<=iV && iV<nV)?_isBoundaryVertex[iV]:false;
+template<class Index>
+bool PolygonMeshT<Index>::isBoundaryVertex(const Index iV) const {
+  Index nV = getNumberOfVertices();
+  return (0<=iV && iV<nV)?_isBoundaryVertex.test(iV):false;
+}
+
+template<class Index>
+bool PolygonMeshT<Index>::isInternalVertex(const Index iV) const {
+  Index nV = getNumberOfVertices();
+  return (0<=iV && iV<nV)?!_isBoundaryVertex.test(iV):false;
+}
+
+template<class Index>
+bool PolygonMeshT<Index>::isSingularVertex(const Index iV) const {
+  Index nV = getNumberOfVertices();
+  return (0<=iV && iV<nV)?_isSingularVertex.test(iV):false;
 }
 
-bool PolygonMesh::isSingularVertex(const int iV) const {
-  int nV = getNumberOfVertices();
-  return (0<=iV && iV<nV && _nPartsVertex.size()>0 && _nPartsVertex[iV]>1);
+template<class Index>
+bool PolygonMeshT<Index>::isIsolatedVertex(const Index iV) const {
+  Index nV = getNumberOfVertices();
+  return (0<=iV && iV<nV)?_isIsolatedVertex.test(iV):false;
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getNumberOfBoundaryVertices() const {
+  return _nBoundaryVertices;
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getNumberOfSingularVertices() const {
+  return _nSingularVertices;
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getNumberOfIsolatedVertices() const {
+  return _nIsolatedVertices;
 }
 
 // properties of the whole mesh
 
-bool PolygonMesh::isRegular() const {
-  // TODO
-  return false;
+template<class Index>
+bool PolygonMeshT<Index>::isRegular() const {
+  return (getNumberOfSingularEdges()==0 && _nSingularVertices==0);
 }
 
-bool PolygonMesh::hasBoundary() const {
-  // TODO
-  return false;
+template<class Index>
+bool PolygonMeshT<Index>::hasBoundary() const {
+  return hasBoundaryEdges();
 }
 
+//////////////////////////////////////////////////////////////////////
+// VERTEX STARS
+
+template<class Index>
+Index PolygonMeshT<Index>::getNumberOfVertexCorners(const Index iV) const {
+  Index nV = getNumberOfVertices();
+  return (0<=iV && iV<nV)?_firstVertexCorner[iV+1]-_firstVertexCorner[iV]:0;
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getVertexCorner
+(const Index iV, const Index j) const {
+  if(j<0 || j>=getNumberOfVertexCorners(iV)) return -1;
+  return _vertexCorner[_firstVertexCorner[iV]+j];
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getVertexFace(const Index iV, const Index j) const {
+  Index iC = getVertexCorner(iV,j);
+  return (iC<0)?-1:_cornerFace(iC);
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getNumberOfVertexEdges(const Index iV) const {
+  Index nV = getNumberOfVertices();
+  return (0<=iV && iV<nV)?_firstVertexEdge[iV+1]-_firstVertexEdge[iV]:0;
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getVertexEdge(const Index iV, const Index j) const {
+  if(j<0 || j>=getNumberOfVertexEdges(iV)) return -1;
+  return _vertexEdge[_firstVertexEdge[iV]+j];
+}
+
+// same as getEdge(iV0,iV1), for valid vertex indices
+template<class Index>
+Index PolygonMeshT<Index>::_getStarEdge
+(const Index iV0, const Index iV1) const {
+  Index iV = iV0, iVother = iV1;
+  if(_firstVertexEdge[iV1+1]-_firstVertexEdge[iV1]<
+     _firstVertexEdge[iV0+1]-_firstVertexEdge[iV0]) {
+    iV = iV1; iVother = iV0;
+  }
+  for(Index k=_firstVertexEdge[iV];k<_firstVertexEdge[iV+1];k++) {
+    Index iE = _vertexEdge[k];
+    if(getVertex0(iE)==iVother || getVertex1(iE)==iVother) return iE;
+  }
+  return -1;
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getVertexNeighbor
+(const Index iV, const Index j) const {
+  Index iE = getVertexEdge(iV,j);
+  if(iE<0) return -1;
+  Index iV0 = getVertex0(iE);
+  return (iV0==iV)?getVertex1(iE):iV0;
+}
+
+// the half edge getPrev(iC) ends at the vertex of iC; if its twin
+// starts at the same vertex, the twin is the next corner of the fan
+template<class Index>
+Index PolygonMeshT<Index>::getVertexFanNext(const Index iC) const {
+  Index iCprev = getPrev(iC);
+  if(iCprev<0) return -1;
+  Index iCtwin = _twin[iCprev];
+  if(iCtwin<0 || _coordIndex[iCtwin]!=_coordIndex[iC]) return -1;
+  return iCtwin;
+}
+
+// the half edge iC starts at the vertex of iC; if its twin ends at
+// the same vertex, the corner following the twin is the previous
+// corner of the fan
+template<class Index>
+Index PolygonMeshT<Index>::getVertexFanPrev(const Index iC) const {
+  if(getSrc(iC)<0) return -1;
+  Index iCtwin = _twin[iC];
+  if(iCtwin<0 || _coordIndex[iCtwin]==_coordIndex[iC]) return -1;
+  return getNext(iCtwin);
+}
+
+template<class Index>
+Index PolygonMeshT<Index>::getVertexFanFirst(const Index iV) const {
+  Index nVC = getNumberOfVertexCorners(iV);
+  if(nVC==0 || isSingularVertex(iV)) return -1;
+  const Index* vC = _vertexCorner.data()+_firstVertexCorner[iV];
+  for(Index j=0;j<nVC;j++)
+    if(getVertexFanPrev(vC[j])<0) return vC[j];
+  return vC[0];
+}
+
 //////////////////////////////////////////////////////////////////////
 // CONNECTED COMPONENTS
 
@@ -153,30 +680,112 @@ bool PolygonMesh::hasBoundary() const {
 // - returns number of connected components nCC
 // - fills the faceLabel array with connected component number iCC
 // - for each face; 0<=iCC<nCC
-int PolygonMesh::computeConnectedComponentsPrimal(vector<int>& faceLabel) const {
-  int nCCprimal = 0;
+template<class Index>
+Index PolygonMeshT<Index>::computeConnectedComponentsPrimal
+(vector<Index>& faceLabel) const {
+  Index nCCprimal = 0;
   faceLabel.clear();
 
-  // HINTS :
-  //
   // - use the edges of the primal graph to compute a partition of the
-  //   vertices
-  //
-  // - nCC is equal to the final number of parts in the partition
-  //
+  //   vertices; since the vertices of each face are connected by the
+  //   face loop, it is sufficient to join consecutive corners of each
+  //   face, without building the edges
   // - since all the vertices of each face must belong to the the same
   //   part, there is no ambiguity in assigning connected component
-  //   numbers to the faces
-  //
-  // - to assign component numbers to the parts in the range 0<=iCC<nCC 
-  //   you can use an array vToCC of size nV initialized to -1's
-  //
-  // - first, assign component numbers to the vertices which are
-  //   representative of the parts
-  // - second, assign component numbers to all the other vertices
-  // - finally, fill the faceLabel array using the component number
-  //   associated with the first vertex of each face
-  
+  //   numbers to the faces; faces with no vertices are components
+  //   of their own
+  // - isolated vertices do not define components
+  // - components are numbered in increasing order of their first
+  //   face, with or without multiple threads
+
+  Index nV = getNumberOfVertices();
+  Index nF = getNumberOfFaces();
+  Index nC = getNumberOfCorners();
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nC,1<<14);
+
+  if(nT>1) {
+    ConcurrentPartitionT<Index> partition(nV);
+    Parallel::forEachRange(nT,nC,[&](int, size_t i0, size_t i1) {
+        Index iC,iV0,iV1;
+        for(iC=static_cast<Index>(i0);
+            iC<static_cast<Index>(i1) && iC+1<nC;iC++)
+          if((iV0=_coordIndex[iC])>=0 && (iV1=_coordIndex[iC+1])>=0)
+            partition.join(iV0,iV1);
+      });
+
+    // the part of each face is the part of its first vertex, and the
+    // first face of each part is determined with atomic min operations
+    vector<Index> facePart(nF,-1);
+    unique_ptr<atomic<Index>[]> partFirstFace(new atomic<Index>[nV]);
+    Parallel::forEachRange(nT,nV,[&](int, size_t i0, size_t i1) {
+        for(size_t iV=i0;iV<i1;iV++)
+          partFirstFace[iV].store(nF,memory_order_relaxed);
+      });
+    Parallel::forEachRange(nT,nC,[&](int, size_t i0, size_t i1) {
+        Index iC,iF,iP,iFfirst;
+        for(iC=static_cast<Index>(i0);iC<static_cast<Index>(i1);iC++) {
+          if(_coordIndex[iC]<0 || (iC>0 && _coordIndex[iC-1]>=0)) continue;
+          if((iP=partition.find(_coordIndex[iC]))<0) continue;
+          facePart[iF=_cornerFace(iC)] = iP;
+          iFfirst = partFirstFace[iP].load(memory_order_relaxed);
+          while(iF<iFfirst &&
+                !partFirstFace[iP].compare_exchange_weak
+                (iFfirst,iF,memory_order_relaxed));
+        }
+      });
+
+    // label the first faces in increasing order, and then every
+    // other face with the label of the first face of its part
+    const int nTF = Parallel::getNumberOfThreads(nT,nF,1<<14);
+    auto isFirstFace = [&](const Index iF) {
+      const Index iP = facePart[iF];
+      return (iP<0 || partFirstFace[iP].load(memory_order_relaxed)==iF);
+    };
+    vector<Index> rangeFirstLabel(nTF+1,0);
+    Parallel::forEachRange(nTF,nF,[&](int iT, size_t i0, size_t i1) {
+        Index nFirst = 0;
+        for(size_t iF=i0;iF<i1;iF++)
+          if(isFirstFace(static_cast<Index>(iF))) nFirst++;
+        rangeFirstLabel[iT+1] = nFirst;
+      });
+    Parallel::prefixSum(rangeFirstLabel,1);
+    faceLabel.resize(nF);
+    Parallel::forEachRange(nTF,nF,[&](int iT, size_t i0, size_t i1) {
+        Index iLabel = rangeFirstLabel[iT];
+        for(size_t iF=i0;iF<i1;iF++)
+          if(isFirstFace(static_cast<Index>(iF))) faceLabel[iF] = iLabel++;
+      });
+    Parallel::forEachRange(nTF,nF,[&](int, size_t i0, size_t i1) {
+        for(size_t iF=i0;iF<i1;iF++)
+          if(isFirstFace(static_cast<Index>(iF))==false)
+            faceLabel[iF] =
+              faceLabel[partFirstFace[facePart[iF]].load(memory_order_relaxed)];
+      });
+    return rangeFirstLabel[nTF];
+  }
+
+  Index iF,iC,iV0,iV1,iP;
+  PartitionT<Index> partition(nV);
+  for(iC=0;iC+1<nC;iC++)
+    if((iV0=_coordIndex[iC])>=0 && iV0<nV &&
+       (iV1=_coordIndex[iC+1])>=0 && iV1<nV)
+      partition.join(iV0,iV1);
+
+  // the part of each face is the part of its first vertex
+  faceLabel.assign(nF,-1);
+  for(iC=0;iC<nC;iC++)
+    if(_coordIndex[iC]>=0 && (iC==0 || _coordIndex[iC-1]<0))
+      faceLabel[_cornerFace(iC)] = partition.find(_coordIndex[iC]);
+  vector<Index> partLabel(nV,-1);
+  for(iF=0;iF<nF;iF++) {
+    if((iP=faceLabel[iF])<0) { // face with no vertices
+      faceLabel[iF] = nCCprimal++;
+    } else {
+      if(partLabel[iP]<0) partLabel[iP] = nCCprimal++;
+      faceLabel[iF] = partLabel[iP];
+    }
+  }
+
   return nCCprimal;
 }
 
@@ -184,25 +793,48 @@ int PolygonMesh::computeConnectedComponentsPrimal(vector<int>& faceLabel) const
 // - returns number of connected components nCC
 // - fills the faceLabel array with connected component number iCC
 // - for each face; 0<=iCC<nCC
-int PolygonMesh::computeConnectedComponentsDual(vector<int>& faceLabel) const {
-  int nCCdual = 0;
+template<class Index>
+Index PolygonMeshT<Index>::computeConnectedComponentsDual
+(vector<Index>& faceLabel) const {
+  Index nCCdual = 0;
   faceLabel.clear();
 
-  int iF,iFt,iFR,iC0,iC1,iC,iCt,iP;
-
-  // HINTS :
-  //
   // - use the edges of the dual graph to compute a partition of the
-  //   vertices
-  //
-  // - you can generate the dual graph explicitly, or just traverse
-  //   the half edges looking for regular edges
-  //
+  //   faces
+  // - traverse the half edges looking for regular edges, i.e., for
+  //   half edges with twins
   // - nCC is equal to the final number of parts in the partition
-  //
-  // - component number assignment is similar to the primal case, but
-  //   easier here, since there is no need to transfer from vertices
-  //   to faces
+  // - components are numbered in increasing order of their first
+  //   face, with or without multiple threads
+
+  Index nF = getNumberOfFaces();
+  Index nC = getNumberOfCorners();
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nC,1<<14);
+
+  if(nT>1) {
+    ConcurrentPartitionT<Index> partition(nF);
+    Parallel::forEachRange(nT,nC,[&](int, size_t i0, size_t i1) {
+        Index iC,iCt;
+        for(iC=static_cast<Index>(i0);iC<static_cast<Index>(i1);iC++)
+          if((iCt=_twin[iC])>iC)
+            partition.join(_cornerFace(iC),_cornerFace(iCt));
+      });
+    return partition.getPartLabels(faceLabel,nT);
+  }
+
+  Index iF,iC,iCt,iP;
+  PartitionT<Index> partition(nF);
+  for(iC=0;iC<nC;iC++)
+    if((iCt=_twin[iC])>iC)
+      partition.join(_cornerFace(iC),_cornerFace(iCt));
+
+  vector<Index> partLabel(nF,-1);
+  faceLabel.resize(nF);
+  for(iF=0;iF<nF;iF++) {
+    iP = partition.find(iF);
+    if(partLabel[iP]<0) partLabel[iP] = nCCdual++;
+    faceLabel[iF] = partLabel[iP];
+  }
   
   return nCCdual;
 }
@@ -215,20 +847,80 @@ int PolygonMesh::computeConnectedComponentsDual(vector<int>& faceLabel) const {
 // - note that isolated singular vertices play no role in this
 //   definition (since cuting through them does not affect
 //   orientation)
-bool PolygonMesh::isOriented() const {
+template<class Index>
+bool PolygonMeshT<Index>::isOriented() const {
   if(hasSingularEdges()) return false;
 
-  // HINTS :
-  //
-  // - traverse the list of half edges, and check whether or not the
-  //   regualr edges are consistently oriented
-  // - as soon as you find one edge which is not consistently oriented
-  //   you can reurn false
-  // - if no inconsistently oriented edge is found, return true
+  // the half edges are split amongst the threads; each thread stops
+  // as soon as it finds one regular edge which is not consistently
+  // oriented; since twin half edges join the same two vertices, they
+  // are consistently oriented if and only if their sources differ
+  const Index nC = getNumberOfCorners();
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nC,1<<14);
+  vector<int> oriented(nT,1);
+  Parallel::forEachRange(nT,nC,[&](int iT, size_t i0, size_t i1) {
+      Index iC,iCt;
+      for(iC=static_cast<Index>(i0);iC<static_cast<Index>(i1);iC++)
+        if((iCt=_twin[iC])>iC && _coordIndex[iC]==_coordIndex[iCt]) {
+          oriented[iT] = 0;
+          break;
+        }
+    });
+  for(int iT=0;iT<nT;iT++)
+    if(oriented[iT]==0) return false;
+  return true;
+}
 
+// the orientation of the faces is determined with a partition of the
+// 2*nF elements {2*iF,2*iF+1}, where 2*iF stands for face iF with its
+// original orientation, and 2*iF+1 for face iF inverted; for each
+// regular edge, the two pairs of elements which result in the two
+// incident faces being consistently oriented are joined; the join
+// operations are split amongst nT threads
+// - the mesh is orientable if and only if 2*iF and 2*iF+1 end up in
+//   different parts, for every face iF
+// - in that case each connected component of the dual graph results
+//   in exactly two parts, one the inverse of the other; since the ID
+//   of a part of a ConcurrentPartition is its smallest element, the
+//   ID of one of them is 2*iF0, where iF0 is the first face of the
+//   connected component, and the ID of the other one is 2*iF0+1
+// returns false if the mesh is not orientable
+template<class Index>
+bool PolygonMeshT<Index>::_joinFaceOrientations
+(ConcurrentPartitionT<Index>& partition, const int nT) const {
+  const Index nC = getNumberOfCorners();
+  const Index nF = getNumberOfFaces();
+  const int nTC = Parallel::getNumberOfThreads(nT,nC,1<<14);
+  Parallel::forEachRange(nTC,nC,[&](int, size_t i0, size_t i1) {
+      Index iC,iCt,iF,iFt;
+      for(iC=static_cast<Index>(i0);iC<static_cast<Index>(i1);iC++) {
+        if((iCt=_twin[iC])<=iC) continue;
+        iF  = _cornerFace(iC);
+        iFt = _cornerFace(iCt);
+        if(_coordIndex[iC]!=_coordIndex[iCt]) { // consistently oriented
+          partition.join(2*iF  ,2*iFt  );
+          partition.join(2*iF+1,2*iFt+1);
+        } else { // one of the two faces has to be inverted
+          partition.join(2*iF  ,2*iFt+1);
+          partition.join(2*iF+1,2*iFt  );
+        }
+      }
+    });
+  const int nTF = Parallel::getNumberOfThreads(nT,nF,1<<14);
+  vector<int> orientable(nTF,1);
+  Parallel::forEachRange(nTF,nF,[&](int iT, size_t i0, size_t i1) {
+      Index iF;
+      for(iF=static_cast<Index>(i0);iF<static_cast<Index>(i1);iF++)
+        if(partition.find(2*iF)==partition.find(2*iF+1)) {
+          orientable[iT] = 0;
+          break;
+        }
+    });
+  for(int iT=0;iT<nTF;iT++)
+    if(orientable[iT]==0) return false;
   return true;
 }
-
+
 // determines if the mesh is orientable
 // - a mesh is orientable if a choice of orientation can be made for
 //   each face so that, after the face orientation changes are made,
@@ -237,58 +929,27 @@ bool PolygonMesh::isOriented() const {
 // - note that isolated singular vertices play no role in this
 //   definition (since cuting through them does not affect
 //   orientation)
-bool PolygonMesh::isOrientable() const {
+template<class Index>
+bool PolygonMeshT<Index>::isOrientable() const {
   if(hasSingularEdges()) return false;
   if(isOriented()) return true;
   // here the mesh is not oriented but only has regular and boundary edges
-
-  // you need to implement a mesh traversal algorithm using these variables
-
-  int nC = getNumberOfCorners();
-  int nF = getNumberOfFaces();
-  vector<bool> face_was_visited(nF,false);
-  vector<bool> invert_face(nF,false);
-  vector<int> face_root;
-  vector<int> corner_stack;
-
-  // pseudo-code
-  //
-  // while (not all the faces have been visited) {
-  //  - select a root face iF_root
-  //  - set the face as visited, and preserve its original orientation  
-  //    push all the half edge indices of the face onto the corner_stack
-  //  while ( the corner_stack is not empty) {
-  //   - pop a half edge index iC until you find one which has a twin
-  //     iCt contained in a face iFt; let iF be the face containing iC
-  //   - determine whether or not iFt should be inverted if the edge
-  //     is crossed to make the two half edges consistently oriented
-  //   if (the face iFt had been visited before) {
-  //     if ( the computed expected orientation is different from the
-  //          one assigned on the first visit) {
-  //       - we have found a loop in the dual graph which cannot be
-  //         oriented; as a result, the mesh is not oriented
-  //       - return false;
-  //      }
-  //    } else if (the face iFt had not been visited before) {
-  //      - save the computed expected orientation in the invert_face array
-  //      - push all the remaining half edges of the face iFt onto the corner_stack
-  //    }
-  //   - this is the end of the connected component in the dual graph
-  //     containing iF_root
-  //   - if not all the faces have been visited, we can repeat until
-  //     all the connected components are accounted for }
-  //  }
-
-  return true;
+  if(getNumberOfFaces()>numeric_limits<Index>::max()/2)
+    throw new StrException(errTooManyFaces);
+  const int nT = Parallel::getNumberOfThreads(_nThreads,getNumberOfCorners(),1<<14);
+  ConcurrentPartitionT<Index> partition(2*getNumberOfFaces());
+  return _joinFaceOrientations(partition,nT);
 }
-
+
 // orient
-// - implementation requires a dual graph traversal algorithm
 // - the number of connected components nCC of the dual graph are
 //   determined as a by product
-// - if multiple orientations are posible choose one
+// - if multiple orientations are posible, the first face of each
+//   connected component preserves its orientation
 // - fills the ccIndex array, of size equal to the number of faces
-//   nF, with the connected component number iCC assigned to each face
+//   nF, with the connected component number iCC assigned to each
+//   face; the components are numbered in increasing order of their
+//   first face, as in computeConnectedComponentsDual()
 // - the values stored in the ccIndex shold be in the range 0<=iCC<nCC
 // - fills the output invert_face, with values required to produce
 //   an oriented mesh
@@ -297,53 +958,176 @@ bool PolygonMesh::isOrientable() const {
 // - returns the number of connected components nCC if successful,
 //   and 0 if the mesh is not orientable
 // - if not successful, the output arrays should be empty as well
-int PolygonMesh::orient(vector<int>& ccIndex, vector<bool>& invert_face) {
-  int nCC = 0;
+template<class Index>
+Index PolygonMeshT<Index>::orient
+(vector<Index>& ccIndex, vector<bool>& invert_face) {
   ccIndex.clear();
   invert_face.clear();
   if(hasSingularEdges()) return 0;
-  // if(isOriented()) return true;
-  // mesh is not oriented but only has regular and boundary edges
-  int nC = getNumberOfCorners();
-  int nF = getNumberOfFaces();
-  vector<bool> face_was_visited(nF,false);
-  vector<int>& face_root = ccIndex;
-  vector<int> corner_stack;
+  // note that we cannot return right away if isOriented()==true since
+  // we need to partition the faces into connected components, and
+  // fill the ccIndex and invert_face arrays
+  const Index nF = getNumberOfFaces();
+  if(nF>numeric_limits<Index>::max()/2)
+    throw new StrException(errTooManyFaces);
+  const int nT = Parallel::getNumberOfThreads(_nThreads,getNumberOfCorners(),1<<14);
+  ConcurrentPartitionT<Index> partition(2*nF);
+  if(_joinFaceOrientations(partition,nT)==false) return 0;
 
-  // HINTS :
-  //
-  // - a minor variation of isOrientable()
-  // - note that you cannot return right away if isOriented()==true
-  //   since we need to partition the faces into connected components,
-  //   and fill the ccIndex and invert_face array
-
-  return nCC;
+  // the two parts of each connected component get consecutive labels
+  // 2*iCC and 2*iCC+1, the first one for the part containing the
+  // first face of the component with its original orientation
+  vector<Index> label;
+  const Index nParts = partition.getPartLabels(label,nT);
+  ccIndex.resize(nF);
+  invert_face.resize(nF);
+  for(Index iF=0;iF<nF;iF++) {
+    ccIndex[iF]     = label[2*iF]/2;
+    invert_face[iF] = (label[2*iF]%2!=0);
+  }
+  return nParts/2;
 }
-
+
 //////////////////////////////////////////////////////////////////////
-// MANIFOLD
+// INCREMENTAL UPDATES
 
-// determine how many isolated vertices the mesh has
-int PolygonMesh::numberOfIsolatedVertices() {
-  int nV_isolated = 0;
+template<class Index>
+bool PolygonMeshT<Index>::updateFlippedFaces(const vector<bool>& flipped) {
+  vector<Index> faceCorner;
+  if(_getFaceCorners(flipped,faceCorner)==false) return false;
+  if(faceCorner.empty()) return true;
 
-  // HINTS :
-  //
-  // - isolated vertices are those not contained in the coordIndex array
-  // - it is sufficient to count how many faces are incident to each vertex 
+  // the vertex and the edge of each corner of the flipped faces; the
+  // edges are looked up in the shorter one of the two vertex stars,
+  // rather than with getEdge(), which is linear in the valence of
+  // the first vertex for the LINKED_LIST backend
+  const Index nV = getNumberOfVertices();
+  vector< pair<Index,Index> > vertexCorner,edgeCorner;
+  vertexCorner.reserve(faceCorner.size());
+  edgeCorner.reserve(faceCorner.size());
+  for(const Index iC : faceCorner) {
+    Index iV0 = _coordIndex[iC];
+    Index iV1 = _coordIndex[getNext(iC)];
+    if(iV0<0 || iV0>=nV || iV1<0 || iV1>=nV) return false;
+    vertexCorner.push_back(make_pair(iV0,iC));
+    if(iV0==iV1) continue;
+    Index iE = _getStarEdge(iV0,iV1);
+    if(iE<0) return false;
+    edgeCorner.push_back(make_pair(iE,iC));
+  }
+  sort(vertexCorner.begin(),vertexCorner.end());
+  sort(edgeCorner.begin(),edgeCorner.end());
+
+  // the vertex stars are checked before the half-edge tables are
+  // modified
+  if(_patchCornerLists(_firstVertexCorner,_vertexCorner,vertexCorner,
+                       flipped,false)==false)
+    return false;
+  if(_updateFlippedFaces(flipped,faceCorner,edgeCorner)==false)
+    return false;
+  _patchCornerLists(_firstVertexCorner,_vertexCorner,vertexCorner,
+                    flipped,true);
 
-  return nV_isolated;
+  // the parts of the corners of each vertex, and so the vertex
+  // classification, do not depend on the orientation of the faces
+  return true;
 }
 
-// get array of isolated vertex indices
-void PolygonMesh::getIsolatedVertices(vector<int>& isolated_vertex) {
-  isolated_vertex.clear();
+template<class Index>
+bool PolygonMeshT<Index>::updateRemovedVertices
+(const vector<Index>& coordMap) {
+  const Index nV    = getNumberOfVertices();
+  const Index nVout = static_cast<Index>(coordMap.size());
+  if(nVout>nV) return false;
 
-  // HINTS :
-  //
-  // - same as the previous method, but returning the indices of the
-  //   isolated vertices in an array
+  // only isolated vertices can be removed
+  vector<Index> vMap(nV,-1);
+  Index iV,iVout;
+  for(iVout=0;iVout<nVout;iVout++) {
+    iV = coordMap[iVout];
+    if(iV<0 || iV>=nV || vMap[iV]>=0) return false;
+    vMap[iV] = iVout;
+  }
+  for(iV=0;iV<nV;iV++)
+    if(vMap[iV]<0 && _isIsolatedVertex.test(iV)==false) return false;
 
+  // the coordIndex array must have been renumbered by coordMap: the
+  // number of corners holding a vertex index must not change, all
+  // the values must be below nVout, and each corner in the star of a
+  // vertex iV must now hold vMap[iV]; since the stars partition the
+  // vertex corners, and the stars of the removed vertices are empty,
+  // this also checks that the vertex classification does not change
+  const Index nC = getNumberOfCorners();
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nC,1<<14);
+  vector<int> isValid(nT,1);
+  vector<Index> rangeCount(nT,0);
+  Parallel::forEachRange(nT,nC,[&](int iT, size_t i0, size_t i1) {
+      Index nVertexCorners = 0;
+      for(size_t iC=i0;iC<i1;iC++) {
+        const Index iVc = _coordIndex[iC];
+        if(iVc>=nVout) { isValid[iT] = 0; return; }
+        if(iVc>=0) nVertexCorners++;
+      }
+      rangeCount[iT] = nVertexCorners;
+    });
+  Index nVertexCorners = 0;
+  for(int iT=0;iT<nT;iT++) {
+    if(isValid[iT]==0) return false;
+    nVertexCorners += rangeCount[iT];
+  }
+  if(nVertexCorners!=_firstVertexCorner[nV]) return false;
+  const int nTV = Parallel::getNumberOfThreads(_nThreads,nV,1<<12);
+  isValid.assign(nTV,1);
+  Parallel::forEachRange(nTV,nV,[&](int iT, size_t i0, size_t i1) {
+      for(size_t jV=i0;jV<i1;jV++)
+        for(Index k=_firstVertexCorner[jV];k<_firstVertexCorner[jV+1];k++)
+          if(_coordIndex[_vertexCorner[k]]!=vMap[jV]) {
+            isValid[iT] = 0; return;
+          }
+    });
+  for(int iT=0;iT<nTV;iT++)
+    if(isValid[iT]==0) return false;
+
+  // the edge table checks that coordMap is increasing
+  if(_renumberVertices(nVout,vMap,_nThreads)==false) return false;
+
+  // the stars of the isolated vertices are empty, and the stars of
+  // the other vertices keep their order; the corner and edge indices
+  // do not change
+  vector<Index> firstVertexCorner(nVout+1),firstVertexEdge(nVout+1);
+  vector<Index> nPartsVertex(nVout);
+  for(iVout=0;iVout<nVout;iVout++) {
+    iV = coordMap[iVout];
+    firstVertexCorner[iVout] = _firstVertexCorner[iV];
+    firstVertexEdge[iVout]   = _firstVertexEdge[iV];
+    nPartsVertex[iVout]      = _nPartsVertex[iV];
+  }
+  firstVertexCorner[nVout] = _firstVertexCorner[nV];
+  firstVertexEdge[nVout]   = _firstVertexEdge[nV];
+  _firstVertexCorner.swap(firstVertexCorner);
+  _firstVertexEdge.swap(firstVertexEdge);
+  _nPartsVertex.swap(nPartsVertex);
+
+  _packVertexClassification();
+  return true;
+}
+
+//////////////////////////////////////////////////////////////////////
+// MANIFOLD
+
+// determine how many isolated vertices the mesh has
+// - isolated vertices are those not contained in the coordIndex
+//   array; they are counted by the constructor
+template<class Index>
+Index PolygonMeshT<Index>::numberOfIsolatedVertices() {
+  return _nIsolatedVertices;
+}
+
+// get array of isolated vertex indices
+template<class Index>
+void PolygonMeshT<Index>::getIsolatedVertices
+(vector<Index>& isolated_vertex) {
+  _isIsolatedVertex.getIndices(isolated_vertex);
 }
 
 // remove isolated vertices
@@ -357,26 +1141,49 @@ void PolygonMesh::getIsolatedVertices(vector<int>& isolated_vertex) {
 // - the output coordIndexOut should be of the same size as the
 //   input coordIndex array
 // - returns true if one or more isolated vertices have been removed,
-//   and false if no isolated vertices have been found
-// - if no isolated vertices are found, the output arrays should be
-//   empty as well
-bool PolygonMesh::removeIsolatedVertices
-(vector<int>& coordMap, vector<int>& coordIndexOut) {
+//   and false if no isolated vertices have been found, or if a value
+//   of coordIndex is out of range
+// - if false is returned, the output arrays should be empty as well
+template<class Index>
+bool PolygonMeshT<Index>::removeIsolatedVertices
+(vector<Index>& coordMap, vector<int>& coordIndexOut) {
   coordMap.clear();
   coordIndexOut.clear();
+  if(_nIsolatedVertices==0) return false;
 
-  // HINTS :
-  //
-  // - determine which vertices are not isolated, and fill the coordMap
-  //   array with them
-  // - build another array of size nV, initialized to -1's
-  //   where you store the location of each non-isolated vertex in the
-  //   coordMap array
-  // - use this array to fill the coordIndexOut array from coordIndex
+  // the isolated vertices have been determined by the constructor
+  const Index nV = getNumberOfVertices();
+  vector<Index> vMap(nV,-1);
+  coordMap.reserve(nV-_nIsolatedVertices);
+  for(Index iV=0;iV<nV;iV++) {
+    if(_isIsolatedVertex.test(iV)) continue;
+    vMap[iV] = static_cast<Index>(coordMap.size());
+    coordMap.push_back(iV);
+  }
 
+  // a vertex index out of range cannot be mapped, and the mesh is
+  // rejected, as in updateRemovedVertices()
+  const Index nC = getNumberOfCorners();
+  coordIndexOut.resize(nC);
+  const int nT = Parallel::getNumberOfThreads(_nThreads,nC,1<<14);
+  vector<int> isValid(nT,1);
+  Parallel::forEachRange(nT,nC,[&](int iT, size_t i0, size_t i1) {
+      for(size_t iC=i0;iC<i1;iC++) {
+        Index iV = _coordIndex[iC];
+        if(iV>=nV) { isValid[iT] = 0; return; }
+        coordIndexOut[iC] = (iV<0)?-1:static_cast<int>(vMap[iV]);
+      }
+    });
+  for(int iT=0;iT<nT;iT++) {
+    if(isValid[iT]==0) {
+      coordMap.clear();
+      coordIndexOut.clear();
+      return false;
+    }
+  }
   return true;
 }
-
+
 // cut through singular vertices
 // - should only cut through singular vertices which belong to
 //   different connected components of the dual graph
@@ -394,8 +1201,9 @@ bool PolygonMesh::removeIsolatedVertices
 //   indices in the output range 0<=iVout<nVout
 // - the output coordIndexOut should be of the same size as the
 //   input coordIndex array
-void PolygonMesh::cutThroughSingularVertices
-(vector<int>& vIndexMap, vector<int>& coordIndexOut) {
+template<class Index>
+void PolygonMeshT<Index>::cutThroughSingularVertices
+(vector<Index>& vIndexMap, vector<int>& coordIndexOut) {
   vIndexMap.clear();
   coordIndexOut.clear();
 
@@ -447,8 +1255,9 @@ void PolygonMesh::cutThroughSingularVertices
 // - the output coordIndexOut should be of the same size as the
 //   input coordIndex array
 
-void PolygonMesh::convertToManifold
-(vector<int>& vIndexMap, vector<int>& coordIndexOut) {
+template<class Index>
+void PolygonMeshT<Index>::convertToManifold
+(vector<Index>& vIndexMap, vector<int>& coordIndexOut) {
   bool success = false;
   vIndexMap.clear();
   coordIndexOut.clear();
@@ -464,3 +1273,6 @@ void PolygonMesh::convertToManifold
   // - to prevent these problems the orient() method should be calle
   // - before this one
 }
+
+template class PolygonMeshT<int>;
+template class PolygonMeshT<int64_t>;
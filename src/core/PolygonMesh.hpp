@@ -42,72 +42,147 @@
 #ifndef _POLYGON_MESH_HPP_
 #define _POLYGON_MESH_HPP_
 
+#include <cstdint>
+#include <string>
 #include <vector>
 #include "HalfEdges.hpp"
 
 using namespace std;
 
-class PolygonMesh : public HalfEdges {
+template<class Index> class ConcurrentPartitionT;
+
+template<class Index>
+class PolygonMeshT : public HalfEdgesT<Index> {
 
 public:
 
   // inherits from Edges
   //
-  // void    reset(const int nV);
-  // int     getNumberOfVertices()                     const;
-  // int     getNumberOfEdges()                        const;
-  // int     getEdge(const int iV0, const int iV1)     const;
-  // int     getVertex0(const int iE)                  const;
-  // int     getVertex1(const int iE)                  const;
+  // void    reset(const Index nV);
+  // Index   getNumberOfVertices()                     const;
+  // Index   getNumberOfEdges()                        const;
+  // Index   getEdge(const Index iV0, const Index iV1) const;
+  // Index   getVertex0(const Index iE)                const;
+  // Index   getVertex1(const Index iE)                const;
 
   // inherits from HalfEdges
   //
-  // int     getNumberOfCorners();
-  // int     getFace(const int iC) const;
-  // int     getSrc(const int iC) const;
-  // int     getDst(const int iC) const;
-  // int     getNext(const int iC) const;
-  // int     getPrev(const int iC) const;
-  // int     getTwin(const int iC) const;
-  // int     getNumberOfFaceEdges(const int iE);
-
-             PolygonMesh(const int nV, const vector<int>& coordIndex);
+  // Index   getNumberOfCorners();
+  // Index   getFace(const Index iC) const;
+  // Index   getSrc(const Index iC) const;
+  // Index   getDst(const Index iC) const;
+  // Index   getNext(const Index iC) const;
+  // Index   getPrev(const Index iC) const;
+  // Index   getTwin(const Index iC) const;
+  // Index   getNumberOfFaceEdges(const Index iE);
+
+  // the Index type of the vertices, edges, corners and faces is int
+  // or int64_t; PolygonMesh is the int instantiation, and
+  // PolygonMesh64 the one for meshes with 2^31 or more corners; both
+  // are compiled in PolygonMesh.cpp; the vertex indices stored in the
+  // coordIndex array are int values in either case
+
+  typedef EdgesBase::Backend Backend;
+
+  using HalfEdgesT<Index>::getNumberOfVertices;
+  using HalfEdgesT<Index>::getNumberOfEdges;
+  using HalfEdgesT<Index>::getEdge;
+  using HalfEdgesT<Index>::getVertex0;
+  using HalfEdgesT<Index>::getVertex1;
+  using HalfEdgesT<Index>::getNumberOfCorners;
+  using HalfEdgesT<Index>::getFace;
+  using HalfEdgesT<Index>::getSrc;
+  using HalfEdgesT<Index>::getDst;
+  using HalfEdgesT<Index>::getNext;
+  using HalfEdgesT<Index>::getPrev;
+  using HalfEdgesT<Index>::getTwin;
+  using HalfEdgesT<Index>::getNumberOfEdgeHalfEdges;
+  using HalfEdgesT<Index>::getEdgeHalfEdge;
+  using HalfEdgesT<Index>::isRegularEdge;
+  using HalfEdgesT<Index>::hasBoundaryEdges;
+  using HalfEdgesT<Index>::hasSingularEdges;
+  using HalfEdgesT<Index>::getNumberOfSingularEdges;
+
+  // see the HalfEdges constructor for the meaning of the backend and
+  // nThreads arguments
+
+             PolygonMeshT(const Index nV, const vector<int>& coordIndex,
+                          const Backend backend=EdgesBase::LINKED_LIST,
+                          const int nThreads=0);
+
+  // TOPOLOGY CACHE
+
+  // if a cache directory is set, the constructor looks in it for a
+  // file named after the hashTopology() key of its arguments, with
+  // the suffix .topo, or .topo64 for PolygonMesh64; if the
+  // file is found, and its contents match the arguments, the edge and
+  // half-edge tables are read from it, rather than computed; the
+  // number of parts of each vertex, and the edge and vertex
+  // classifications, are recomputed from them; otherwise the tables
+  // are computed, and written to the file; an empty directory name
+  // disables the cache, which is the default; the directory is
+  // shared by the two instantiations
+
+  static void          setCacheDirectory(const string& directory);
+  static const string& getCacheDirectory();
+
+  // 64-bit content hash of the number of vertices and of the
+  // coordIndex array; it does not depend on the number of threads
+
+  static uint64_t      hashTopology(const Index nV,
+                                    const vector<int>& coordIndex,
+                                    const int nThreads=0);
 
   // number of -1's in the coordIndex argument
 
-     int     getNumberOfFaces()                        const;
+     Index   getNumberOfFaces()                        const;
 
   // number of faces incident to each edge; note that this is equal to
   // the number of half edges incident to each edge
 
-     int     getNumberOfEdgeFaces(const int iE)        const;
+     Index   getNumberOfEdgeFaces(const Index iE)      const;
 
   // if the arguments fall within their respective ranges, this method
   // returns the j-th face in the list of faces incident to the edge
   // iE; and it returns -1 if either argument is out of range
 
-     int     getEdgeFace(const int iE, const int j)    const;
+     Index   getEdgeFace(const Index iE, const Index j) const;
 
   // if the arguments fall within their respective ranges, this method
   // returns returns true if iF is found in the list of faces incident
   // to the edge iE; otherwise it returns false
 
-     bool    isEdgeFace(const int iE, const int iF)    const;
+     bool    isEdgeFace(const Index iE, const Index iF) const;
 
   // a vertex is boundary if and only if it is the end of a boundary
   // edge
 
-     bool    isBoundaryVertex(const int iV)            const;
+     bool    isBoundaryVertex(const Index iV)          const;
 
   // a vertex is internal if and only if it is not a boundary edge
 
-     bool    isInternalVertex(const int iV)            const;
+     bool    isInternalVertex(const Index iV)          const;
 
   // a vertex is singular if the number of connected components in the
   // subgraph of the dual graph defined by the subset of faces
   // incident to the vertex is larger than 1; otherwise it is regular
 
-     bool    isSingularVertex(const int iV)            const;
+     bool    isSingularVertex(const Index iV)          const;
+
+  // a vertex is isolated if it is not referenced by the coordIndex
+  // array
+
+     bool    isIsolatedVertex(const Index iV)          const;
+
+  // the vertices are classified by the constructor into packed arrays
+  // of bits, and the number of vertices of each class is counted at
+  // the same time; the number of internal vertices is equal to
+  // nV-getNumberOfBoundaryVertices(), and the number of regular
+  // vertices to nV-getNumberOfSingularVertices()
+
+     Index   getNumberOfBoundaryVertices()             const;
+     Index   getNumberOfSingularVertices()             const;
+     Index   getNumberOfIsolatedVertices()             const;
 
   // a way to determine which vertices are singular and which are
   // regular is to construct a partition of the corners of the mesh,
@@ -155,6 +230,50 @@ public:
   // boundary edge
 
      bool    hasBoundary()                             const;
+
+  // VERTEX STARS
+
+  // the corners and the edges incident to each vertex are stored in
+  // two arrays of arrays, built once by the constructor; the corners
+  // and the edges of each vertex are listed in increasing order, and
+  // the result does not depend on the number of threads; all these
+  // methods return 0 or -1 if an argument is out of range
+
+  // number of corners iC such that getSrc(iC)==iV; this is the
+  // number of faces incident to the vertex, counting a face twice if
+  // the vertex appears twice in it
+
+     Index   getNumberOfVertexCorners(const Index iV)  const;
+     Index   getVertexCorner(const Index iV, const Index j) const;
+     Index   getVertexFace(const Index iV, const Index j) const;
+
+  // number of edges incident to the vertex, i.e. its valence in the
+  // primal graph; getVertexNeighbor(iV,j) is the other end of the
+  // edge getVertexEdge(iV,j)
+
+     Index   getNumberOfVertexEdges(const Index iV)    const;
+     Index   getVertexEdge(const Index iV, const Index j) const;
+     Index   getVertexNeighbor(const Index iV, const Index j) const;
+
+  // ordered fans of corners around a vertex
+  //
+  // - getVertexFanNext(iC) returns the corner of the same vertex in
+  //   the face across the edge from getPrev(iC) to iC, and
+  //   getVertexFanPrev(iC) the corner in the face across the edge
+  //   from iC to getNext(iC); they return -1 if that edge is not a
+  //   regular edge, or if the two faces are not consistently oriented
+  // - getVertexFanFirst(iV) returns the first corner of the fan of a
+  //   regular vertex, i.e. a corner with getVertexFanPrev(iC)==-1 if
+  //   there is one, and the first corner of the vertex otherwise; it
+  //   returns -1 for singular and isolated vertices
+  // - for a regular vertex with consistently oriented faces,
+  //   following getVertexFanNext() from getVertexFanFirst() visits
+  //   each one of its corners once; for an internal vertex the walk
+  //   closes back onto the first corner
+
+     Index   getVertexFanFirst(const Index iV)         const;
+     Index   getVertexFanNext(const Index iC)          const;
+     Index   getVertexFanPrev(const Index iC)          const;
 
   // CONNECTED COMPONENTS
 
@@ -162,13 +281,13 @@ public:
   // - returns number of connected components nCC
   // - fills the faceLabel array with connected component number iCC
   // - for each face; 0<=iCC<nCC
-  int computeConnectedComponentsPrimal(vector<int>& faceLabel) const;
+  Index computeConnectedComponentsPrimal(vector<Index>& faceLabel) const;
 
   // connected components of the dual graph
   // - returns number of connected components nCC
   // - fills the faceLabel array with connected component number iCC
   // - for each face; 0<=iCC<nCC
-  int computeConnectedComponentsDual(vector<int>& faceLabel) const;
+  Index computeConnectedComponentsDual(vector<Index>& faceLabel) const;
 
   // ORIENTATION
   
@@ -188,13 +307,20 @@ public:
   // - note that isolated singular vertices play no role in this
   //   definition (since cuting through them does not affect
   //   orientation)
+  // - the faces and their inverses are numbered 0<=i<2*nF; throws a
+  //   StrException if 2*nF does not fit in an Index, as orient() does
   bool isOrientable() const; 
 
   // orient
-  // - implementation requires a dual graph traversal algorithm
+  // - implemented with a union-find of the faces and of their
+  //   inverses, rather than with a dual graph traversal, so that the
+  //   work can be split amongst multiple threads; the result does not
+  //   depend on the number of threads
   // - the number of connected components nCC of the dual graph are
-  //   determined as a by product
-  // - if multiple orientations are posible choose one
+  //   determined as a by product, and numbered as in
+  //   computeConnectedComponentsDual()
+  // - if multiple orientations are posible, the first face of each
+  //   connected component preserves its orientation
   // - fills the ccIndex array, of size equal to the number of faces
   //   nF, with the connected component number iCC assigned to each face
   // - the values stored in the ccIndex shold be in the range 0<=iCC<nCC
@@ -205,15 +331,41 @@ public:
   // - returns the number of connected components nCC if successful,
   //   and 0 if the mesh is not orientable
   // - if not successful, the output arrays should be empty as well
-  int orient(vector<int>& ccIndex, vector<bool>& invert_face);
+  Index orient(vector<Index>& ccIndex, vector<bool>& invert_face);
+
+  // INCREMENTAL UPDATES
+
+  // these methods patch the tables after the coordIndex array passed
+  // to the constructor has been modified in place by one of the edits
+  // listed below, which is much faster than building a new
+  // PolygonMesh; they return false if the modified coordIndex array
+  // does not correspond to the expected edit, in which case a new
+  // PolygonMesh should be built; other edits, such as adding or
+  // removing faces, or cutting through vertices, also require a new
+  // PolygonMesh
+  // - updateFlippedFaces() : the corners of each face iF with
+  //   flipped[iF]==true have been reversed, as required by the
+  //   invert_face array filled by orient(); only the corners of the
+  //   flipped faces, of their edges, and of their vertices are
+  //   visited, and the edges and the classification tables do not
+  //   change
+  // - updateRemovedVertices() : the vertex indices have been replaced
+  //   as specified by the coordMap array filled by
+  //   removeIsolatedVertices(); the edges keep their indices, and
+  //   the vertex tables are compacted; every corner of the coordIndex
+  //   array is checked against the map before the tables are changed
+  // - the topology cache is not updated
+
+  bool updateFlippedFaces(const vector<bool>& flipped);
+  bool updateRemovedVertices(const vector<Index>& coordMap);
 
   // MANIFOLD
 
   // determine how many isolated vertices the mesh has
-  int numberOfIsolatedVertices();
+  Index numberOfIsolatedVertices();
 
   // get array of isolated vertex indices
-  void getIsolatedVertices(vector<int>& isolated_vertex);
+  void getIsolatedVertices(vector<Index>& isolated_vertex);
 
   // remove isolated vertices
   // - the new number of vertices nVout should be <= that the original
@@ -225,10 +377,11 @@ public:
   //   output range 0<=iVout<nVout
   // - the output coordIndexOut should be of the same size as the
   //   input coordIndex array
-  // - returns true if successful, and false otherwise
+  // - returns true if successful, and false otherwise; coordIndex
+  //   values >=nV are not mapped, and false is returned
   // - if not successful, the output arrays should be empty as well
   bool removeIsolatedVertices
-  (vector<int>& coordMap, vector<int>& coordIndexOut);
+  (vector<Index>& coordMap, vector<int>& coordIndexOut);
 
   // cut through singular vertices
   // - should only cut through singular vertices which belong to
@@ -248,7 +401,7 @@ public:
   // - the output coordIndexOut should be of the same size as the
   //   input coordIndex array
   void cutThroughSingularVertices
-  (vector<int>& vIndexMap, vector<int>& coordIndexOut);
+  (vector<Index>& vIndexMap, vector<int>& coordIndexOut);
 
   // convert to manifold
   // - removes isolated vertices, cuts through singular vertices and
@@ -265,13 +418,57 @@ public:
   // - the output coordIndexOut should be of the same size as the
   //   input coordIndex array
   void convertToManifold
-  (vector<int>& vIndexMap, vector<int>& coordIndexOut);
+  (vector<Index>& vIndexMap, vector<int>& coordIndexOut);
 
 private:
 
-  vector<int>      _nPartsVertex; // if _nPartsVertex[iV]>1 => vertex is singular 
-  vector<bool> _isBoundaryVertex;
+  using HalfEdgesT<Index>::_coordIndex;
+  using HalfEdgesT<Index>::_twin;
+  using HalfEdgesT<Index>::_nThreads;
+  using HalfEdgesT<Index>::_nFaces;
+  using HalfEdgesT<Index>::_isBoundaryEdge;
+  using HalfEdgesT<Index>::_cornerFace;
+  using HalfEdgesT<Index>::_build;
+  using HalfEdgesT<Index>::_readHalfEdges;
+  using HalfEdgesT<Index>::_writeHalfEdges;
+  using HalfEdgesT<Index>::_getFaceCorners;
+  using HalfEdgesT<Index>::_updateFlippedFaces;
+  using HalfEdgesT<Index>::_patchCornerLists;
+  using HalfEdgesT<Index>::_renumberVertices;
+
+  vector<Index>    _nPartsVertex; // if _nPartsVertex[iV]>1 => vertex is singular 
+
+  // vertex classification, filled from the vertex stars
+  BitSet           _isBoundaryVertex;
+  BitSet           _isSingularVertex;
+  BitSet           _isIsolatedVertex;
+  Index            _nBoundaryVertices;
+  Index            _nSingularVertices;
+  Index            _nIsolatedVertices;
+
+  // vertex stars; these arrays are not stored in the topology cache
+  vector<Index>    _firstVertexCorner;
+  vector<Index>    _vertexCorner;
+  vector<Index>    _firstVertexEdge;
+  vector<Index>    _vertexEdge;
+
+  bool _getOppositeCorners(const Index iE, Index iCpair[4]) const;
+  void _buildVertexStars();
+  Index _getStarEdge(const Index iV0, const Index iV1) const;
+  void _packVertexClassification();
+  void _countVertexPartsConcurrent(const int nT);
+  void _classifyVertices();
+  bool _joinFaceOrientations(ConcurrentPartitionT<Index>& partition,
+                             const int nT) const;
+  bool _readCache(const string& filename, const uint64_t key);
+  bool _writeCache(const string& filename, const uint64_t key) const;
   
 };
 
+typedef PolygonMeshT<int>     PolygonMesh;
+typedef PolygonMeshT<int64_t> PolygonMesh64;
+
+extern template class PolygonMeshT<int>;
+extern template class PolygonMeshT<int64_t>;
+
 #endif /* _POLYGON_MESH_HPP_ */
@@ -137,6 +137,27 @@ PolygonMeshTest::PolygonMeshTest
             nV_singular++;
         }
 
+        // the per element counts should agree with the counts
+        // determined by the constructor
+        if(nE_boundary!=pMesh.getNumberOfBoundaryEdges())
+          _ostr << indent << "        ERROR getNumberOfBoundaryEdges() = "
+                << pMesh.getNumberOfBoundaryEdges() << endl;
+        if(nE_regular!=pMesh.getNumberOfRegularEdges())
+          _ostr << indent << "        ERROR getNumberOfRegularEdges() = "
+                << pMesh.getNumberOfRegularEdges() << endl;
+        if(nE_singular!=pMesh.getNumberOfSingularEdges())
+          _ostr << indent << "        ERROR getNumberOfSingularEdges() = "
+                << pMesh.getNumberOfSingularEdges() << endl;
+        if(nE_other!=nE-pMesh.getNumberOfBoundaryEdges()
+           -pMesh.getNumberOfRegularEdges()-pMesh.getNumberOfSingularEdges())
+          _ostr << indent << "        ERROR nE_other = " << nE_other << endl;
+        if(nV_boundary!=pMesh.getNumberOfBoundaryVertices())
+          _ostr << indent << "        ERROR getNumberOfBoundaryVertices() = "
+                << pMesh.getNumberOfBoundaryVertices() << endl;
+        if(nV_singular!=pMesh.getNumberOfSingularVertices())
+          _ostr << indent << "        ERROR getNumberOfSingularVertices() = "
+                << pMesh.getNumberOfSingularVertices() << endl;
+
         nV_internal = nV-nV_boundary;
         nV_regular  = nV-nV_singular;
 
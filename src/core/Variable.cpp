@@ -119,3 +119,10 @@ VariablePolygonMesh::VariablePolygonMesh
 void* VariablePolygonMesh::getValue() {
   return (void*)(&_value);
 }
+
+VariableCoordSoA::VariableCoordSoA(const vector<float>& coord):
+  Variable("coordSoA"),_value(coord) {
+}
+void* VariableCoordSoA::getValue() {
+  return (void*)(&_value);
+}
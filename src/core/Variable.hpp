@@ -42,6 +42,7 @@
 #include <wrl/Types.hpp>
 #include "Faces.hpp"
 #include "PolygonMesh.hpp"
+#include "CoordSoA.hpp"
 
 using namespace std;
 
@@ -159,4 +160,13 @@ private:
   PolygonMesh _value;
 };
 
+class VariableCoordSoA : public Variable {
+public:
+  VariableCoordSoA(const vector<float>& coord);
+  virtual ~VariableCoordSoA() {}
+  virtual void* getValue();
+private:
+  CoordSoA _value;
+};
+
 #endif // _VARIABLE_HPP_
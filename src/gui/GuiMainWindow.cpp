@@ -57,6 +57,8 @@
 #include "io/SaverStl.hpp"
 #include "io/LoaderPly.hpp"
 #include "io/SaverPly.hpp"
+#include "io/LoaderDgp.hpp"
+#include "io/SaverDgp.hpp"
 
 int GuiMainWindow::_timerInterval = 20;
 
@@ -170,6 +172,11 @@ GuiMainWindow::GuiMainWindow():
   SaverPly* plySaver = new SaverPly();
   _saver.registerSaver(plySaver);
 
+  LoaderDgp* dgpLoader = new LoaderDgp();
+  _loader.registerLoader(dgpLoader);
+  SaverDgp* dgpSaver = new SaverDgp();
+  _saver.registerSaver(dgpSaver);
+
     // QColor clearColor    = qRgb(175, 200, 150);
   QColor clearColor    = qRgb(200, 200, 200);
   QColor materialColor = qRgb(225, 150, 75);
@@ -314,7 +321,7 @@ void GuiMainWindow::onMenuFileLoad() {
   fileDialog.setFileMode(QFileDialog::ExistingFile); // allowed to select only one 
   fileDialog.setAcceptMode(QFileDialog::AcceptOpen);
   if(dataDir!="") fileDialog.setDirectory(dataDir);
-  fileDialog.setNameFilter(tr("3D Files (*.wrl *.stl *.ply *.off *.obj)"));
+  fileDialog.setNameFilter(tr("3D Files (*.wrl *.stl *.ply *.dgp *.off *.obj)"));
 
   std::string filePath;
   if(fileDialog.exec()) {
@@ -355,7 +362,7 @@ void GuiMainWindow::onMenuFileSave() {
   QFileDialog fileDialog(this);
   fileDialog.setFileMode(QFileDialog::AnyFile); // allowed to select only one 
   fileDialog.setAcceptMode(QFileDialog::AcceptSave);
-  fileDialog.setNameFilter(tr("3D Files (*.wrl *.stl *.ply *.off *.obj)"));
+  fileDialog.setNameFilter(tr("3D Files (*.wrl *.stl *.ply *.dgp *.off *.obj)"));
   if(url!="") {
     // fileDialog.setDirectory(dir);
     fileDialog.selectFile(wrlFilePath);
@@ -341,30 +341,14 @@ void GuiPanelPolygonMesh::on_pushButtonTestPolygonMesh_clicked() {
     editTestFaces->setText(QString("%1").arg(nF));
     editTestCorners->setText(QString("%1").arg(nC));
 
-    int nE_boundary  = 0;
-    int nE_regular   = 0;
-    int nE_singular  = 0;
-    int nE_other     = 0;
-    for(int iE=0;iE<nE;iE++) {
-      if(pm->isBoundaryEdge(iE)) {
-        nE_boundary++;
-      } else if(pm->isRegularEdge(iE)) {
-        nE_regular++;
-      } else if(pm->isSingularEdge(iE)) {
-        nE_singular++;
-      } else {
-        nE_other++;
-      }
-    }
-    
-    int nV_boundary  = 0;
-    int nV_singular  = 0;
-    for(int iV=0;iV<nV;iV++) {
-      if(pm->isBoundaryVertex(iV))
-        nV_boundary++;
-      if(pm->isSingularVertex(iV))
-        nV_singular++;
-    }
+    // the classification counts are determined by the constructor
+    int nE_boundary  = pm->getNumberOfBoundaryEdges();
+    int nE_regular   = pm->getNumberOfRegularEdges();
+    int nE_singular  = pm->getNumberOfSingularEdges();
+    int nE_other     = nE-nE_boundary-nE_regular-nE_singular;
+
+    int nV_boundary  = pm->getNumberOfBoundaryVertices();
+    int nV_singular  = pm->getNumberOfSingularVertices();
     int nV_internal = nV-nV_boundary;
     int nV_regular  = nV-nV_singular;
 
@@ -566,8 +550,6 @@ void GuiPanelPolygonMesh::on_pushButtonOrient_clicked() {
 
   // the mesh is orientable but not oriented; we need to invert one or more faces
 
-  // delete the PolygonMesh because it is not longer valid
-  ifs->eraseVariable("PolygonMesh"); pm = nullptr;
   ifs->eraseVariable("HalfEdges"); // just in case
   
   vector<int>& coordIndex    = ifs->getCoordIndex();
@@ -615,7 +597,7 @@ void GuiPanelPolygonMesh::on_pushButtonOrient_clicked() {
           colorIndex[iCinv] = iTmp;
         }
         if(ifs->hasNormalPerCorner()) {
-          iTmp = coordIndex[iC];
+          iTmp = normalIndex[iC];
           normalIndex[iC] = normalIndex[iCinv];
           normalIndex[iCinv] = iTmp;
         }
@@ -640,6 +622,13 @@ void GuiPanelPolygonMesh::on_pushButtonOrient_clicked() {
 
     iC0 = iC1+1; iF++;
   }
+
+  // patch the PolygonMesh, rather than building a new one; it is
+  // deleted if it cannot be patched
+  if(pm->updateFlippedFaces(invert_face)==false) {
+    ifs->eraseVariable("PolygonMesh"); pm = nullptr;
+  }
+
   // reset 3D view
   getApp()->getMainWindow()->resetSceneGraph();
 }
@@ -726,8 +715,6 @@ void GuiPanelPolygonMesh::on_pushButtonRemoveIsolatedVertices_clicked() {
     }
   }
   
-  // delete the PolygonMesh because it is not longer valid
-  ifs->eraseVariable("PolygonMesh"); pm = nullptr;
   ifs->eraseVariable("HalfEdges"); // just in case
 
   // swap ifs variables
@@ -738,6 +725,12 @@ void GuiPanelPolygonMesh::on_pushButtonRemoveIsolatedVertices_clicked() {
   if(hasCpv) color.swap(colorOut);
   if(hasTpv)  texCoord.swap(texCoordOut);
   if(hasVsel) (*vertexSelPtr).swap(vertexSelOut);
+
+  // the PolygonMesh refers to the same coordIndex array; it is
+  // patched, rather than rebuilt, and deleted if it cannot be patched
+  if(pm->updateRemovedVertices(coordMap)==false) {
+    ifs->eraseVariable("PolygonMesh"); pm = nullptr;
+  }
   
   // reset 3D view
   getApp()->getMainWindow()->resetSceneGraph();
@@ -0,0 +1,236 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// FormatBuffer.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <math.h>
+#include <stdarg.h>
+#include <string.h>
+#include <charconv>
+#include "FormatBuffer.hpp"
+
+// enough room for any fixed format double without padding, which
+// has at most 309 integer digits, sign, and decimal point
+static const size_t maxNumberSize = 320;
+
+// a float has a 24 bit mantissa, and 5^9 < 2^21; as a result, for
+// precision<=maxFastPrecision the product of a float and 10^precision
+// is computed exactly in double precision, and the fixed format can
+// be produced from the rounded product, as an integer
+static const int    maxFastPrecision = 9;
+static const double maxFastScaled    = 9.0e15; // < 2^53
+static const double powerOfTen[maxFastPrecision+1] = {
+  1.0e0, 1.0e1, 1.0e2, 1.0e3, 1.0e4, 1.0e5, 1.0e6, 1.0e7, 1.0e8, 1.0e9
+};
+
+FormatBuffer::FloatFormat
+FormatBuffer::_defaultFloatFormat = FormatBuffer::FIXED;
+
+//////////////////////////////////////////////////////////////////////
+// static
+void FormatBuffer::setDefaultFloatFormat(const FloatFormat floatFormat) {
+  _defaultFloatFormat = floatFormat;
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+FormatBuffer::FloatFormat FormatBuffer::getDefaultFloatFormat() {
+  return _defaultFloatFormat;
+}
+
+//////////////////////////////////////////////////////////////////////
+FormatBuffer::FormatBuffer(FILE* fp, const size_t capacity):
+  _fp(fp),
+  _buffer((capacity>2*maxNumberSize)?capacity:2*maxNumberSize),
+  _size(0),
+  _floatFormat(_defaultFloatFormat),
+  _failed(false) {
+}
+
+//////////////////////////////////////////////////////////////////////
+FormatBuffer::~FormatBuffer() {
+  flush();
+}
+
+//////////////////////////////////////////////////////////////////////
+void FormatBuffer::setFloatFormat(const FloatFormat floatFormat) {
+  _floatFormat = floatFormat;
+}
+
+//////////////////////////////////////////////////////////////////////
+bool FormatBuffer::flush() {
+  if(_size>0) {
+    if(_fp==nullptr || fwrite(_buffer.data(),1,_size,_fp)!=_size)
+      _failed = true;
+    _size = 0;
+  }
+  return (_failed==false);
+}
+
+//////////////////////////////////////////////////////////////////////
+// returns a pointer to nBytes free bytes at the end of the buffer
+char* FormatBuffer::_reserve(const size_t nBytes) {
+  if(_size+nBytes>_buffer.size()) {
+    flush();
+    if(nBytes>_buffer.size()) _buffer.resize(nBytes);
+  }
+  return _buffer.data()+_size;
+}
+
+//////////////////////////////////////////////////////////////////////
+// appends the n characters just written at b, right aligned within
+// a field of the given width
+void FormatBuffer::_commit(char* b, const size_t n, const int width) {
+  const size_t w = (width>0)?static_cast<size_t>(width):0;
+  if(n<w) {
+    memmove(b+(w-n),b,n);
+    memset(b,' ',w-n);
+    _size += w;
+  } else {
+    _size += n;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////
+void FormatBuffer::put(const char c) {
+  *_reserve(1) = c;
+  _size++;
+}
+
+//////////////////////////////////////////////////////////////////////
+void FormatBuffer::put(const char* s) {
+  const size_t n = strlen(s);
+  memcpy(_reserve(n),s,n);
+  _size += n;
+}
+
+//////////////////////////////////////////////////////////////////////
+void FormatBuffer::put(const string& s) {
+  memcpy(_reserve(s.size()),s.data(),s.size());
+  _size += s.size();
+}
+
+//////////////////////////////////////////////////////////////////////
+void FormatBuffer::format(const char* fmt, ...) {
+  va_list ap;
+  va_start(ap,fmt);
+  const size_t nFree = _buffer.size()-_size;
+  va_list aq;
+  va_copy(aq,ap);
+  int n = vsnprintf(_buffer.data()+_size,nFree,fmt,aq);
+  va_end(aq);
+  if(n>=0 && static_cast<size_t>(n)>=nFree) {
+    // did not fit; the output was truncated
+    char* b = _reserve(static_cast<size_t>(n)+1);
+    n = vsnprintf(b,static_cast<size_t>(n)+1,fmt,ap);
+  }
+  va_end(ap);
+  if(n>0) _size += static_cast<size_t>(n);
+}
+
+//////////////////////////////////////////////////////////////////////
+void FormatBuffer::putInt(const long i, const int width) {
+  const size_t nBytes = maxNumberSize+((width>0)?static_cast<size_t>(width):0);
+  char* b = _reserve(nBytes);
+  std::to_chars_result r = std::to_chars(b,b+maxNumberSize,i);
+  _commit(b,static_cast<size_t>(r.ptr-b),width);
+}
+
+//////////////////////////////////////////////////////////////////////
+void FormatBuffer::putFloat
+(const float f, const int width, const int precision) {
+  if(_floatFormat==FIXED) {
+    const double scaled =
+      (precision>=0 && precision<=maxFastPrecision)?
+      fabs(static_cast<double>(f))*powerOfTen[precision]:-1.0;
+    if(scaled>=0.0 && scaled<maxFastScaled) {
+      // nearbyint() rounds ties to even, as printf() does
+      unsigned long n = static_cast<unsigned long>(nearbyint(scaled));
+      const unsigned long p = static_cast<unsigned long>(powerOfTen[precision]);
+      char* b = _reserve(maxNumberSize+((width>0)?static_cast<size_t>(width):0));
+      char* e = b;
+      if(signbit(f)) *e++ = '-';
+      e = std::to_chars(e,b+maxNumberSize,n/p).ptr;
+      if(precision>0) {
+        *e++ = '.';
+        n %= p;
+        for(int i=precision-1;i>=0;i--,n/=10) e[i] = static_cast<char>('0'+n%10);
+        e += precision;
+      }
+      _commit(b,static_cast<size_t>(e-b),width);
+    } else {
+      // precision out of range, large values, NaN, and infinity
+      putDouble(static_cast<double>(f),width,precision);
+    }
+    return;
+  }
+  char* b = _reserve(maxNumberSize);
+  size_t n;
+#ifdef __cpp_lib_to_chars
+  std::to_chars_result r = std::to_chars(b,b+maxNumberSize,f);
+  n = static_cast<size_t>(r.ptr-b);
+#else
+  n = static_cast<size_t>
+    (snprintf(b,maxNumberSize,"%.9g",static_cast<double>(f)));
+#endif
+  _commit(b,n,0);
+}
+
+//////////////////////////////////////////////////////////////////////
+void FormatBuffer::putDouble
+(const double d, const int width, const int precision) {
+  const int p = (precision>0)?precision:0;
+  const size_t nBytes =
+    maxNumberSize+static_cast<size_t>(p)+
+    ((width>0)?static_cast<size_t>(width):0);
+  char* b = _reserve(nBytes);
+  int n;
+#ifdef __cpp_lib_to_chars
+  std::to_chars_result r =
+    (_floatFormat==FIXED)?
+    std::to_chars(b,b+nBytes,d,std::chars_format::fixed,p):
+    std::to_chars(b,b+nBytes,d);
+  n = static_cast<int>(r.ptr-b);
+#else
+  n = (_floatFormat==FIXED)?
+    snprintf(b,nBytes,"%.*f",p,d):
+    snprintf(b,nBytes,"%.17g",d);
+#endif
+  _commit(b,static_cast<size_t>(n),(_floatFormat==FIXED)?width:0);
+}
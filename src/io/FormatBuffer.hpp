@@ -0,0 +1,115 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// FormatBuffer.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef FORMAT_BUFFER_HPP
+#define FORMAT_BUFFER_HPP
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+// Text output buffer used by the ASCII savers; numbers are formatted
+// with std::to_chars() directly into a reusable buffer, which is
+// written to the file in large blocks, avoiding the format string
+// parsing and the locale handling of fprintf()
+
+class FormatBuffer {
+
+public:
+
+  // FIXED     : as printf("%*.*f",width,precision,x) would do
+  // SHORTEST  : shortest representation which reads back as the same
+  //             float or double value; width and precision are ignored
+  enum FloatFormat {
+    FIXED,
+    SHORTEST
+  };
+
+  // the default float format of the buffers created afterwards
+  static void        setDefaultFloatFormat(const FloatFormat floatFormat);
+  static FloatFormat getDefaultFloatFormat();
+
+public:
+
+  FormatBuffer(FILE* fp, const size_t capacity=(static_cast<size_t>(1)<<20));
+  ~FormatBuffer(); // flushes the buffer
+
+  void        setFloatFormat(const FloatFormat floatFormat);
+  FloatFormat getFloatFormat() const { return _floatFormat; }
+
+  void put(const char c);
+  void put(const char* s);
+  void put(const string& s);
+
+  // as fprintf() would do; meant for the occasional line of text,
+  // rather than for large arrays of numbers
+  void format(const char* fmt, ...);
+
+  // as printf("%*d",width,i) would do
+  void putInt(const long i, const int width=0);
+
+  // as printf("%*.*f",width,precision,x) would do, or in the shortest
+  // representation, depending on the float format
+  void putFloat(const float f, const int width=0, const int precision=6);
+  void putDouble(const double d, const int width=0, const int precision=6);
+
+  // writes the contents of the buffer to the file; returns false if
+  // any write to the file has failed
+  bool flush();
+
+private:
+
+  static FloatFormat _defaultFloatFormat;
+
+  FILE*        _fp;
+  vector<char> _buffer;
+  size_t       _size;
+  FloatFormat  _floatFormat;
+  bool         _failed;
+
+  char* _reserve(const size_t nBytes);
+  void  _commit(char* b, const size_t n, const int width);
+
+};
+
+#endif // FORMAT_BUFFER_HPP
@@ -0,0 +1,134 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// LoaderDgp.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+#include <cstdio>
+#include "LoaderDgp.hpp"
+#include "StrException.hpp"
+
+#include "wrl/Shape.hpp"
+#include "wrl/Appearance.hpp"
+#include "wrl/Material.hpp"
+
+const char* LoaderDgp::_ext = "dgp";
+
+IndexedFaceSet* LoaderDgp::_initializeSceneGraph
+(const char* filename, const DgpFile& file, SceneGraph& wrl) {
+  // 0) clear the container
+  wrl.clear();
+  wrl.setUrl(filename);
+  // 1) the SceneGraph has a single Shape node a child
+  Shape* shape = new Shape();
+  wrl.addChild(shape);
+  string name;
+  if(file.getSection("name",name)) shape->setName(name);
+  // 2) the Shape node has an Appearance node in its appearance
+  // field, with a Material node, if the file has a diffuse color
+  vector<float> diffuseColor;
+  if(file.getSection("diffuseColor",diffuseColor) && diffuseColor.size()==3) {
+    Appearance* appearance = new Appearance();
+    shape->setAppearance(appearance);
+    Material* material = new Material();
+    Color c(diffuseColor[0],diffuseColor[1],diffuseColor[2]);
+    material->setDiffuseColor(c);
+    appearance->setMaterial(material);
+  }
+  // 3) the Shape node has an IndexedFaceSet node in its geometry node
+  IndexedFaceSet* ifs = new IndexedFaceSet();
+  shape->setGeometry(ifs);
+  return ifs;
+}
+
+bool LoaderDgp::load(const char* filename, SceneGraph& wrl) {
+  bool success = false;
+  try {
+
+    if(filename==(char*)0) throw new StrException("filename==null");
+
+    DgpFile file;
+    if(file.open(filename)==false)
+      throw new StrException("unable to open file, or not a DGP file");
+    if(file.hasSection("coord")==false || file.hasSection("coordIndex")==false)
+      throw new StrException("missing coord or coordIndex section");
+
+    IndexedFaceSet* ifs = _initializeSceneGraph(filename,file,wrl);
+
+    vector<int> flags;
+    if(file.getSection("flags",flags) && flags.size()==5) {
+      ifs->getCcw()             = (flags[0]!=0);
+      ifs->getConvex()          = (flags[1]!=0);
+      ifs->getSolid()           = (flags[2]!=0);
+      ifs->getNormalPerVertex() = (flags[3]!=0);
+      ifs->getColorPerVertex()  = (flags[4]!=0);
+    }
+    vector<float> creaseAngle;
+    if(file.getSection("creaseAngle",creaseAngle) && creaseAngle.size()==1)
+      ifs->getCreaseAngle() = creaseAngle[0];
+
+    // the arrays are copied straight from the mapped file
+    if(file.getSection("coord",ifs->getCoord())==false)
+      throw new StrException("coord section is not a float array");
+    if(file.getSection("coordIndex",ifs->getCoordIndex())==false)
+      throw new StrException("coordIndex section is not an int array");
+    // the optional sections are left empty if they are not found
+    file.getSection("normal"       ,ifs->getNormal());
+    file.getSection("normalIndex"  ,ifs->getNormalIndex());
+    file.getSection("color"        ,ifs->getColor());
+    file.getSection("colorIndex"   ,ifs->getColorIndex());
+    file.getSection("texCoord"     ,ifs->getTexCoord());
+    file.getSection("texCoordIndex",ifs->getTexCoordIndex());
+
+    const vector<int>& coordIndex = ifs->getCoordIndex();
+    if(ifs->getCoord().size()%3!=0)
+      throw new StrException("coord size is not a multiple of 3");
+    if(coordIndex.size()>0 && coordIndex.back()!=-1)
+      throw new StrException("last face of coordIndex not terminated by -1");
+
+    success = true;
+
+  } catch(StrException* e) {
+
+    fprintf(stderr,"LoaderDgp | ERROR | %s\n",e->what());
+    delete e;
+    wrl.clear();
+    wrl.setUrl("");
+
+  }
+  return success;
+}
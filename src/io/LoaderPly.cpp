@@ -40,14 +40,18 @@
 // DAMAGE.
 
 // #include <stdio.h>
+#include <cstring>
+#include <exception>
 #include <iostream>
 
 using namespace std;
 
 #include "LoaderPly.hpp"
 #include "TokenizerFile.hpp"
-#include "TokenizerString.hpp"
+#include "TokenizerBuffer.hpp"
 #include "StrException.hpp"
+#include <util/MappedFile.hpp>
+#include <util/Parallel.hpp>
 #include <wrl/Shape.hpp>
 #include <wrl/Appearance.hpp>
 #include <wrl/Material.hpp>
@@ -73,105 +77,170 @@ bool LoaderPly::sameAsSystemEndian(Ply::DataType fileEndian) {
 
 //////////////////////////////////////////////////////////////////////
 // static
-void LoaderPly::addBinaryValue
-(Endian::SingleValueBuffer& buff,
- const Ply::Element::Property::Type propertyType,
- const bool swapBytes,
- void* value) {
+int LoaderPly::getListCount
+(const char* b,
+ const Ply::Element::Property::Type listType,
+ const bool swapBytes) {
+
+  Endian::SingleValueBuffer buff;
+  const int nBytes = Ply::Element::Property::getTypeSize(listType);
+  memcpy(buff.c,b,static_cast<size_t>(nBytes));
+  if(swapBytes && nBytes==2) Endian::swap2(buff);
+  if(swapBytes && nBytes==4) Endian::swap4(buff);
+
+  long nList = 0;
+  switch(listType) {
+  // a list count is never negative, and one byte counts are read as
+  // unsigned, so that lists of 128 to 255 values can be read from
+  // files which declare the count as char
+  case Ply::Element::Property::Type::CHAR:
+  case Ply::Element::Property::Type::INT8:
+  case Ply::Element::Property::Type::UCHAR:
+  case Ply::Element::Property::Type::UINT8:
+    nList = static_cast<long>(buff.uc[0]);
+    break;
+  case Ply::Element::Property::Type::SHORT:
+  case Ply::Element::Property::Type::INT16:
+    nList = static_cast<long>(buff.s[0]);
+    break;
+  case Ply::Element::Property::Type::USHORT:
+  case Ply::Element::Property::Type::UINT16:
+    nList = static_cast<long>(buff.us[0]);
+    break;
+  case Ply::Element::Property::Type::INT:
+  case Ply::Element::Property::Type::INT32:
+    nList = static_cast<long>(buff.i[0]);
+    break;
+  case Ply::Element::Property::Type::UINT:
+  case Ply::Element::Property::Type::UINT32:
+    nList = static_cast<long>(buff.ui[0]);
+    break;
+  default:
+    throw new StrException("unexpected list type");
+  }
+  if(nList<0 || nList>0x7fffffffL)
+    throw new StrException("invalid list count");
+  return static_cast<int>(nList);
+}
 
+// calls f(v), where v is the vector of values of a property of the
+// given type; see the Ply::Element::Property constructor
+template<class F>
+static void forEachValueType
+(const Ply::Element::Property::Type propertyType, void* value, F f) {
   switch(propertyType) {
   case Ply::Element::Property::CHAR:
   case Ply::Element::Property::INT8:
-    {
-      vector<char>* valueChar= static_cast<vector<char>*>(value);
-      char v = buff.c[0];
-      valueChar->push_back(v);
-    }
+    f(*static_cast<vector<char>*>(value));
     break;
   case Ply::Element::Property::UCHAR:
   case Ply::Element::Property::UINT8:
-    {
-      vector<uchar>* valueUChar= static_cast<vector<uchar>*>(value);
-      uchar v = buff.uc[0];
-      valueUChar->push_back(v);
-    }
+    f(*static_cast<vector<uchar>*>(value));
     break;
   case Ply::Element::Property::SHORT:
   case Ply::Element::Property::INT16:
-    {
-      vector<short>* valueShort= static_cast<vector<short>*>(value);
-      if(swapBytes) Endian::swapShort(buff);
-      short v = buff.s[0];
-      valueShort->push_back(v);
-    }
+    f(*static_cast<vector<short>*>(value));
     break;
   case Ply::Element::Property::USHORT:
   case Ply::Element::Property::UINT16:
-    {
-      vector<ushort>* valueUShort= static_cast<vector<ushort>*>(value);
-      if(swapBytes) Endian::swapUShort(buff);
-      ushort v = buff.us[0];
-      valueUShort->push_back(v);
-    }
+    f(*static_cast<vector<ushort>*>(value));
     break;
   case Ply::Element::Property::INT:
   case Ply::Element::Property::INT32:
-    {
-      vector<int>* valueInt= static_cast<vector<int>*>(value);
-      if(swapBytes) Endian::swapInt(buff);
-      int v = buff.i[0];
-      valueInt->push_back(v);
-    }
+    f(*static_cast<vector<int>*>(value));
     break;
   case Ply::Element::Property::UINT:
   case Ply::Element::Property::UINT32:
-    {
-      vector<uint>* valueUInt= static_cast<vector<uint>*>(value);
-      if(swapBytes) Endian::swapUInt(buff);
-      uint v = buff.ui[0];
-      valueUInt->push_back(v);
-    }
+    f(*static_cast<vector<uint>*>(value));
     break;
   case Ply::Element::Property::FLOAT:
   case Ply::Element::Property::FLOAT32:
   case Ply::Element::Property::FLOAT32_2:
   case Ply::Element::Property::FLOAT32_3:
-    {
-      vector<float>* valueFloat = static_cast<vector<float>*>(value);
-      if(swapBytes) Endian::swapFloat(buff);
-      float v = buff.f[0];
-      valueFloat->push_back(v);
-    }
+    f(*static_cast<vector<float>*>(value));
     break;
   case Ply::Element::Property::DOUBLE:
   case Ply::Element::Property::FLOAT64:
-    {
-      vector<double>* valueDouble = static_cast<vector<double>*>(value);
-      if(swapBytes) Endian::swapDouble(buff);
-      double v = buff.d[0];
-      valueDouble->push_back(v);
-    }
-    break; 
+    f(*static_cast<vector<double>*>(value));
+    break;
   case Ply::Element::Property::NONE:
-    {
-      throw new StrException("unexpected NONE binary value tyde");
-    }
+    throw new StrException("unexpected NONE binary value type");
   }
 }
 
+// appends nRecords*nValues values to the end of v; the nValues
+// values of each record are contiguous in src, and the records are
+// stride bytes apart
+template<class T>
+static void appendBinaryValues
+(vector<T>& v, const char* src, const size_t stride,
+ const int nRecords, const int nValues, const bool swapBytes) {
+  const size_t n0 = v.size();
+  const size_t nBytesRecord = sizeof(T)*static_cast<size_t>(nValues);
+  v.resize(n0+static_cast<size_t>(nRecords)*nValues);
+  char* dst = reinterpret_cast<char*>(v.data()+n0);
+  if(stride==nBytesRecord) {
+    memcpy(dst,src,nBytesRecord*static_cast<size_t>(nRecords));
+  } else {
+    for(int iRecord=0;iRecord<nRecords;iRecord++)
+      memcpy(dst+nBytesRecord*iRecord,src+stride*iRecord,nBytesRecord);
+  }
+  if(swapBytes && sizeof(T)>1)
+    Endian::swapArray(dst,static_cast<size_t>(nRecords)*nValues,
+                      static_cast<int>(sizeof(T)));
+}
+
+//////////////////////////////////////////////////////////////////////
+// static
+void LoaderPly::addBinaryValues
+(const char* src,
+ const size_t stride,
+ const int nRecords,
+ const int nValues,
+ const int nBytesValue,
+ const Ply::Element::Property::Type propertyType,
+ const bool colorWrl,
+ const bool swapBytes,
+ void* value) {
+
+  if(colorWrl) {
+    // wrlMode color : uchar red, green, and blue mapped to [0,1]
+    vector<float>* colorValue = static_cast<vector<float>*>(value);
+    for(int iRecord=0;iRecord<nRecords;iRecord++)
+      for(int i=0;i<nValues;i++)
+        colorValue->push_back
+          (static_cast<float>(static_cast<uchar>(src[stride*iRecord+i]))/
+           255.0f);
+    return;
+  }
+
+  forEachValueType(propertyType,value,[&](auto& v) {
+      if(static_cast<int>(sizeof(v[0]))!=nBytesValue)
+        throw new StrException("binary value size mismatch");
+      appendBinaryValues(v,src,stride,nRecords,nValues,swapBytes);
+    });
+}
+
 //////////////////////////////////////////////////////////////////////
 // static
+// the token [begin:end) is converted as atoi(), atol(), and atof()
+// would convert it, without copying it into a string
 void LoaderPly::addAsciiValue
-(const string& token,
+(const char* begin, const char* end,
  const Ply::Element::Property::Type propertyType,
  void* value) {
 
+  int    i = 0;
+  long   l = 0;
+  double d = 0.0;
+
   switch(propertyType) {
   case Ply::Element::Property::CHAR:
   case Ply::Element::Property::INT8:
     {
       vector<char>* valueChar= static_cast<vector<char>*>(value);
-      char v = static_cast<char>(atoi(token.c_str()));
+      TokenizerBuffer::parseInt(begin,end,i);
+      char v = static_cast<char>(i);
       valueChar->push_back(v);
     }
     break;
@@ -179,7 +248,8 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::UINT8:
     {
       vector<uchar>* valueUChar= static_cast<vector<uchar>*>(value);
-      uchar v = static_cast<uchar>(atoi(token.c_str()));
+      TokenizerBuffer::parseInt(begin,end,i);
+      uchar v = static_cast<uchar>(i);
       valueUChar->push_back(v);
     }
     break;
@@ -187,7 +257,8 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::INT16:
     {
       vector<short>* valueShort= static_cast<vector<short>*>(value);
-      short v = static_cast<short>(atoi(token.c_str()));
+      TokenizerBuffer::parseInt(begin,end,i);
+      short v = static_cast<short>(i);
       valueShort->push_back(v);
     }
     break;
@@ -195,7 +266,8 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::UINT16:
     {
       vector<ushort>* valueUShort= static_cast<vector<ushort>*>(value);
-      ushort v = static_cast<ushort>(atoi(token.c_str()));
+      TokenizerBuffer::parseInt(begin,end,i);
+      ushort v = static_cast<ushort>(i);
       valueUShort->push_back(v);
     }
     break;
@@ -203,7 +275,8 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::INT32:
     {
       vector<int>* valueInt= static_cast<vector<int>*>(value);
-      int v = static_cast<int>(atoi(token.c_str()));
+      TokenizerBuffer::parseInt(begin,end,i);
+      int v = static_cast<int>(i);
       valueInt->push_back(v);
     }
     break;
@@ -211,7 +284,8 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::UINT32:
     {
       vector<uint>* valueUInt= static_cast<vector<uint>*>(value);
-      uint v = static_cast<uint>(atol(token.c_str()));
+      TokenizerBuffer::parseLong(begin,end,l);
+      uint v = static_cast<uint>(l);
       valueUInt->push_back(v);
     }
     break;
@@ -221,7 +295,8 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::FLOAT32_3:
     {
       vector<float>* valueFloat = static_cast<vector<float>*>(value);
-      float v = static_cast<float>(atof(token.c_str()));
+      TokenizerBuffer::parseDouble(begin,end,d);
+      float v = static_cast<float>(d);
       valueFloat->push_back(v);
     }
     break;
@@ -229,7 +304,8 @@ void LoaderPly::addAsciiValue
   case Ply::Element::Property::FLOAT64:
     {
       vector<double>* valueDouble = static_cast<vector<double>*>(value);
-      double v = static_cast<double>(atof(token.c_str()));
+      TokenizerBuffer::parseDouble(begin,end,d);
+      double v = static_cast<double>(d);
       valueDouble->push_back(v);
     }
     break;
@@ -239,7 +315,7 @@ void LoaderPly::addAsciiValue
     }
   }
 }
-
+
 //////////////////////////////////////////////////////////////////////
 // returns number of bytes read
 size_t LoaderPly::readHeader(FILE* fp, Ply& ply, const string indent) {
@@ -427,372 +503,426 @@ size_t LoaderPly::readHeader(FILE* fp, Ply& ply, const string indent) {
 
 //////////////////////////////////////////////////////////////////////
 // static
-size_t LoaderPly::readBinaryData(FILE* fp, Ply& ply, const string indent) {
+// decodes the binary data from memory; data points to the first byte
+// after the header, and nBytes is the size of the rest of the file;
+// returns number of bytes decoded
+size_t LoaderPly::readBinaryData
+(const char* data, const size_t nBytes, Ply& ply, const string indent) {
 
   (void)indent;
 
   // APP->log(QString(indent.c_str())+"LoaderPly::readBinaryData() {");
 
-  size_t nBytesData = 0;
-  if(fp) {
-    long fp0 = ftell(fp);
-
-    int                     nElements,iElement,nProperties,iProperty;
-    int                     nRecords,iRecord,k0,k1,i;
-    int                     nList,nBytesListCount, nBytesListValue;
-    int                     nBytesValue,nBytesRead/*,nBytesRecord*/;
-    string                  name;
-    string                  propertyName;
-    void*                   value        = nullptr;
-    Ply::DataType           dataType     = ply.getDataType();
-    Ply::Element*           element      = nullptr;
-    Ply::Element::Property* property     = nullptr;
-    Ply::Element::Property::Type propertyType = Ply::Element::Property::Type::NONE;
-    Ply::Element::Property::Type listType     = Ply::Element::Property::Type::NONE;
-
-    Endian::SingleValueBuffer buff;
-
-    bool swapBytes = (sameAsSystemEndian(dataType)==false);
-    // bool little  = (dataType==Ply::DataType::BINARY_LITTLE_ENDIAN);
-
-    // APP->log(QString("%1  dataType  = %2")
-    //          .arg(indent.c_str()).arg(Ply::getDataTypeName(dataType).c_str()));
-    // APP->log(QString("%1  swapBytes  = %2")
-    //          .arg(indent.c_str()).arg((swapBytes)?"true":"false"));
-
-    nElements = ply.getNumberOfElements();
-    // APP->log(QString("%1  nElements = %2").arg(indent.c_str()).arg(nElements));
-
-    bool wrlMode = ply.getWrlMode();
-
-    for(iElement=0;iElement<nElements;iElement++) {
-      element = ply.getElement(iElement);
-      name    = element->getName();
+  const char*             p            = data;
+  const char*             end          = data+nBytes;
+  int                     nElements,iElement,nProperties,iProperty;
+  int                     nRecords,iRecord,nList,n;
+  size_t                  nBytesRecord,nBytesNeeded,offset;
+  Ply::Element*           element      = nullptr;
+  Ply::Element::Property* property     = nullptr;
+  Ply::Element::Property::Type propertyType = Ply::Element::Property::Type::NONE;
+
+  bool swapBytes = (sameAsSystemEndian(ply.getDataType())==false);
+  bool wrlMode   = ply.getWrlMode();
+
+  nElements = ply.getNumberOfElements();
+  for(iElement=0;iElement<nElements;iElement++) {
+    element     = ply.getElement(iElement);
+    nProperties = element->getNumberOfProperties();
+    nRecords    = element->getNumberOfRecords();
+
+    // layout of the properties within each record; in wrlMode the
+    // FLOAT32_3 and FLOAT32_2 properties group several consecutive
+    // scalar properties of the file, and color components are stored
+    // in the file as one uchar each
+    vector<int>    nValues(nProperties,0);
+    vector<int>    nBytesValue(nProperties,0);
+    vector<bool>   isColorWrl(nProperties,false);
+    vector<size_t> nListValues(nProperties,0);
+    bool           fixedLayout = true;
+    nBytesRecord = 0;
+    for(iProperty=0;iProperty<nProperties;iProperty++) {
+      property     = element->getProperty(iProperty);
+      propertyType = property->getPropertyType();
+      if(property->isList()) {
+        fixedLayout = false;
+        nBytesValue[iProperty] = property->getPropertyTypeSize();
+      } else {
+        n =
+          (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
+          (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
+        isColorWrl[iProperty] = (wrlMode && property->getName()=="color");
+        nValues[iProperty]     = n;
+        nBytesValue[iProperty] =
+          (isColorWrl[iProperty])?1:property->getPropertyTypeSize()/n;
+        nBytesRecord += static_cast<size_t>(n*nBytesValue[iProperty]);
+      }
+    }
 
-      // APP->log(QString("%1    element %2 name = %3")
-      //          .arg(indent.c_str())
-      //          .arg(iElement)
-      //          .arg(name.c_str()));
+    if(fixedLayout) {
 
-      nProperties = element->getNumberOfProperties();
-      // APP->log(QString("%1      nProperties = %2")
-      //          .arg(indent.c_str())
-      //          .arg(nProperties));
+      // all the records have the same size; each property is
+      // decoded for all the records at once, as a strided copy
+      if(nBytesRecord>0 &&
+         static_cast<size_t>(end-p)<nBytesRecord*nRecords) {
+        char s[128];
+        snprintf(s,128,"end of file in record %d",
+                 static_cast<int>(static_cast<size_t>(end-p)/nBytesRecord));
+        throw new StrException(string(s));
+      }
+      offset = 0;
+      for(iProperty=0;iProperty<nProperties;iProperty++) {
+        property = element->getProperty(iProperty);
+        addBinaryValues(p+offset,nBytesRecord,nRecords,
+                        nValues[iProperty],nBytesValue[iProperty],
+                        property->getPropertyType(),isColorWrl[iProperty],
+                        swapBytes,property->getValue());
+        offset += static_cast<size_t>(nValues[iProperty]*
+                                      nBytesValue[iProperty]);
+      }
+      p += nBytesRecord*nRecords;
+
+    } else {
 
+      // 1) scan the records to validate them, and to determine the
+      //    total number of values of each list property
+      const char* q = p;
+      for(iRecord=0;iRecord<nRecords;iRecord++) {
+        for(iProperty=0;iProperty<nProperties;iProperty++) {
+          property = element->getProperty(iProperty);
+          if(property->isList()) {
+            nBytesNeeded = static_cast<size_t>(property->getListTypeSize());
+            if(static_cast<size_t>(end-q)>=nBytesNeeded) {
+              nList = getListCount(q,property->getListType(),swapBytes);
+              q += nBytesNeeded;
+              nListValues[iProperty] += static_cast<size_t>(nList);
+              nBytesNeeded =
+                static_cast<size_t>(nList)*nBytesValue[iProperty];
+            }
+          } else {
+            nBytesNeeded =
+              static_cast<size_t>(nValues[iProperty]*nBytesValue[iProperty]);
+          }
+          if(static_cast<size_t>(end-q)<nBytesNeeded) {
+            char s[128]; snprintf(s,128,"end of file in record %d",iRecord);
+            throw new StrException(string(s));
+          }
+          q += nBytesNeeded;
+        }
+      }
+
+      // 2) reserve space for all the values
       for(iProperty=0;iProperty<nProperties;iProperty++) {
-        property     = element->getProperty(iProperty);
-        propertyName = property->getName();
-        propertyType = property->getPropertyType();
-        if(property->isList()==true) {
-          listType = property->getListType();
-          // APP->log(QString("%1      property[%2] = %3:list(%4,%5)")
-          //          .arg(indent.c_str())
-          //          .arg(iProperty)
-          //          .arg(propertyName.c_str())
-          //          .arg(Ply::Element::Property::getTypeName(listType).c_str())
-          //          .arg(Ply::Element::Property::getTypeName(propertyType).c_str()));
-        } else {
-          // APP->log(QString("%1      property[%2] = %3:%4")
-          //          .arg(indent.c_str())
-          //          .arg(iProperty)
-          //          .arg(propertyName.c_str())
-          //          .arg(Ply::Element::Property::getTypeName(propertyType).c_str()));
+        property = element->getProperty(iProperty);
+        size_t nReserve =
+          static_cast<size_t>(nRecords)*nValues[iProperty];
+        if(property->isList()) {
+          property->reserveList(nRecords);
+          nReserve = nListValues[iProperty];
+          if(wrlMode && property->getName()=="coordIndex")
+            nReserve += static_cast<size_t>(nRecords);
         }
+        forEachValueType(property->getPropertyType(),property->getValue(),
+                         [&](auto& v) { v.reserve(v.size()+nReserve); });
       }
 
-      nRecords = element->getNumberOfRecords();
-      // APP->log(QString("%1      nRecords = %2")
-      //          .arg(indent.c_str())
-      //          .arg(nRecords));
-
-      k0 = 0;
+      // 3) decode the records
       for(iRecord=0;iRecord<nRecords;iRecord++) {
-        // nBytesRecord = 0;
         for(iProperty=0;iProperty<nProperties;iProperty++) {
+          property = element->getProperty(iProperty);
+          if(property->isList()) {
+            nList = getListCount(p,property->getListType(),swapBytes);
+            p += property->getListTypeSize();
+            const bool coordIndexWrl =
+              (wrlMode && property->getName()=="coordIndex");
+            property->pushBackList((coordIndexWrl)?nList+1:nList);
+            addBinaryValues(p,0,1,nList,nBytesValue[iProperty],
+                            property->getPropertyType(),false,
+                            swapBytes,property->getValue());
+            p += static_cast<size_t>(nList)*nBytesValue[iProperty];
+            if(coordIndexWrl)
+              static_cast<vector<int>*>(property->getValue())->push_back(-1);
+          } else {
+            addBinaryValues(p,0,1,nValues[iProperty],nBytesValue[iProperty],
+                            property->getPropertyType(),isColorWrl[iProperty],
+                            swapBytes,property->getValue());
+            p += static_cast<size_t>(nValues[iProperty]*
+                                     nBytesValue[iProperty]);
+          }
+        }
+      }
+    }
+  } // } for(iElement=0;iElement<nElements;iElement++)
 
-          property     = element->getProperty(iProperty);
-          propertyName = property->getName();
-          propertyType = property->getPropertyType();
-          value        = property->getValue();
+  // APP->log(QString(indent.c_str())+"} LoaderPly::readBinaryData()");
 
-          if(property->isList()) {
-            nBytesListCount = property->getListTypeSize();
-            nBytesListValue = property->getPropertyTypeSize();
+  return static_cast<size_t>(p-data);
+}
 
-            // number of elements in the list
+//////////////////////////////////////////////////////////////////////
+// static
+// parses nRecords records of the element, one per line, starting at
+// the current position of tkn; the values of each property are
+// appended to the vector value[iProperty], which has the type of the
+// property, and the length of each list of each list property is
+// appended to listLength[iProperty]; iRecord0 is the index of the
+// first record within the element, used in the error messages
+void LoaderPly::readAsciiRecords
+(TokenizerBuffer& tkn, Ply::Element& element,
+ const int iRecord0, const int nRecords,
+ vector<void*>& value, vector< vector<int> >& listLength) {
+
+  Ply::Element::Property* property;
+  Ply::Element::Property::Type propertyType = Ply::Element::Property::Type::NONE;
+  const char *line0,*line1,*token0,*token1;
+  int i,iProperty,iRecord,nList;
+
+  const int  nProperties = element.getNumberOfProperties();
+  const bool wrlMode     = element.ply().getWrlMode();
+
+  for(iRecord=iRecord0;iRecord<iRecord0+nRecords;iRecord++) {
+
+    // one record per line
+    if(tkn.getline(line0,line1)==false) {
+      char s[128]; snprintf(s,128,"found empty record %d",iRecord);
+      throw new StrException(string(s));
+    }
 
-            nBytesRead =
-              static_cast<int>
-              (fread(&(buff.c),1,static_cast<size_t>(nBytesListCount),fp));
+    TokenizerBuffer stkn(line0,static_cast<size_t>(line1-line0));
 
-            if(nBytesRead<nBytesListCount) {
-              char s[128]; snprintf(s,128,"end of file in record %d",iRecord);
-              throw new StrException(string(s));
-            }
+    for(iProperty=0;iProperty<nProperties;iProperty++) {
 
-            // nBytesRecord += nBytesRead;
-
-            nList = 0;
-            listType = property->getListType();
-            switch(listType) {
-            case Ply::Element::Property::Type::CHAR:
-            case Ply::Element::Property::Type::INT8:
-              nList = static_cast<int>(buff.c[0]&0xff);
-              break;
-            case Ply::Element::Property::Type::UCHAR:
-            case Ply::Element::Property::Type::UINT8:
-              nList = static_cast<int>(buff.uc[0]&0xff);
-              break;
-            case Ply::Element::Property::Type::SHORT:
-            case Ply::Element::Property::Type::INT16:
-              nList = static_cast<int>(buff.s[0]&0xff);
-              break;
-            case Ply::Element::Property::Type::USHORT:
-            case Ply::Element::Property::Type::UINT16:
-              nList = static_cast<int>(buff.us[0]&0xff);
-              break;
-            case Ply::Element::Property::Type::INT:
-            case Ply::Element::Property::Type::INT32:
-              nList = static_cast<int>(buff.i[0]&0xff);
-              break;
-            case Ply::Element::Property::Type::UINT:
-            case Ply::Element::Property::Type::UINT32:
-              nList = static_cast<int>(buff.ui[0]&0xff);
-              break;
-            default:
-              throw new StrException("unexpected list type");
-            }
+      property     = element.getProperty(iProperty);
+      propertyType = property->getPropertyType();
 
-            // ???
-            if(wrlMode && propertyName=="coordIndex")
-              property->pushBackList(nList+1);
-            else
-              property->pushBackList(nList);
+      if(property->isList()==true) {
 
-            // read nList values, each of length nBytesListValue
-
-            for(i=0;i<nList;i++) {
-              nBytesRead =
-                static_cast<int>
-                (fread(&(buff.c),1,static_cast<size_t>(nBytesListValue),fp));
-              if(nBytesRead<nBytesListValue) {
-                char s[128]; snprintf(s,128,"end of file in record %d",iRecord);
-                throw new StrException(string(s));
-              }
-
-              // nBytesRecord += nBytesRead;
-
-              addBinaryValue(buff,propertyType,swapBytes,value);
-            }
+        if(stkn.getToken(token0,token1)==false) {
+          char s[128];
+          snprintf(s,128,"end of line in property record %d",iRecord);
+          throw new StrException(string(s));
+        }
 
-            if(wrlMode && propertyName=="coordIndex")
-              static_cast<vector<int>*>(value)->push_back(-1);
-
-          } else /* if(property.isList()==false) */ {
-
-            nBytesValue = property->getPropertyTypeSize();
-            if(wrlMode) {
-              int n =
-                (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
-                (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
-            
-              if(propertyName=="color")
-                nBytesValue = 1;
-              else
-                nBytesValue /= n;
-
-              while((--n)>=0) {
-                nBytesRead =
-                  static_cast<int>
-                  (fread(&(buff.c),1,static_cast<size_t>(nBytesValue),fp));
-                if(nBytesRead<nBytesValue) {
-                  char s[128]; snprintf(s,128,"end of file in record %d",iRecord);
-                  throw new StrException(string(s));
-                }
-
-                // nBytesRecord += nBytesRead;
-
-                if(wrlMode && propertyName=="color") {
-                  vector<float>* colorValue = static_cast<vector<float>*>(value);
-                  colorValue->push_back(static_cast<float>(buff.uc[0])/255.0f);
-                } else {
-                  addBinaryValue(buff,propertyType,swapBytes,value);
-                }
-              }
-
-            } else {
-
-              nBytesRead =
-                static_cast<int>
-                (fread(&(buff.c),1,static_cast<size_t>(nBytesValue),fp));
-              if(nBytesRead<nBytesValue) {
-                char s[128]; snprintf(s,128,"end of file in record %d",iRecord);
-                throw new StrException(string(s));
-              }
-
-              // nBytesRecord += nBytesRead;
-
-              addBinaryValue(buff,propertyType,swapBytes,value);
-            }
-          }
+        nList = 0;
+        TokenizerBuffer::parseInt(token0,token1,nList);
 
-        } // for(iProperty=0;iProperty<nProperties;iProperty++)
+        // Sun Feb 26 17:31:14 2023 ???
+        const bool coordIndexWrl =
+          (wrlMode && property->getName()=="coordIndex");
+        listLength[iProperty].push_back((coordIndexWrl)?nList+1:nList);
 
-        // report progress
-        k1 = (10*(iRecord+1))/nRecords;
-        if(k1>k0) {
-          char s[128];
-          snprintf(s,128,"        %3d %%",10*k1);
-          // APP->log(QString(indent.c_str())+s);
-          k0 = k1;
+        for(i=0;i<nList;i++) {
+          if(stkn.getToken(token0,token1)==false) {
+            char s[128];
+            snprintf(s,128,"end of line in property record %d",iRecord);
+            throw new StrException(string(s));
+          }
+          addAsciiValue(token0,token1,propertyType,value[iProperty]);
         }
 
-      } // } for(iRecord=0;iRecord<nRecords;iRecord++)
-    } // } for(iElement=0;iElement<nElements;iElement++)
+        if(coordIndexWrl)
+          static_cast<vector<int>*>(value[iProperty])->push_back(-1);
 
-    long fp1 = ftell(fp);
-    nBytesData = static_cast<size_t>(fp1-fp0);
-  }
+      } else /* if(property.isList()==false) */ {
 
-  // APP->log(QString(indent.c_str())+"} LoaderPly::readBinaryData()");
+        int n =
+          (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
+          (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
+        const bool colorWrl = (wrlMode && property->getName()=="color");
 
-  return nBytesData;
+        while(--n>=0) {
+          if(stkn.getToken(token0,token1)==false) {
+            char s[128];
+            snprintf(s,128,"end of line in property record %d",iRecord);
+            throw new StrException(string(s));
+          }
+          addAsciiValue(token0,token1,propertyType,value[iProperty]);
+          if(colorWrl) {
+            static_cast<vector<float>*>(value[iProperty])->back() /= 255.0;
+          }
+        }
+      }
+    }
+  }
 }
-
+
+// returns a new empty vector of values of the given property type,
+// as a void pointer; see the Ply::Element::Property constructor
+static void* newValueVector(const Ply::Element::Property::Type propertyType) {
+  switch(propertyType) {
+  case Ply::Element::Property::CHAR:
+  case Ply::Element::Property::INT8:
+    return static_cast<void*>(new vector<char>());
+  case Ply::Element::Property::UCHAR:
+  case Ply::Element::Property::UINT8:
+    return static_cast<void*>(new vector<uchar>());
+  case Ply::Element::Property::SHORT:
+  case Ply::Element::Property::INT16:
+    return static_cast<void*>(new vector<short>());
+  case Ply::Element::Property::USHORT:
+  case Ply::Element::Property::UINT16:
+    return static_cast<void*>(new vector<ushort>());
+  case Ply::Element::Property::INT:
+  case Ply::Element::Property::INT32:
+    return static_cast<void*>(new vector<int>());
+  case Ply::Element::Property::UINT:
+  case Ply::Element::Property::UINT32:
+    return static_cast<void*>(new vector<uint>());
+  case Ply::Element::Property::FLOAT:
+  case Ply::Element::Property::FLOAT32:
+  case Ply::Element::Property::FLOAT32_2:
+  case Ply::Element::Property::FLOAT32_3:
+    return static_cast<void*>(new vector<float>());
+  case Ply::Element::Property::DOUBLE:
+  case Ply::Element::Property::FLOAT64:
+    return static_cast<void*>(new vector<double>());
+  case Ply::Element::Property::NONE:
+    break;
+  }
+  throw new StrException("unexpected NONE ascii value type");
+}
+
+// minimum number of records parsed by each thread
+static const int minRecordsPerThread = 1<<15;
+
 //////////////////////////////////////////////////////////////////////
 // static
-size_t LoaderPly::readAsciiData(FILE* fp, Ply& ply, const string indent) {
+// parses the ascii data from memory; data points to the first byte
+// after the header, and nBytes is the size of the rest of the file;
+// returns number of bytes parsed; the records of large elements are
+// split into chunks of consecutive lines, which are parsed in
+// parallel using the default number of threads (see util/Parallel.hpp)
+size_t LoaderPly::readAsciiData
+(const char* data, const size_t nBytes, Ply& ply, const string indent) {
 
   (void)indent;
 
   // APP->log(QString("%1LoaderPly::readAsciiData() {").arg(indent.c_str()));
 
-  size_t nBytes = 0;
-  if(fp) {
-    long fp0 = ftell(fp);
-    TokenizerFile ftkn(fp);
+  TokenizerBuffer ftkn(data,nBytes);
+
+  int nElements = ply.getNumberOfElements();
+  // APP->log(QString("%1  nElements = %2")
+  //          .arg(indent.c_str())
+  //          .arg(nElements));
+
+  Ply::Element* element;
+  Ply::Element::Property* property;
+  Ply::Element::Property::Type propertyType = Ply::Element::Property::Type::NONE;
+  const char *line0,*line1;
+  int iElement,iProperty,iRecord,iThread,nProperties,nRecords,nThreads;
+
+  for(iElement=0;iElement<nElements;iElement++) {
+    element     = ply.getElement(iElement);
+    nProperties = element->getNumberOfProperties();
+    nRecords    = element->getNumberOfRecords();
+    nThreads    =
+      Parallel::getNumberOfThreads(0,static_cast<size_t>(nRecords),
+                                   minRecordsPerThread);
+
+    if(nThreads<=1) {
+
+      // reserve space for the scalar properties, and for the list
+      // offsets; the number of list values is not known in advance
+      vector<void*>         value(nProperties);
+      vector< vector<int> > listLength(nProperties);
+      for(iProperty=0;iProperty<nProperties;iProperty++) {
+        property     = element->getProperty(iProperty);
+        propertyType = property->getPropertyType();
+        value[iProperty] = property->getValue();
+        int n =
+          (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
+          (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
+        if(property->isList())
+          listLength[iProperty].reserve(nRecords);
+        else
+          forEachValueType(propertyType,value[iProperty],[&](auto& v) {
+              v.reserve(v.size()+static_cast<size_t>(nRecords)*n);
+            });
+      }
 
-    int nElements = ply.getNumberOfElements();
-    // APP->log(QString("%1  nElements = %2")
-    //          .arg(indent.c_str())
-    //          .arg(nElements));
-
-    Ply::Element* element;
-    Ply::Element::Property* property;
-    // Ply::Element::Property::Type listType = Ply::Element::Property::Type::NONE;
-    Ply::Element::Property::Type propertyType = Ply::Element::Property::Type::NONE;
-    void* value;
-    string line,name,propertyName,token;
-    int i,iElement,iProperty,iRecord,k0,k1,nList,nProperties,nRecords;
-
-    bool wrlMode = ply.getWrlMode();
-
-    for(iElement=0;iElement<nElements;iElement++) {
-       element = ply.getElement(iElement);
-
-       name    = element->getName();
-       // APP->log(QString("%1    name =\"%2\"")
-       //          .arg(indent.c_str())
-       //          .arg(name.c_str()));
-
-       nProperties = element->getNumberOfProperties();
-       // APP->log(QString("%1      nProperties = %2")
-       //          .arg(indent.c_str())
-       //          .arg(nProperties));
-
-       nRecords = element->getNumberOfRecords();
-       // APP->log(QString("%1      nRecords = %2")
-       //          .arg(indent.c_str())
-       //          .arg(nRecords));
-
-       k0 = 0;
-       for(iRecord=0;iRecord<nRecords;iRecord++) {
-
-          // one record per line
-          if(ftkn.getline()==false) {
-            char s[128]; snprintf(s,128,"found empty record %d",iRecord);
-            throw new StrException(string(s));
-          }
+      readAsciiRecords(ftkn,*element,0,nRecords,value,listLength);
 
-          TokenizerString stkn(ftkn);
-
-          for(iProperty=0;iProperty<nProperties;iProperty++) {
-
-            property     = element->getProperty(iProperty);
-            propertyName = property->getName();
-            propertyType = property->getPropertyType();
-  
-            if(property->isList()==true) {
- 
-              nList = 0;
-
-              if(stkn.get()==false) {
-                char s[128];
-                snprintf(s,128,"end of line in property record %d",iRecord);
-                throw new StrException(string(s));
-              }
-
-              nList = atoi(stkn.c_str());
-
-              // Sun Feb 26 17:31:14 2023 ???
-              if(wrlMode && propertyName=="coordIndex")
-                property->pushBackList(nList+1);
-              else
-                property->pushBackList(nList);
- 
-              value = property->getValue();
-  
-               for(i=0;i<nList;i++) {
-                 if(stkn.get()==false) {
-                   char s[128];
-                   snprintf(s,128,"end of line in property record %d",iRecord);
-                   throw new StrException(string(s));
-                 }
-                 addAsciiValue(stkn,propertyType,value);
-               }
-
-               if(wrlMode && propertyName=="coordIndex")
-                 static_cast<vector<int>*>(value)->push_back(-1);
-
-            } else /* if(property.isList()==false) */ {
-
-              value = property->getValue();
- 
-              int n =
-                (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
-                (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
-
-              while(--n>=0) {
-                if(stkn.get()==false) {
-                  char s[128];
-                  snprintf(s,128,"end of line in property record %d",iRecord);
-                  throw new StrException(string(s));
-                }
-                addAsciiValue(stkn,propertyType,value);
-                if(wrlMode && propertyName=="color") {
-                    static_cast<vector<float>*>(value)->back() /= 255.0;
-                }
-              }
-            }
-          }
+      for(iProperty=0;iProperty<nProperties;iProperty++) {
+        property = element->getProperty(iProperty);
+        if(property->isList()==false) continue;
+        property->reserveList(nRecords);
+        for(int nList : listLength[iProperty])
+          property->pushBackList(nList);
+      }
 
-          // report progress
-          k1 = (10*(iRecord+1))/nRecords;
-          if(k1>k0) {
-            char s[128];
-            snprintf(s,128,"        %3d %%",10*k1);
-            // APP->log(QString(indent.c_str())+s);
-            k0 = k1;
-          }
+      continue;
+    }
+
+    // 1) locate the first line of each chunk of records
+    vector<const char*> chunkBegin(nThreads+1);
+    iRecord = 0;
+    for(iThread=0;iThread<=nThreads;iThread++) {
+      const int iRecord1 =
+        static_cast<int>(Parallel::rangeBegin(nThreads,nRecords,iThread));
+      for(;iRecord<iRecord1;iRecord++)
+        ftkn.getline(line0,line1);
+      chunkBegin[iThread] = data+ftkn.getPosition();
+    }
 
-      } // for(iRecord=0;iRecord<nRecords;iRecord++)
-    } // for(iElement=0;iElement<nElements;iElement++)
+    // 2) parse the chunks concurrently into separate vectors; an
+    //    exception thrown in a chunk is rethrown by forEachRange after
+    //    all the chunks are done; since each chunk stops at its first
+    //    error, the first exception found is the one the serial parser
+    //    would have thrown
+    vector< vector<void*> >         chunkValue(nThreads);
+    vector< vector< vector<int> > > chunkListLength(nThreads);
+    exception_ptr                   error;
+    try {
+      Parallel::forEachRange
+        (nThreads,static_cast<size_t>(nRecords),
+         [&](int iT, size_t iRecord0, size_t iRecord1) {
+          vector<void*>&         value      = chunkValue[iT];
+          vector< vector<int> >& listLength = chunkListLength[iT];
+          value.assign(nProperties,nullptr);
+          listLength.resize(nProperties);
+          for(int iP=0;iP<nProperties;iP++)
+            value[iP] =
+              newValueVector(element->getProperty(iP)->getPropertyType());
+          TokenizerBuffer tkn(chunkBegin[iT],
+                              static_cast<size_t>(chunkBegin[iT+1]-
+                                                  chunkBegin[iT]));
+          readAsciiRecords(tkn,*element,static_cast<int>(iRecord0),
+                           static_cast<int>(iRecord1-iRecord0),
+                           value,listLength);
+        });
+    } catch(...) {
+      error = current_exception();
+    }
+
+    // 3) concatenate the chunks in order; the chunks are deleted
+    //    whether or not an exception was thrown
+    for(iProperty=0;iProperty<nProperties;iProperty++) {
+      property     = element->getProperty(iProperty);
+      propertyType = property->getPropertyType();
+      if(error==nullptr && property->isList())
+        property->reserveList(nRecords);
+      for(iThread=0;iThread<nThreads;iThread++) {
+        if(static_cast<int>(chunkValue[iThread].size())<=iProperty) continue;
+        void* chunk = chunkValue[iThread][iProperty];
+        if(chunk==nullptr) continue;
+        forEachValueType
+          (propertyType,property->getValue(),[&](auto& v) {
+            auto* c = static_cast<decltype(&v)>(chunk);
+            if(error==nullptr) v.insert(v.end(),c->begin(),c->end());
+            delete c;
+          });
+        if(error==nullptr)
+          for(int nList : chunkListLength[iThread][iProperty])
+            property->pushBackList(nList);
+      }
+    }
+    if(error) rethrow_exception(error);
+
+  } // for(iElement=0;iElement<nElements;iElement++)
 
-    long fp1 = ftell(fp);
-    nBytes = static_cast<size_t>(fp1-fp0);
-  }
   // APP->log(QString(indent.c_str())+"} LoaderPly::readAsciiData()");
-  return nBytes;
+  return ftkn.getPosition();
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -825,33 +955,45 @@ bool LoaderPly::load(const char* filename, Ply & ply, const string indent) {
     // size_t nBytesData   = 0;
 
     if(ply.getDataType()==Ply::DataType::ASCII) {
-      // continue reading ascii data from the same FileInputStream
-      /* nBytesData = */ readAsciiData(fp,ply,indent+"  ");
+
+      fclose(fp);
+      fp = nullptr;
+
+      // map the whole file, and parse the data in place
+      MappedFile file;
+      if(file.open(filename)==false)
+        throw new StrException("unable to open file to read ascii data");
+      if(file.getSize()<nBytesHeader)
+        throw new StrException("failed to skip header to read ascii data");
+
+      /* nBytesData = */
+      readAsciiData(file.getData()+nBytesHeader,file.getSize()-nBytesHeader,
+                    ply,indent+"  ");
 
       // APP->log(QString("%1  nBytesData(ASCII) = %2")
       //          .arg(indent.c_str())
       //          .arg(nBytesData));
 
-      fclose(fp);
     } else /* if(ply.getDataType()==Ply::DataType::BINARY_LITTLE_ENDIAN ::
                  ply.getDataType()==Ply::DataType::BINARY_BIG_ENDIAN) */ {
 
       fclose(fp);
-      fp = fopen(filename,"rb");
-      if(fp==nullptr)
-        throw new StrException("unable to open file to read binary data");
+      fp = nullptr;
 
-      // skip header
-      if(fseek(fp,static_cast<long>(nBytesHeader),SEEK_SET)!=0)
+      // map the whole file, and decode the data in place
+      MappedFile file;
+      if(file.open(filename)==false)
+        throw new StrException("unable to open file to read binary data");
+      if(file.getSize()<nBytesHeader)
         throw new StrException("failed to skip header to read binary data");
 
-      /* nBytesData = */ readBinaryData(fp,ply,indent+"  ");
+      /* nBytesData = */
+      readBinaryData(file.getData()+nBytesHeader,file.getSize()-nBytesHeader,
+                     ply,indent+"  ");
 
       // APP->log(QString("%1  nBytesData(BINARY) = %2")
       //          .arg(indent.c_str())
       //          .arg(nBytesData));
-
-      fclose(fp);
     }
     
     // APP->log(QString("%1  nBytesRead = %2")
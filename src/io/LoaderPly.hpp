@@ -43,6 +43,7 @@
 #define _LOADER_PLY_HPP_
 
 #include "Loader.hpp"
+#include "TokenizerBuffer.hpp"
 #include <util/Endian.hpp>
 #include <wrl/Ply.hpp>
 #include <wrl/SceneGraph.hpp>
@@ -68,20 +69,36 @@ private:
   static Ply::DataType systemEndian();
   static bool          sameAsSystemEndian(Ply::DataType fileEndian);
 
-  static void addBinaryValue
-  (Endian::SingleValueBuffer& buff,
+  static int  getListCount
+  (const char* b,
+   const Ply::Element::Property::Type listType,
+   const bool swapBytes);
+
+  static void addBinaryValues
+  (const char* src,
+   const size_t stride,
+   const int nRecords,
+   const int nValues,
+   const int nBytesValue,
    const Ply::Element::Property::Type propertyType,
+   const bool colorWrl,
    const bool swapBytes,
    void* value);
   
   static void addAsciiValue
-  (const string& token,
+  (const char* begin, const char* end,
    const Ply::Element::Property::Type propertyType,
    void* value);
   
   static size_t readHeader(FILE* fp, Ply& ply, const string indent="");
-  static size_t readBinaryData(FILE* fp, Ply& ply, const string indent="");
-  static size_t readAsciiData(FILE* fp, Ply& ply, const string indent="");
+  static size_t readBinaryData
+  (const char* data, const size_t nBytes, Ply& ply, const string indent="");
+  static size_t readAsciiData
+  (const char* data, const size_t nBytes, Ply& ply, const string indent="");
+  static void   readAsciiRecords
+  (TokenizerBuffer& tkn, Ply::Element& element,
+   const int iRecord0, const int nRecords,
+   vector<void*>& value, vector< vector<int> >& listLength);
 
 };
 
@@ -43,6 +43,9 @@
 
 #include <cstdio>
 #include <cstring>
+#include <cstdint>
+#include <climits>
+#include <cmath>
 #include "TokenizerFile.hpp"
 #include "LoaderStl.hpp"
 #include "StrException.hpp"
@@ -52,11 +55,207 @@
 #include "wrl/Material.hpp"
 #include "wrl/IndexedFaceSet.hpp"
 
+#include "util/Endian.hpp"
+#include "util/MappedFile.hpp"
+#include "util/Parallel.hpp"
+
 // reference
 // https://en.wikipedia.org/wiki/STL_(file_format)
 
 const char* LoaderStl::_ext = "stl";
 
+bool  LoaderStl::_weldVertices = false;
+float LoaderStl::_weldEpsilon  = 0.0f;
+
+// static
+void LoaderStl::setWeldVertices(const bool value) {
+  _weldVertices = value;
+}
+
+// static
+bool LoaderStl::getWeldVertices() {
+  return _weldVertices;
+}
+
+// static
+void LoaderStl::setWeldEpsilon(const float epsilon) {
+  _weldEpsilon = (epsilon>0.0f)?epsilon:0.0f;
+}
+
+// static
+float LoaderStl::getWeldEpsilon() {
+  return _weldEpsilon;
+}
+
+// key used to compare vertex coordinates; the bit pattern of the
+// value if epsilon==0, and the index of the grid cell otherwise
+static int64_t weldKey(const float x, const float epsilon) {
+  if(epsilon>0.0f) {
+    double q = floor(static_cast<double>(x)/static_cast<double>(epsilon));
+    if(!(q> -4.0e18)) q = -4.0e18; // also NaN
+    if(!(q<  4.0e18)) q =  4.0e18;
+    return static_cast<int64_t>(q);
+  }
+  if(x==0.0f) return 0; // 0.0f and -0.0f
+  uint32_t b;
+  memcpy(&b,&x,sizeof(b));
+  return static_cast<int64_t>(b);
+}
+
+// the number of triangles of a binary STL file is stored as a little
+// endian uint32 after the 80 bytes header
+static size_t getNumberOfTriangles(const char* data) {
+  const unsigned char* b = reinterpret_cast<const unsigned char*>(data+80);
+  return
+    static_cast<size_t>(b[0])       |
+    (static_cast<size_t>(b[1])<< 8) |
+    (static_cast<size_t>(b[2])<<16) |
+    (static_cast<size_t>(b[3])<<24);
+}
+
+// static
+void LoaderStl::_weld
+(vector<float>& coord, vector<float>& normal, vector<int>& coordIndex,
+ const float epsilon) {
+
+  const size_t nV = coord.size()/3;
+  if(nV==0) return;
+  const int nT = Parallel::getNumberOfThreads(0,nV,1<<16);
+
+  // 1) key and hash value of each vertex
+  vector<int64_t>  key(3*nV);
+  vector<uint64_t> hash(nV);
+  Parallel::forEachRange(nT,nV,[&](int, size_t i0, size_t i1) {
+      for(size_t i=i0;i<i1;i++) {
+        uint64_t h = 0;
+        for(size_t j=0;j<3;j++) {
+          key[3*i+j] = weldKey(coord[3*i+j],epsilon);
+          h = (h^static_cast<uint64_t>(key[3*i+j]))*0x9e3779b97f4a7c15ull;
+        }
+        hash[i] = h^(h>>29);
+      }
+    });
+
+  // 2) the vertices are bucketed by partition, hash%nP, with a
+  //    counting sort; each range of vertices is counted and scattered
+  //    by its own thread, and the ranges are laid out in order within
+  //    each bucket, so that every bucket lists its vertices in
+  //    increasing order
+  const size_t nP = static_cast<size_t>(nT);
+  vector<size_t> pos(nP*nP,0); // pos[iT*nP+p] : range iT, bucket p
+  Parallel::forEachRange(nT,nV,[&](int iT, size_t i0, size_t i1) {
+      size_t* count = &pos[iT*nP];
+      for(size_t i=i0;i<i1;i++) count[hash[i]%nP]++;
+    });
+  vector<size_t> firstInBucket(nP+1,0);
+  size_t offset = 0;
+  for(size_t iP=0;iP<nP;iP++) {
+    firstInBucket[iP] = offset;
+    for(size_t jT=0;jT<nP;jT++) {
+      const size_t n = pos[jT*nP+iP];
+      pos[jT*nP+iP] = offset;
+      offset += n;
+    }
+  }
+  firstInBucket[nP] = offset;
+  vector<int> bucket(nV);
+  Parallel::forEachRange(nT,nV,[&](int iT, size_t i0, size_t i1) {
+      size_t* next = &pos[iT*nP];
+      for(size_t i=i0;i<i1;i++)
+        bucket[next[hash[i]%nP]++] = static_cast<int>(i);
+    });
+
+  // 3) each thread dedupes one bucket in its own open addressing
+  //    hash table, without locks; visiting the vertices in order,
+  //    firstV[iV] is the first vertex with the same key as vertex iV
+  vector<int> firstV(nV);
+  Parallel::forEachRange(nT,nP,[&](int, size_t p0, size_t p1) {
+      for(size_t p=p0;p<p1;p++) {
+        const size_t b0 = firstInBucket[p], b1 = firstInBucket[p+1];
+        size_t size = 16;
+        while(size<2*(b1-b0)) size <<= 1;
+        const size_t mask = size-1;
+        vector<int> table(size,-1);
+        for(size_t b=b0;b<b1;b++) {
+          const size_t i = static_cast<size_t>(bucket[b]);
+          size_t s = static_cast<size_t>(hash[i]/nP)&mask;
+          for(;;s=(s+1)&mask) {
+            const int j = table[s];
+            if(j<0) {
+              table[s] = static_cast<int>(i);
+              firstV[i] = static_cast<int>(i);
+              break;
+            }
+            const size_t uj = static_cast<size_t>(j);
+            if(hash[uj]==hash[i]     &&
+               key[3*uj  ]==key[3*i  ] &&
+               key[3*uj+1]==key[3*i+1] &&
+               key[3*uj+2]==key[3*i+2]) {
+              firstV[i] = j;
+              break;
+            }
+          }
+        }
+      }
+    });
+
+  // 4) the faces with two corners on the same welded vertex have
+  //    collapsed, and would make the mesh singular; they are removed
+  //    from coordIndex, along with their normals when there is one
+  //    normal per face; coordIndex temporarily holds the first
+  //    vertex of each corner
+  const size_t nC = coordIndex.size();
+  const size_t nF = nC/4;
+  const bool normalPerFace = (normal.size()==3*nF);
+  vector<bool> used(nV,false);
+  size_t iF,nFnew = 0;
+  for(iF=0;iF<nF;iF++) {
+    const int iV0 = firstV[static_cast<size_t>(coordIndex[4*iF  ])];
+    const int iV1 = firstV[static_cast<size_t>(coordIndex[4*iF+1])];
+    const int iV2 = firstV[static_cast<size_t>(coordIndex[4*iF+2])];
+    if(iV0==iV1 || iV1==iV2 || iV2==iV0) continue;
+    used[static_cast<size_t>(iV0)] = true;
+    used[static_cast<size_t>(iV1)] = true;
+    used[static_cast<size_t>(iV2)] = true;
+    coordIndex[4*nFnew  ] = iV0;
+    coordIndex[4*nFnew+1] = iV1;
+    coordIndex[4*nFnew+2] = iV2;
+    coordIndex[4*nFnew+3] = -1;
+    if(normalPerFace && nFnew<iF) {
+      normal[3*nFnew  ] = normal[3*iF  ];
+      normal[3*nFnew+1] = normal[3*iF+1];
+      normal[3*nFnew+2] = normal[3*iF+2];
+    }
+    nFnew++;
+  }
+  coordIndex.resize(4*nFnew);
+  if(normalPerFace) normal.resize(3*nFnew);
+
+  // 5) number the distinct vertices used by the remaining faces in
+  //    the order in which they were first loaded, and move their
+  //    coordinates to the front
+  vector<int> vertexMap(nV,-1);
+  size_t iV,nVnew = 0;
+  for(iV=0;iV<nV;iV++) {
+    if(used[iV]==false) continue;
+    vertexMap[iV] = static_cast<int>(nVnew);
+    coord[3*nVnew  ] = coord[3*iV  ];
+    coord[3*nVnew+1] = coord[3*iV+1];
+    coord[3*nVnew+2] = coord[3*iV+2];
+    nVnew++;
+  }
+  coord.resize(3*nVnew);
+  coord.shrink_to_fit();
+
+  // 6) replace the vertex indices
+  Parallel::forEachRange(nT,coordIndex.size(),[&]
+                         (int, size_t i0, size_t i1) {
+      for(size_t i=i0;i<i1;i++)
+        if(coordIndex[i]>=0)
+          coordIndex[i] = vertexMap[static_cast<size_t>(coordIndex[i])];
+    });
+}
+
 IndexedFaceSet* LoaderStl::_initializeSceneGraph
 (const char* filename, SceneGraph& wrl) {
   // 0) clear the container
@@ -119,23 +318,6 @@ bool LoaderStl::_loadFacetAscii
   return true;
 }
 
-bool LoaderStl::_loadFacetBinary
-(FILE* fp, Vec3f& n, Vec3f& v1, Vec3f& v2, Vec3f& v3, uint16_t* abc) {
-
-  if(fread(&(n[0]),1,12,fp)<12)
-    throw new StrException("unable to read normal vector");
-  if(fread(&(v1[0]),1,12,fp)<12)
-    throw new StrException("unable to read vertex 0");
-  if(fread(&(v2[0]),1,12,fp)<12)
-    throw new StrException("unable to read vertex 1");
-  if(fread(&(v3[0]),1,12,fp)<12)
-    throw new StrException("unable to read vertex 2");
-  if(fread(abc,1,2,fp)<2)
-    throw new StrException("unable to read atribute byte count");
-
-  return true;
-}
-
 bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
   bool success = false;
 
@@ -144,65 +326,74 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
     // open the file
     if(filename==(char*)0) throw new StrException("filename==null");
 
-    // allocate binary header and initialize to zero
-    char header[80];
-    memset(header,0x00,80);
-    // determine if file is ascii or binary
-    fp = fopen(filename,"rb");
-    if(fp==(FILE*)0)
+    // the whole file is mapped into memory
+    MappedFile file;
+    if(file.open(filename)==false)
       throw new StrException("unable to open file for binary read");
-    if(fread(header,1,5,fp)<5)
+    if(file.getSize()<5)
       throw new StrException("unable to read first characters of file");
-    bool binary = (strncmp(header,"solid",5)!=0);
+    const char*  data = file.getData();
+    const size_t size = file.getSize();
+
+    // determine if file is ascii or binary; some binary files also
+    // start with "solid", in which case the file size decides
+    bool binary = (strncmp(data,"solid",5)!=0);
+    if(binary==false && size>=84) {
+      const size_t nTriangles = getNumberOfTriangles(data);
+      binary = (size==84+50*nTriangles);
+    }
+
     if(binary) {
-      // read the rest of the header
-      if(fread(header+5,1,75,fp)<75)
-        throw new StrException("unable to read 75 next characters of file");
-      // read number of triangles
-      uint32_t nTriangles = 0;
-      if(fread(&nTriangles,1,4,fp)<4)
+      // 80 bytes header, followed by the number of triangles
+      if(size<84)
         throw new StrException("unable to read number of triangles");
+      const size_t nTriangles = getNumberOfTriangles(data);
+      if(size<84+50*nTriangles)
+        throw new StrException("file too short for the number of triangles");
+      if(3*nTriangles>static_cast<size_t>(INT_MAX))
+        throw new StrException("too many triangles");
 
       IndexedFaceSet* ifs = _initializeSceneGraph(filename,wrl);
       // get references to the coordIndex, coord, and normal arrays
       vector<int>& coordIndex = ifs->getCoordIndex();
       vector<float>& coord    = ifs->getCoord();
       vector<float>& normal   = ifs->getNormal();
-      // 6) set the normalPerVertex variable to false (i.e., normals per face)  
+      // set the normalPerVertex variable to false (i.e., normals per face)
       ifs->setNormalPerVertex(false);
 
-      int   iV0,iV1,iV2,iT;
-      Vec3f n,v1,v2,v3;
-      uint16_t abc; // attribute byte count
-        for(iT=0;iT<static_cast<int>(nTriangles);iT++) {
-        _loadFacetBinary(fp,n,v1,v2,v3,&abc);
-        normal.push_back(n[0]);
-        normal.push_back(n[1]);
-        normal.push_back(n[2]);
-        iV0 = static_cast<int>(coord.size()/3);
-        coord.push_back(v1[0]);
-        coord.push_back(v1[1]);
-        coord.push_back(v1[2]);
-        iV1 = static_cast<int>(coord.size()/3);
-        coord.push_back(v2[0]);
-        coord.push_back(v2[1]);
-        coord.push_back(v2[2]);
-        iV2 = static_cast<int>(coord.size()/3);
-        coord.push_back(v3[0]);
-        coord.push_back(v3[1]);
-        coord.push_back(v3[2]);
-        coordIndex.push_back(iV0);
-        coordIndex.push_back(iV1);
-        coordIndex.push_back(iV2);
-        coordIndex.push_back(-1);
-      }
+      // each facet is a 50 bytes record : the normal vector, the
+      // three vertices, and the attribute byte count, which is
+      // ignored; the records are decoded in parallel ranges, straight
+      // into the arrays, which are allocated up front
+      normal.resize(3*nTriangles);
+      coord.resize(9*nTriangles);
+      coordIndex.resize(4*nTriangles);
+      const bool swapBytes = (Endian::isLittleEndianSystem()==false);
+      const int nT = Parallel::getNumberOfThreads(0,nTriangles,1<<14);
+      Parallel::forEachRange(nT,nTriangles,[&](int, size_t i0, size_t i1) {
+          const char* facet = data+84+50*i0;
+          for(size_t iT=i0;iT<i1;iT++,facet+=50) {
+            memcpy(&normal[3*iT],facet   ,12);
+            memcpy(&coord [9*iT],facet+12,36);
+            const int iV = static_cast<int>(3*iT);
+            coordIndex[4*iT  ] = iV;
+            coordIndex[4*iT+1] = iV+1;
+            coordIndex[4*iT+2] = iV+2;
+            coordIndex[4*iT+3] = -1;
+          }
+          if(swapBytes && i1>i0) {
+            Endian::swapArray(&normal[3*i0],3*(i1-i0),4);
+            Endian::swapArray(&coord [9*i0],9*(i1-i0),4);
+          }
+        });
+
+      if(_weldVertices) _weld(coord,normal,coordIndex,_weldEpsilon);
       
       success = true;
 
-      fclose(fp);
     } else /* if(ascii) */ {
-      // close the binary file and reopen it
-      fclose(fp);
+      // unmap the file and reopen it
+      file.close();
       fp = fopen(filename,"r");
       if(fp==(FILE*)0)
         throw new StrException("unable to open ASCII STL file");
@@ -250,6 +441,8 @@ bool LoaderStl::load(const char* filename, SceneGraph& wrl) {
         coordIndex.push_back(-1);
       }
 
+      if(_weldVertices) _weld(coord,normal,coordIndex,_weldEpsilon);
+
       success = true;
 
       // close the file (this statement may not be reached)
@@ -57,16 +57,33 @@ public:
   bool  load(const char* filename, SceneGraph& wrl);
   const char* ext() const { return _ext; }
 
+  // STL files store three separate vertices per facet; if vertex
+  // welding is enabled, the vertices are merged after loading, so
+  // that the faces share vertex indices; with epsilon==0 only
+  // vertices with identical coordinates are merged; with epsilon>0
+  // the coordinates are quantized to a grid of cells of side
+  // epsilon, and the vertices within each cell are merged into the
+  // first one loaded; facets left with two corners on the same
+  // vertex are removed, along with their normals
+  static void  setWeldVertices(const bool value);
+  static bool  getWeldVertices();
+  static void  setWeldEpsilon(const float epsilon);
+  static float getWeldEpsilon();
+
 private:
 
+  static bool  _weldVertices;
+  static float _weldEpsilon;
+
+  static void _weld
+  (vector<float>& coord, vector<float>& normal, vector<int>& coordIndex,
+   const float epsilon);
+
   IndexedFaceSet* _initializeSceneGraph(const char* filename, SceneGraph& wrl);
 
   bool _loadFacetAscii
   (TokenizerFile& tkn, Vec3f& n, Vec3f& v1, Vec3f& v2, Vec3f& v3);
 
-  bool _loadFacetBinary
-  (FILE* fp, Vec3f& n, Vec3f& v1, Vec3f& v2, Vec3f& v3, uint16_t* abc);
-
 };
 
 #endif /* _LOADER_STL_HPP_ */
@@ -33,9 +33,10 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <stdio.h>
-#include "TokenizerFile.hpp"
+#include "TokenizerBuffer.hpp"
 #include "LoaderWrl.hpp"
 #include "StrException.hpp"
+#include <util/MappedFile.hpp>
 #include <wrl/IndexedLineSetVariables.hpp>
 #include <wrl/IndexedFaceSetVariables.hpp>
 
@@ -686,38 +687,15 @@ bool LoaderWrl::loadIndexedLineSet(Tokenizer& tkn, IndexedLineSet& ils) {
 }
 
 bool LoaderWrl::loadVecFloat(Tokenizer&tkn,vector<float>& vec) {
-  bool success = false;
   if(tkn.expecting("[")==false) throw new StrException("expecting \"[\"");
   vec.clear();
-  float value;
-  while(success==false && tkn.get()) {
-    if(tkn.equals("]")) {
-      success = true; // done
-    } else if(sscanf(tkn.c_str(),"%f",&value)==1) {
-      vec.push_back(value);
-    } else {
-      throw new StrException("expecting int value");
-    }
-  }
-
-  return success;
+  return tkn.getVecFloat(vec);
 }
 
 bool LoaderWrl::loadVecInt(Tokenizer&tkn,vector<int>& vec) {
-  bool success = false;
   if(tkn.expecting("[")==false) throw new StrException("expecting \"[\"");
   vec.clear();
-  int value;
-  while(success==false && tkn.get()) {
-    if(tkn.equals("]")) {
-      success = true; // done
-    } else if(sscanf(tkn.c_str(),"%d",&value)==1) {
-      vec.push_back(value);
-    } else {
-      throw new StrException("expecting int value");
-    }
-  }
-  return success;
+  return tkn.getVecInt(vec);
 }
 
 bool LoaderWrl::loadVecString(Tokenizer&tkn,vector<string>& vec) {
@@ -745,13 +723,12 @@ bool LoaderWrl::loadVecString(Tokenizer&tkn,vector<string>& vec) {
 bool LoaderWrl::load(const char* filename, SceneGraph& wrl) {
   bool success = false;
 
-  FILE* fp = (FILE*)0;
+  MappedFile file;
   try {
 
-    // open the file
+    // map the file
     if(filename==(char*)0) throw new StrException("filename==null");
-    fp = fopen(filename,"r");
-    if(fp==(FILE*)0) throw new StrException("fp==(FILE*)0");
+    if(file.open(filename)==false) throw new StrException("cannot open file");
 
     // clear the container
     wrl.clear();
@@ -761,23 +738,22 @@ bool LoaderWrl::load(const char* filename, SceneGraph& wrl) {
     char header[16];
     // memset(header,'\0',16);
     for(int i=0;i<16;i++) header[i] = '\0';
-    fscanf(fp,"%15c",header);
+    size_t nHeader = (file.getSize()<15)?file.getSize():15;
+    for(size_t i=0;i<nHeader;i++) header[i] = file.getData()[i];
     if(string(header)!=VRML_HEADER) throw new StrException("header!=VRM_HEADER");
 
-    // create a Tokenizer and start parsing
-    TokenizerFile tkn(fp);
+    // create a Tokenizer on the rest of the file and start parsing
+    TokenizerBuffer tkn(file.getData()+nHeader,file.getSize()-nHeader);
     loadSceneGraph(tkn,wrl);
 
     // will be done later
     // wrl.updateBBox();
     
     // if we have reached this point we have succeeded
-    fclose(fp);
     success = true;
 
   } catch(StrException* e) { 
 
-    if(fp!=(FILE*)0) fclose(fp);
     fprintf(stderr,"ERROR | %s\n",e->what());
     delete e;
     wrl.clear();
@@ -787,4 +763,3 @@ bool LoaderWrl::load(const char* filename, SceneGraph& wrl) {
 
   return success;
 }
-
@@ -0,0 +1,125 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// SaverDgp.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+#include <cstdio>
+#include "SaverDgp.hpp"
+#include "util/DgpFile.hpp"
+#include "StrException.hpp"
+
+#include "wrl/Shape.hpp"
+#include "wrl/Appearance.hpp"
+#include "wrl/Material.hpp"
+#include "wrl/IndexedFaceSet.hpp"
+
+const char* SaverDgp::_ext = "dgp";
+
+bool SaverDgp::save(const char* filename, SceneGraph& wrl) const {
+  bool success = false;
+  try {
+    // Check these conditions
+    if(filename==(char*)0)
+      throw new StrException("empty filename");
+    // 1) the SceneGraph should have a single child
+    if(wrl.getNumberOfChildren()!=1)
+      throw new StrException("number of SceneGraph children != 1");
+    // 2) the child should be a Shape node
+    Shape* shape = dynamic_cast<Shape*>(wrl[0]);
+    if(shape==(Shape*)0)
+      throw new StrException("first SceneGraph child not a Shape node");
+    // 3) the geometry of the Shape node should be an IndexedFaceSet node
+    IndexedFaceSet* ifs = dynamic_cast<IndexedFaceSet*>(shape->getGeometry());
+    if(ifs==(IndexedFaceSet*)0)
+      throw new StrException("Shape geometry not an IndexedFaceSet");
+
+    DgpFile file;
+
+    if(shape->getName()!="")
+      file.addSection("name",shape->getName());
+
+    vector<int> flags(5,0);
+    flags[0] = (ifs->getCcw())?1:0;
+    flags[1] = (ifs->getConvex())?1:0;
+    flags[2] = (ifs->getSolid())?1:0;
+    flags[3] = (ifs->getNormalPerVertex())?1:0;
+    flags[4] = (ifs->getColorPerVertex())?1:0;
+    file.addSection("flags",flags);
+    vector<float> creaseAngle(1,ifs->getCreaseAngle());
+    file.addSection("creaseAngle",creaseAngle);
+
+    vector<float> diffuseColor;
+    Appearance* appearance = dynamic_cast<Appearance*>(shape->getAppearance());
+    Material* material = (appearance!=(Appearance*)0)?
+      dynamic_cast<Material*>(appearance->getMaterial()):(Material*)0;
+    if(material!=(Material*)0) {
+      Color& c = material->getDiffuseColor();
+      diffuseColor.push_back(c.r);
+      diffuseColor.push_back(c.g);
+      diffuseColor.push_back(c.b);
+      file.addSection("diffuseColor",diffuseColor);
+    }
+
+    file.addSection("coord",ifs->getCoord());
+    file.addSection("coordIndex",ifs->getCoordIndex());
+    if(ifs->getNormal().size()>0)
+      file.addSection("normal",ifs->getNormal());
+    if(ifs->getNormalIndex().size()>0)
+      file.addSection("normalIndex",ifs->getNormalIndex());
+    if(ifs->getColor().size()>0)
+      file.addSection("color",ifs->getColor());
+    if(ifs->getColorIndex().size()>0)
+      file.addSection("colorIndex",ifs->getColorIndex());
+    if(ifs->getTexCoord().size()>0)
+      file.addSection("texCoord",ifs->getTexCoord());
+    if(ifs->getTexCoordIndex().size()>0)
+      file.addSection("texCoordIndex",ifs->getTexCoordIndex());
+
+    if(file.save(filename)==false)
+      throw new StrException("unable to write DGP file");
+
+    success = true;
+
+  } catch(StrException* e) {
+
+    fprintf(stderr,"SaverDgp | ERROR | %s\n",e->what());
+    delete e;
+
+  }
+  return success;
+}
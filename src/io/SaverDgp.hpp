@@ -0,0 +1,79 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// SaverDgp.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+#ifndef _SAVER_DGP_HPP_
+#define _SAVER_DGP_HPP_
+
+#include "Saver.hpp"
+
+// Saves the IndexedFaceSet of a SceneGraph with a single Shape child
+// in the native binary mesh format; see DgpFile.hpp for the layout of
+// the file; the sections written are
+//
+//   name          : char[]   DEF name of the Shape, only if not empty
+//   flags         : int[5]   ccw, convex, solid, normalPerVertex,
+//                            colorPerVertex
+//   creaseAngle   : float[1]
+//   diffuseColor  : float[3] only if the Shape has a Material
+//   coord         : float[3*nV]
+//   coordIndex    : int[]
+//
+// and, if not empty, normal, normalIndex, color, colorIndex,
+// texCoord, and texCoordIndex; the property bindings are determined
+// by the flags and by the sizes of these arrays, as in the
+// IndexedFaceSet
+
+class SaverDgp : public Saver {
+
+private:
+
+  const static char* _ext;
+
+public:
+
+  SaverDgp()  {};
+  ~SaverDgp() {};
+
+  bool  save(const char* filename, SceneGraph& wrl) const;
+  const char* ext() const { return _ext; }
+
+};
+
+#endif /* _SAVER_DGP_HPP_ */
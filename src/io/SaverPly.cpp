@@ -50,6 +50,8 @@
 #include <util/CastMacros.hpp>
 
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 using namespace std;
 
 const char*   SaverPly::_ext = "ply";
@@ -113,237 +115,253 @@ bool SaverPly::sameAsSystemEndian(Ply::DataType fileEndian) {
 }
 
 //////////////////////////////////////////////////////////////////////
-// static
-bool SaverPly::writeBinaryValue
-(FILE * fp, const Ply::Element::Property::Type listType,
- const bool swapBytes, int nList) {
-  bool success = false;
-  if(fp!=nullptr) {
+// binary data is not written one value at a time; whole records are
+// assembled in a large staging buffer, which is written to the file
+// with a single fwrite() call every time it fills up
+
+static const size_t binaryBufferSize = static_cast<size_t>(1)<<22;
+
+class BinaryWriter {
+
+public:
+
+  BinaryWriter(FILE* fp, const bool swapBytes):
+    _fp(fp),
+    _swapBytes(swapBytes),
+    _buffer(binaryBufferSize),
+    _size(0) {
+  }
+
+  bool getSwapBytes() const {
+    return _swapBytes;
+  }
+
+  // returns a pointer to the next nBytes bytes of the buffer, after
+  // flushing the buffer if they do not fit
+  char* append(const size_t nBytes) {
+    if(_size+nBytes>_buffer.size()) {
+      flush();
+      if(nBytes>_buffer.size()) _buffer.resize(nBytes);
+    }
+    char* b = _buffer.data()+_size;
+    _size += nBytes;
+    return b;
+  }
+
+  // appends nValues values of nBytesValue bytes each, contiguous in
+  // src, reversing their byte order if needed
+  void appendValues
+  (const char* src, const size_t nValues, const int nBytesValue) {
+    const size_t nBytes = nValues*static_cast<size_t>(nBytesValue);
+    char* b = append(nBytes);
+    memcpy(b,src,nBytes);
+    if(_swapBytes && nBytesValue>1)
+      Endian::swapArray(b,nValues,nBytesValue);
+  }
+
+  void appendListCount
+  (const Ply::Element::Property::Type listType, const int nList) {
     Endian::SingleValueBuffer svb;
     switch(listType) {
     case Ply::Element::Property::Type::CHAR:
     case Ply::Element::Property::Type::INT8:
       svb.c[0] = static_cast<char>(nList);
-      success = (fwrite(&(svb.c[0]),1,1,fp)==1);
       break;
     case Ply::Element::Property::Type::UCHAR:
     case Ply::Element::Property::Type::UINT8:
       svb.uc[0] = static_cast<uchar>(nList);
-      success = (fwrite(&(svb.uc[0]),1,1,fp)==1);
       break;
     case Ply::Element::Property::Type::SHORT:
     case Ply::Element::Property::Type::INT16:
       svb.s[0] = static_cast<short>(nList);
-      if(swapBytes) Endian::swapShort(svb);
-      success = (fwrite(&(svb.s[0]),1,2,fp)==2);
       break;
     case Ply::Element::Property::Type::USHORT:
     case Ply::Element::Property::Type::UINT16:
       svb.us[0] = static_cast<ushort>(nList);
-      if(swapBytes) Endian::swapUShort(svb);
-      success = (fwrite(&(svb.us[0]),1,2,fp)==2);
       break;
     case Ply::Element::Property::Type::INT:
     case Ply::Element::Property::Type::INT32:
       svb.i[0] = static_cast<int>(nList);
-      if(swapBytes) Endian::swapInt(svb);
-      success = (fwrite(&(svb.i[0]),1,4,fp)==4);
       break;
     case Ply::Element::Property::Type::UINT:
     case Ply::Element::Property::Type::UINT32:
       svb.ui[0] = static_cast<uint>(nList);
-      if(swapBytes) Endian::swapUInt(svb);
-      success = (fwrite(&(svb.ui[0]),1,4,fp)==4);
       break;
     default:
-      break;
+      throw new StrException("unable to write list binary count");
     }
+    appendValues(svb.c,1,Ply::Element::Property::getTypeSize(listType));
   }
-  return success;
-}
 
-//////////////////////////////////////////////////////////////////////
-// static
-bool SaverPly::writeBinaryValue
-(FILE * fp, const Ply::Element::Property::Type propertyType,
- const bool swapBytes, void* value, int index) {
-  bool success = false;
-  if(fp!=nullptr) {
-    Endian::SingleValueBuffer svb;
-    switch(propertyType) {
-    case Ply::Element::Property::Type::CHAR:
-    case Ply::Element::Property::Type::INT8:
-      {
-        svb.c[0] = (*static_cast<vector<char>*>(value))[UL(index)];
-        success = (fwrite(&(svb.c[0]),1,1,fp)==2);
-      }
-      break;
-    case Ply::Element::Property::Type::UCHAR:
-    case Ply::Element::Property::Type::UINT8:
-      {
-        svb.uc[0] = (*static_cast<vector<uchar>*>(value))[UL(index)];
-        success = (fwrite(&(svb.uc[0]),1,1,fp)==2);
-      }
-      break;
-    case Ply::Element::Property::Type::SHORT:
-    case Ply::Element::Property::Type::INT16:
-      {
-        svb.s[0] = (*static_cast<vector<short>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapShort(svb);
-        success = (fwrite(&(svb.s[0]),1,2,fp)==2);
-      }
-      break;
-    case Ply::Element::Property::Type::USHORT:
-    case Ply::Element::Property::Type::UINT16:
-      {
-        svb.us[0] = (*static_cast<vector<ushort>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapUShort(svb);
-        success = (fwrite(&(svb.us[0]),1,2,fp)==2);
-      }
-      break;
-    case Ply::Element::Property::Type::INT:
-    case Ply::Element::Property::Type::INT32:
-      {
-        svb.i[0] = (*static_cast<vector<int>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapInt(svb);
-        success = (fwrite(&(svb.i[0]),1,4,fp)==4);
-      }
-      break;
-    case Ply::Element::Property::Type::UINT:
-    case Ply::Element::Property::Type::UINT32:
-      {
-        svb.ui[0] = (*static_cast<vector<uint>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapUInt(svb);
-        success = (fwrite(&(svb.ui[0]),1,4,fp)==4);
-      }
-      break;
-    case Ply::Element::Property::Type::FLOAT:
-    case Ply::Element::Property::Type::FLOAT32:
-    case Ply::Element::Property::Type::FLOAT32_2:
-    case Ply::Element::Property::Type::FLOAT32_3:
-      {
-        int n =
-          (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
-          (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
-        for(int i=0;i<n;i++) {
-          svb.f[0] = (*static_cast<vector<float>*>(value))[n*UL(index)+i];
-          if(swapBytes) Endian::swapFloat(svb);
-          success = (fwrite(&(svb.f[0]),1,4,fp)==4);
-          if(success==false) break;
-        }
-      }
-      break;
-    case Ply::Element::Property::Type::DOUBLE:
-    case Ply::Element::Property::Type::FLOAT64:
-      {
-        svb.d[0] = (*static_cast<vector<double>*>(value))[UL(index)];
-        if(swapBytes) Endian::swapDouble(svb);
-        success = (fwrite(&(svb.d[0]),1,8,fp)==8);
-      }
-      break; 
-    default:
-      break;
-    }
+  void flush() {
+    if(_size>0 && fwrite(_buffer.data(),1,_size,_fp)!=_size)
+      throw new StrException("unable to write binary data");
+    _size = 0;
   }
-  return success;
+
+private:
+
+  FILE*        _fp;
+  bool         _swapBytes;
+  vector<char> _buffer;
+  size_t       _size;
+};
+
+// returns a pointer to the first byte of the vector of values of a
+// property of the given type; see the Ply::Element::Property
+// constructor
+static const char* getBinaryValueData
+(const Ply::Element::Property::Type propertyType, void* value) {
+  switch(propertyType) {
+  case Ply::Element::Property::CHAR:
+  case Ply::Element::Property::INT8:
+    return static_cast<vector<char>*>(value)->data();
+  case Ply::Element::Property::UCHAR:
+  case Ply::Element::Property::UINT8:
+    return reinterpret_cast<const char*>
+      (static_cast<vector<uchar>*>(value)->data());
+  case Ply::Element::Property::SHORT:
+  case Ply::Element::Property::INT16:
+    return reinterpret_cast<const char*>
+      (static_cast<vector<short>*>(value)->data());
+  case Ply::Element::Property::USHORT:
+  case Ply::Element::Property::UINT16:
+    return reinterpret_cast<const char*>
+      (static_cast<vector<ushort>*>(value)->data());
+  case Ply::Element::Property::INT:
+  case Ply::Element::Property::INT32:
+    return reinterpret_cast<const char*>
+      (static_cast<vector<int>*>(value)->data());
+  case Ply::Element::Property::UINT:
+  case Ply::Element::Property::UINT32:
+    return reinterpret_cast<const char*>
+      (static_cast<vector<uint>*>(value)->data());
+  case Ply::Element::Property::FLOAT:
+  case Ply::Element::Property::FLOAT32:
+  case Ply::Element::Property::FLOAT32_2:
+  case Ply::Element::Property::FLOAT32_3:
+    return reinterpret_cast<const char*>
+      (static_cast<vector<float>*>(value)->data());
+  case Ply::Element::Property::DOUBLE:
+  case Ply::Element::Property::FLOAT64:
+    return reinterpret_cast<const char*>
+      (static_cast<vector<double>*>(value)->data());
+  case Ply::Element::Property::NONE:
+    break;
+  }
+  throw new StrException("unexpected NONE binary value type");
 }
 
-//////////////////////////////////////////////////////////////////////
-// static
-  
-bool SaverPly::writeBinaryColorValue
-(FILE * fp, const bool swapBytes, void* value, int index) {
-  // TODO Thu Mar 2 2023
-  // swapBytes unused???
-  (void)swapBytes;
-  bool success = false;
-  if(fp!=nullptr) {
-    Endian::SingleValueBuffer svb;
-    for(int i=0;i<3;i++) {
-      float& f = (*static_cast<vector<float>*>(value))[3*UL(index)+i]; 
-      svb.uc[0] = static_cast<uchar>(255.0*f); 
-      success = (fwrite(&(svb.uc[0]),1,1,fp)==1);
-      if(success==false) break;
-    }
+// copies the nValues values of each one of nRecords records,
+// contiguous in src, to dst, where consecutive records are stride
+// bytes apart; when the byte order has to be reversed, the values
+// are first copied to scratch, and swapped there all at once
+static void scatterBinaryValues
+(char* dst, const size_t stride, const char* src,
+ const int nRecords, const int nValues, const int nBytesValue,
+ const bool swapBytes, vector<char>& scratch) {
+  const size_t nBytesRecord =
+    static_cast<size_t>(nValues)*static_cast<size_t>(nBytesValue);
+  const size_t nBytes = nBytesRecord*static_cast<size_t>(nRecords);
+  if(swapBytes && nBytesValue>1) {
+    if(scratch.size()<nBytes) scratch.resize(nBytes);
+    memcpy(scratch.data(),src,nBytes);
+    Endian::swapArray(scratch.data(),
+                      static_cast<size_t>(nRecords)*nValues,nBytesValue);
+    src = scratch.data();
+  }
+  if(stride==nBytesRecord) {
+    memcpy(dst,src,nBytes);
+  } else {
+    for(int iRecord=0;iRecord<nRecords;iRecord++)
+      memcpy(dst+stride*iRecord,src+nBytesRecord*iRecord,nBytesRecord);
   }
-  return success;
 }
 
+// number of records of nBytesRecord bytes assembled in the staging
+// buffer at once
+static int getBinaryBlockSize(const size_t nBytesRecord) {
+  size_t nBlock = (nBytesRecord>0)?binaryBufferSize/nBytesRecord:0;
+  if(nBlock<1) nBlock = 1;
+  if(nBlock>0x7fffffff) nBlock = 0x7fffffff;
+  return static_cast<int>(nBlock);
+}
+
+
 //////////////////////////////////////////////////////////////////////
 // static
 bool SaverPly::writeAsciiValue
-(FILE * fp, const Ply::Element::Property::Type propertyType,
+(FormatBuffer& fb, const Ply::Element::Property::Type propertyType,
  void* value, int index) {
-  bool success = false;
-  if(fp!=nullptr) {
-    switch(propertyType) {
-    case Ply::Element::Property::Type::CHAR:
-    case Ply::Element::Property::Type::INT8:
-      {
-        char & c = (*static_cast<vector<char>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",c)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::UCHAR:
-    case Ply::Element::Property::Type::UINT8:
-      {
-        uchar & uc = (*static_cast<vector<uchar>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",uc)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::SHORT:
-    case Ply::Element::Property::Type::INT16:
-      {
-        short & s = (*static_cast<vector<short>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",s)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::USHORT:
-    case Ply::Element::Property::Type::UINT16:
-      {
-        ushort & us = (*static_cast<vector<ushort>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",us)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::INT:
-    case Ply::Element::Property::Type::INT32:
-      {
-        int & i = (*static_cast<vector<int>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",i)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::UINT:
-    case Ply::Element::Property::Type::UINT32:
-      {
-        uint & ui = (*static_cast<vector<uint>*>(value))[UL(index)];
-        success = (fprintf(fp,"%d",ui)>0);
-      }
-      break;
-    case Ply::Element::Property::Type::FLOAT:
-    case Ply::Element::Property::Type::FLOAT32:
-    case Ply::Element::Property::Type::FLOAT32_2:
-    case Ply::Element::Property::Type::FLOAT32_3:
-      {
-        int n =
-          (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
-          (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
-        for(int i=0;i<n;i++) {
-          float & f = (*static_cast<vector<float>*>(value))[i+n*UL(index)];
-          success = (fprintf(fp,"%f ",D(f))>0);
-          if(success==false) break;
-        }
-      }
-      break;
-    case Ply::Element::Property::Type::DOUBLE:
-    case Ply::Element::Property::Type::FLOAT64:
-      {
-        double & d = (*static_cast<vector<double>*>(value))[UL(index)];
-        success = (fprintf(fp,"%f",d)>0);
+  bool success = true;
+  switch(propertyType) {
+  case Ply::Element::Property::Type::CHAR:
+  case Ply::Element::Property::Type::INT8:
+    {
+      char & c = (*static_cast<vector<char>*>(value))[UL(index)];
+      fb.putInt(c);
+    }
+    break;
+  case Ply::Element::Property::Type::UCHAR:
+  case Ply::Element::Property::Type::UINT8:
+    {
+      uchar & uc = (*static_cast<vector<uchar>*>(value))[UL(index)];
+      fb.putInt(uc);
+    }
+    break;
+  case Ply::Element::Property::Type::SHORT:
+  case Ply::Element::Property::Type::INT16:
+    {
+      short & s = (*static_cast<vector<short>*>(value))[UL(index)];
+      fb.putInt(s);
+    }
+    break;
+  case Ply::Element::Property::Type::USHORT:
+  case Ply::Element::Property::Type::UINT16:
+    {
+      ushort & us = (*static_cast<vector<ushort>*>(value))[UL(index)];
+      fb.putInt(us);
+    }
+    break;
+  case Ply::Element::Property::Type::INT:
+  case Ply::Element::Property::Type::INT32:
+    {
+      int & i = (*static_cast<vector<int>*>(value))[UL(index)];
+      fb.putInt(i);
+    }
+    break;
+  case Ply::Element::Property::Type::UINT:
+  case Ply::Element::Property::Type::UINT32:
+    {
+      uint & ui = (*static_cast<vector<uint>*>(value))[UL(index)];
+      fb.putInt(ui);
+    }
+    break;
+  case Ply::Element::Property::Type::FLOAT:
+  case Ply::Element::Property::Type::FLOAT32:
+  case Ply::Element::Property::Type::FLOAT32_2:
+  case Ply::Element::Property::Type::FLOAT32_3:
+    {
+      int n =
+        (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
+        (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
+      for(int i=0;i<n;i++) {
+        float & f = (*static_cast<vector<float>*>(value))[i+n*UL(index)];
+        fb.putFloat(f);
+        fb.put(' ');
       }
-      break; 
-    default:
-      break;
     }
+    break;
+  case Ply::Element::Property::Type::DOUBLE:
+  case Ply::Element::Property::Type::FLOAT64:
+    {
+      double & d = (*static_cast<vector<double>*>(value))[UL(index)];
+      fb.putDouble(d);
+    }
+    break; 
+  default:
+    success = false;
+    break;
   }
   return success;
 }
@@ -352,17 +370,14 @@ bool SaverPly::writeAsciiValue
 // static
   
 bool SaverPly::writeAsciiColorValue
-(FILE * fp, void* value, int index) {
-  bool success = false;
-  if(fp!=nullptr) {
-    for(int i=0;i<3;i++) {
-      float& f = (*static_cast<vector<float>*>(value))[3*UL(index)+i]; 
-      uchar uc = static_cast<uchar>(255.0*f); 
-      success = (fprintf(fp,"%3d ",uc)>0);
-      if(success==false) break;
-    }
+(FormatBuffer& fb, void* value, int index) {
+  for(int i=0;i<3;i++) {
+    float& f = (*static_cast<vector<float>*>(value))[3*UL(index)+i]; 
+    uchar uc = static_cast<uchar>(255.0*f); 
+    fb.putInt(uc,3);
+    fb.put(' ');
   }
-  return success;
+  return true;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -577,15 +592,18 @@ SaverPly::writeBinaryData
 
   try {
 
-    bool swapBytes = (sameAsSystemEndian(dataType)==false);
+    if(fp==nullptr) throw new StrException("fp==nullptr");
+
+    BinaryWriter writer(fp,sameAsSystemEndian(dataType)==false);
+    const bool swapBytes = writer.getSwapBytes();
+    vector<char> scratch;
 
     Ply::Element* element;
     Ply::Element::Property* property;
-    Ply::Element::Property::Type listType;
-    Ply::Element::Property::Type propertyType;
-    void* propertyValue;
-    int iElement,iList0,iList1,iList,nList,k0,k1;
+    char* b;
+    int iElement,iList0,nList,k0,k1,n,nBlock,nBlockRecords,i,j;
     int iProperty,iRecord,nElements,nProperties,nRecords;
+    size_t nBytesRecord,offset;
     string name,propertyName;
 
     nElements = ply.getNumberOfElements();
@@ -600,8 +618,36 @@ SaverPly::writeBinaryData
         *_ostrm << indent << "    name " << name << endl;
       }
 
+      // layout of the properties written within each record; the
+      // color components are written as one uchar each
+      vector<Ply::Element::Property*> elementProperty;
+      vector<const char*> value;
+      vector<int>  nValues;
+      vector<int>  nBytesValue;
+      vector<bool> isColor;
+      bool fixedLayout = true;
+      nBytesRecord = 0;
       nProperties = element->getNumberOfProperties();
-      if(_skipAlpha && element->hasProperty("alpha")) nProperties--;
+      for(iProperty=0;iProperty<nProperties;iProperty++) {
+        property      = element->getProperty(iProperty);
+        propertyName  = property->getName();
+        if(_skipAlpha && propertyName=="alpha") continue;
+        Ply::Element::Property::Type propertyType =
+          property->getPropertyType();
+        n =
+          (property->isList())?0:
+          (propertyType==Ply::Element::Property::Type::FLOAT32_3)?3:
+          (propertyType==Ply::Element::Property::Type::FLOAT32_2)?2:1;
+        elementProperty.push_back(property);
+        value.push_back(getBinaryValueData(propertyType,property->getValue()));
+        nValues.push_back(n);
+        isColor.push_back(propertyName=="color");
+        nBytesValue.push_back
+          ((isColor.back())?1:property->getPropertyTypeSize()/max(n,1));
+        if(property->isList()) fixedLayout = false;
+        nBytesRecord += static_cast<size_t>(n*nBytesValue.back());
+      }
+      nProperties = static_cast<int>(elementProperty.size());
       if(_ostrm!=nullptr) {
         *_ostrm << indent << "      nProperties = " << nProperties<< endl;
       }
@@ -612,44 +658,67 @@ SaverPly::writeBinaryData
         *_ostrm << indent << "        ";
       }
 
-      for(k0=iRecord=0;iRecord<nRecords;iRecord++) {
-
-        for(iProperty=0;iProperty<nProperties;iProperty++) {
-          property      = element->getProperty(iProperty);
-          propertyName  = property->getName();
-          if(_skipAlpha && propertyName=="alpha") continue;
-          propertyType  = property->getPropertyType();
-          propertyValue = property->getValue();
-
-          if(property->isList()) {
-            listType = property->getListType();
-            iList0   = property->getListFirst(iRecord );
-            nList    = property->getListFirst(iRecord+1)-iList0;
-            if(propertyName=="coordIndex") nList--; // don't write -1 separator
-            iList1   = iList0+nList;
-            
-            if(writeBinaryValue(fp,listType,swapBytes,nList)==false)
-              throw new StrException("unable to write list binary count");
-            for(iList=iList0;iList<iList1;iList++) {
-              if(writeBinaryValue
-                 (fp,propertyType,swapBytes,propertyValue,iList)==false)
-                throw new StrException("unable to write list binary value");
+      // fixed size records are assembled in blocks, one property at
+      // a time; other records are assembled one at a time
+      nBlock = (fixedLayout)?getBinaryBlockSize(nBytesRecord):1;
+
+      for(k0=iRecord=0;iRecord<nRecords;iRecord+=nBlockRecords) {
+        nBlockRecords = min(nBlock,nRecords-iRecord);
+
+        if(fixedLayout) {
+          b = writer.append(nBytesRecord*static_cast<size_t>(nBlockRecords));
+          for(offset=0,iProperty=0;iProperty<nProperties;iProperty++) {
+            if(isColor[iProperty]) {
+              const float* color =
+                reinterpret_cast<const float*>(value[iProperty])+3*iRecord;
+              for(i=0;i<nBlockRecords;i++)
+                for(j=0;j<3;j++)
+                  b[offset+nBytesRecord*i+j] = static_cast<char>
+                    (static_cast<uchar>(255.0*color[3*i+j]));
+            } else {
+              scatterBinaryValues
+                (b+offset,nBytesRecord,
+                 value[iProperty]+
+                 static_cast<size_t>(iRecord)*nValues[iProperty]*
+                 nBytesValue[iProperty],
+                 nBlockRecords,nValues[iProperty],nBytesValue[iProperty],
+                 swapBytes,scratch);
             }
-          } else {
-            if(propertyName=="color") {
-              if(writeBinaryColorValue(fp,swapBytes,propertyValue,iRecord)==false)
-                throw new StrException("unable to write binary value");
+            offset += static_cast<size_t>(nValues[iProperty]*
+                                          nBytesValue[iProperty]);
+          }
+        } else {
+          for(iProperty=0;iProperty<nProperties;iProperty++) {
+            property = elementProperty[iProperty];
+            if(property->isList()) {
+              iList0 = property->getListFirst(iRecord );
+              nList  = property->getListFirst(iRecord+1)-iList0;
+              if(property->getName()=="coordIndex")
+                nList--; // don't write -1 separator
+              writer.appendListCount(property->getListType(),nList);
+              writer.appendValues
+                (value[iProperty]+
+                 static_cast<size_t>(iList0)*nBytesValue[iProperty],
+                 static_cast<size_t>(nList),nBytesValue[iProperty]);
+            } else if(isColor[iProperty]) {
+              const float* color =
+                reinterpret_cast<const float*>(value[iProperty])+3*iRecord;
+              b = writer.append(3);
+              for(j=0;j<3;j++)
+                b[j] = static_cast<char>(static_cast<uchar>(255.0*color[j]));
             } else {
-              if(writeBinaryValue
-                 (fp,propertyType,swapBytes,propertyValue,iRecord)==false)
-                throw new StrException("unable to write binary value");
+              writer.appendValues
+                (value[iProperty]+
+                 static_cast<size_t>(iRecord)*nValues[iProperty]*
+                 nBytesValue[iProperty],
+                 static_cast<size_t>(nValues[iProperty]),
+                 nBytesValue[iProperty]);
             }
           }
-          
-        } // for(iProperty ...
+        }
 
         // report progress
-        k1 = (10*(iRecord+1))/nRecords;
+        k1 = (10*(iRecord+nBlockRecords))/nRecords;
         if(k1>k0) {
           if(_ostrm!=nullptr) {
             *_ostrm << (10*k1) << "% ";
@@ -664,6 +733,8 @@ SaverPly::writeBinaryData
       }
         
     }
+
+    writer.flush();
       
     success = true;
       
@@ -698,6 +769,8 @@ SaverPly::writeAsciiData
     if(dataType!=Ply::DataType::ASCII)
         throw new StrException("  incorrect data type");
 
+    FormatBuffer fb(fp);
+
     Ply::Element* element;
     Ply::Element::Property* property;
     // Ply::Element::Property::Type listType;
@@ -705,7 +778,7 @@ SaverPly::writeAsciiData
     void* propertyValue;
     int iElement,iList0,iList1,iList,nList,iProperty;
     int iRecord,nElements,nProperties,nRecords,k0,k1;
-    string name,propertyName;
+    string name;
 
     nElements = ply.getNumberOfElements();
     if(_ostrm!=nullptr) {
@@ -719,8 +792,21 @@ SaverPly::writeAsciiData
         *_ostrm << indent << "  name = " << name << endl;
       }
 
+      // properties written, and how; looked up once per element
+      // rather than once per record
+      vector<Ply::Element::Property*> elementProperty;
+      vector<bool> isColor;
+      vector<bool> isCoordIndex;
       nProperties = element->getNumberOfProperties();
-      if(_skipAlpha && element->hasProperty("alpha")) nProperties--;
+      for(iProperty=0;iProperty<nProperties;iProperty++) {
+        property = element->getProperty(iProperty);
+        const string& propertyName = property->getName();
+        if(_skipAlpha && propertyName=="alpha") continue;
+        elementProperty.push_back(property);
+        isColor.push_back(propertyName=="color");
+        isCoordIndex.push_back(propertyName=="coordIndex");
+      }
+      nProperties = static_cast<int>(elementProperty.size());
       if(_ostrm!=nullptr) {
         *_ostrm << indent << "      nProperties = " << nProperties << endl;
       }
@@ -734,9 +820,7 @@ SaverPly::writeAsciiData
       for(k0=iRecord=0;iRecord<nRecords;iRecord++) {
 
         for(iProperty=0;iProperty<nProperties;iProperty++) {
-          property      = element->getProperty(iProperty);
-          propertyName  = property->getName();
-          if(_skipAlpha && propertyName=="alpha") continue;
+          property      = elementProperty[iProperty];
           propertyType  = property->getPropertyType();
           propertyValue = property->getValue();
 
@@ -744,29 +828,30 @@ SaverPly::writeAsciiData
             // listType = property->getListType();
             iList0   = property->getListFirst(iRecord );
             nList    = property->getListFirst(iRecord+1)-iList0;
-            if(propertyName=="coordIndex") nList--; // don't write -1 separator 
+            if(isCoordIndex[iProperty]) nList--; // don't write -1 separator 
             iList1   = iList0+nList;
 
-            fprintf(fp,"%d ",nList);
+            fb.putInt(nList);
+            fb.put(' ');
             for(iList=iList0;iList<iList1;) {
-              if(writeAsciiValue(fp,propertyType,propertyValue,iList)==false)
+              if(writeAsciiValue(fb,propertyType,propertyValue,iList)==false)
                 throw new StrException("unable to write list ascii value");
-              if(++iList<iList1) fprintf(fp," ");
+              if(++iList<iList1) fb.put(' ');
             }
 
           } else /* if(property->isList()==false) */ {
-            if(propertyName=="color") {
-              if(writeAsciiColorValue(fp,propertyValue,iRecord)==false)
+            if(isColor[iProperty]) {
+              if(writeAsciiColorValue(fb,propertyValue,iRecord)==false)
                 throw new StrException("unable to write ascii color value");
             } else {
-              if(writeAsciiValue(fp,propertyType,propertyValue,iRecord)==false)
+              if(writeAsciiValue(fb,propertyType,propertyValue,iRecord)==false)
                 throw new StrException("unable to write ascii value");
             }
 
-            fprintf(fp," ");
+            fb.put(' ');
           }
         }
-        fprintf(fp,"\n"); // end of record
+        fb.put('\n'); // end of record
 
         k1 = (10*(iRecord+1))/nRecords;
         if(k1>k0) {
@@ -782,6 +867,11 @@ SaverPly::writeAsciiData
 
     }
 
+    if(fb.flush()==false)
+      throw new StrException("unable to write ascii data");
+
+    success = true;
+
   } catch (StrException* e) {
     if(_ostrm!=nullptr) {
       *_ostrm << indent << "  " << e->what() << endl;
@@ -1019,136 +1109,161 @@ SaverPly::writeBinaryData
     return false;
   }
 
-  bool swapBytes = (sameAsSystemEndian(dataType)==false);
+  bool success = false;
 
-  int i,i0,i1,iF,nList,iV,iN,iC,j,k0,k1;
+  try {
 
-  vector<float>& coord         = ifs.getCoord();
-  vector<int>&   coordIndex    = ifs.getCoordIndex();
-  vector<float>& normal        = ifs.getNormal();
-  vector<int>&   normalIndex   = ifs.getNormalIndex();
-  vector<float>& color         = ifs.getColor();
-  vector<int>&   colorIndex    = ifs.getColorIndex();
-  vector<float>& texCoord      = ifs.getTexCoord();
-  // vector<int>&   texCoordIndex = ifs.getTexCoordIndex();
+    BinaryWriter writer(fp,sameAsSystemEndian(dataType)==false);
+    const bool swapBytes = writer.getSwapBytes();
+    vector<char> scratch;
 
-  int nVertices = ifs.getNumberOfVertices();
-  int nFaces    = ifs.getNumberOfFaces();
+    int i0,i1,iF,nList,iV,iN,iC,j,k0,k1,nBlock,nBlockRecords;
+    size_t nBytesRecord,offset;
+    char* b;
 
-  Endian::SingleValueBuffer svb;
-
-  if(_ostrm!=nullptr) {
-    *_ostrm << indent << "  name = vertex" << endl;
-    *_ostrm << indent << "    ";
-  }
+    vector<float>& coord         = ifs.getCoord();
+    vector<int>&   coordIndex    = ifs.getCoordIndex();
+    vector<float>& normal        = ifs.getNormal();
+    vector<int>&   normalIndex   = ifs.getNormalIndex();
+    vector<float>& color         = ifs.getColor();
+    vector<int>&   colorIndex    = ifs.getColorIndex();
+    vector<float>& texCoord      = ifs.getTexCoord();
+    // vector<int>&   texCoordIndex = ifs.getTexCoordIndex();
 
-  for(k0=iV=0;iV<nVertices;iV++) {
+    int nVertices = ifs.getNumberOfVertices();
+    int nFaces    = ifs.getNumberOfFaces();
 
-    if(true /* ifs.hasCoordPerVertex() */) {
-      for(j=0;j<3;j++) {
-        svb.f[0] = coord[UI(3*iV+j)];
-        if(swapBytes) Endian::swapFloat(svb);
-        fwrite(&(svb.f[0]),1,4,fp); // ==4
-      }
+    bool ifsHasNormalPerVertex   = ifs.hasNormalPerVertex();
+    bool ifsHasColorPerVertex    = ifs.hasColorPerVertex();
+    bool ifsHasTexCoordPerVertex = ifs.hasTexCoordPerVertex();
+
+    if(_ostrm!=nullptr) {
+      *_ostrm << indent << "  name = vertex" << endl;
+      *_ostrm << indent << "    ";
     }
-    if(ifs.hasNormalPerVertex()) {
-      for(j=0;j<3;j++) {
-        svb.f[0] = normal[UI(3*iV+j)];
-        if(swapBytes) Endian::swapFloat(svb);
-        fwrite(&(svb.f[0]),1,4,fp); // ==4
+
+    // vertex records have a fixed size; they are assembled in blocks,
+    // one property at a time
+    nBytesRecord = 12;
+    if(ifsHasNormalPerVertex)   nBytesRecord += 12;
+    if(ifsHasColorPerVertex)    nBytesRecord +=  3;
+    if(ifsHasTexCoordPerVertex) nBytesRecord +=  8;
+    nBlock = getBinaryBlockSize(nBytesRecord);
+
+    for(k0=iV=0;iV<nVertices;iV+=nBlockRecords) {
+      nBlockRecords = min(nBlock,nVertices-iV);
+      b = writer.append(nBytesRecord*static_cast<size_t>(nBlockRecords));
+
+      offset = 0;
+      if(true /* ifs.hasCoordPerVertex() */) {
+        scatterBinaryValues
+          (b+offset,nBytesRecord,
+           reinterpret_cast<const char*>(coord.data()+3*iV),
+           nBlockRecords,3,4,swapBytes,scratch);
+        offset += 12;
       }
-    }
-    if(ifs.hasColorPerVertex()) {
-      for(j=0;j<3;j++) {
-        svb.uc[0] = UC(color[UI(3*iV+j)]*255.0f);
-        if(swapBytes) Endian::swapFloat(svb);
-        fwrite(&(svb.uc[0]),1,1,fp); // ==1
+      if(ifsHasNormalPerVertex) {
+        scatterBinaryValues
+          (b+offset,nBytesRecord,
+           reinterpret_cast<const char*>(normal.data()+3*iV),
+           nBlockRecords,3,4,swapBytes,scratch);
+        offset += 12;
       }
-    }
-    if(ifs.hasTexCoordPerVertex()) {
-      for(j=0;j<2;j++) {
-        svb.f[0] = texCoord[UI(2*iV+j)];
-        if(swapBytes) Endian::swapFloat(svb);
-        fwrite(&(svb.f[0]),1,4,fp); // ==4
+      if(ifsHasColorPerVertex) {
+        for(int i=0;i<nBlockRecords;i++)
+          for(j=0;j<3;j++)
+            b[offset+nBytesRecord*i+j] =
+              static_cast<char>(UC(color[UI(3*(iV+i)+j)]*255.0f));
+        offset += 3;
+      }
+      if(ifsHasTexCoordPerVertex) {
+        scatterBinaryValues
+          (b+offset,nBytesRecord,
+           reinterpret_cast<const char*>(texCoord.data()+2*iV),
+           nBlockRecords,2,4,swapBytes,scratch);
+        offset += 8;
       }
-    }
 
-    k1 = (10*(iV+1))/nVertices;
-    if(k1>k0) {
-      if(_ostrm!=nullptr) {
-        *_ostrm << (10*k1) << "% ";
+      k1 = (10*(iV+nBlockRecords))/nVertices;
+      if(k1>k0) {
+        if(_ostrm!=nullptr) {
+          *_ostrm << (10*k1) << "% ";
+        }
+        k0 = k1;
       }
-      k0 = k1;
     }
-  }
-  if(_ostrm!=nullptr) {
-    *_ostrm << endl;
-  }
-
-  if(nFaces>0) {
     if(_ostrm!=nullptr) {
-      *_ostrm << indent << "  name = face" << endl;
-      *_ostrm << indent << "    ";
+      *_ostrm << endl;
     }
 
-    bool ifsHasNormalPerFace = ifs.hasNormalPerFace();
-    bool ifsHasColorPerFace  = ifs.hasColorPerFace();
+    if(nFaces>0) {
+      if(_ostrm!=nullptr) {
+        *_ostrm << indent << "  name = face" << endl;
+        *_ostrm << indent << "    ";
+      }
 
-    for(k0=iF=i0=i1=0;i1<I(coordIndex.size());i1++) {
+      bool ifsHasNormalPerFace = ifs.hasNormalPerFace();
+      bool ifsHasColorPerFace  = ifs.hasColorPerFace();
 
-      if(coordIndex[UI(i1)]<0) {
-        nList = i1-i0;
+      for(k0=iF=i0=i1=0;i1<I(coordIndex.size());i1++) {
 
-        svb.uc[0] = UC(nList);
-        fwrite(&(svb.uc[0]),1,1,fp); // ==1
+        if(coordIndex[UI(i1)]<0) {
+          nList = i1-i0;
 
-        for(i=i0;i<i1;i++) {
-          svb.i[0] = coordIndex[UI(i)];
-          if(swapBytes) Endian::swapInt(svb);
-          fwrite(&(svb.i[0]),1,4,fp); // ==4
-        }
+          b = writer.append(1);
+          b[0] = static_cast<char>(UC(nList));
 
-        if(ifsHasNormalPerFace) {
-          iN = (normalIndex.size()>0)?normalIndex[UI(iF)]:iF;
-          for(j=0;j<3;j++) {
-            svb.f[0] = normal[UI(3*iN+j)];
-            if(swapBytes) Endian::swapFloat(svb);
-            fwrite(&(svb.f[0]),1,4,fp); // ==4
+          writer.appendValues
+            (reinterpret_cast<const char*>(coordIndex.data()+i0),
+             static_cast<size_t>(nList),4);
+
+          if(ifsHasNormalPerFace) {
+            iN = (normalIndex.size()>0)?normalIndex[UI(iF)]:iF;
+            writer.appendValues
+              (reinterpret_cast<const char*>(normal.data()+3*iN),3,4);
           }
-        }
 
-        if(ifsHasColorPerFace) {
-          iC = (colorIndex.size()>0)?colorIndex[UI(iF)]:iF;
-          for(j=0;j<3;j++) {
-            svb.uc[0] = UC(color[UI(3*iC+j)]*255.0f);
-            if(swapBytes) Endian::swapFloat(svb);
-            fwrite(&(svb.uc[0]),1,1,fp); // ==1
+          if(ifsHasColorPerFace) {
+            iC = (colorIndex.size()>0)?colorIndex[UI(iF)]:iF;
+            b = writer.append(3);
+            for(j=0;j<3;j++)
+              b[j] = static_cast<char>(UC(color[UI(3*iC+j)]*255.0f));
           }
-        }
 
-        k1 = (10*(iF+1))/nFaces;
-        if(k1>k0) {
-          if(_ostrm!=nullptr) {
-            *_ostrm << (10*k1) << "% ";
+          k1 = (10*(iF+1))/nFaces;
+          if(k1>k0) {
+            if(_ostrm!=nullptr) {
+              *_ostrm << (10*k1) << "% ";
+            }
+            k0 = k1;
           }
-          k0 = k1;
+
+          i0=i1+1; iF++;
         }
+      }
 
-        i0=i1+1; iF++;
+      if(_ostrm!=nullptr) {
+        *_ostrm << endl;
       }
-    }
+    
+    } // if(nFaces>0)
 
+    writer.flush();
+
+    success = true;
+
+  } catch (StrException* e) {
     if(_ostrm!=nullptr) {
-      *_ostrm << endl;
+      *_ostrm << indent << "  " << e->what() << endl;
     }
-    
-  } // if(nFaces>0)
+    delete e;
+  }
 
   if(_ostrm!=nullptr) {
     *_ostrm << indent << "} SaverPly::writeBinaryData(IndexedFaceSet &)" << endl;
   }
 
-  return true;
+  return success;
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -1189,6 +1304,8 @@ SaverPly::writeAsciiData
   int nVertices = ifs.getNumberOfVertices();
   int nFaces    = ifs.getNumberOfFaces();
 
+  FormatBuffer fb(fp);
+
   if(_ostrm!=nullptr) {
     *_ostrm << indent << "  name = vertex" << endl;
     *_ostrm << indent << "    ";
@@ -1197,22 +1314,30 @@ SaverPly::writeAsciiData
   for(k0=iV=0;iV<nVertices;iV++) {
 
     if(true /* ifs.hasCoordPerVertex() */) {
-      for(j=0;j<3;j++)
-        fprintf(fp,"%f ",D(coord[UI(3*iV+j)]));
+      for(j=0;j<3;j++) {
+        fb.putFloat(coord[UI(3*iV+j)]);
+        fb.put(' ');
+      }
     }
     if(ifs.hasNormalPerVertex()) {
-      for(j=0;j<3;j++)
-        fprintf(fp,"%f ",D(normal[UI(3*iV+j)]));
+      for(j=0;j<3;j++) {
+        fb.putFloat(normal[UI(3*iV+j)]);
+        fb.put(' ');
+      }
     }
     if(ifs.hasColorPerVertex()) {
-      for(j=0;j<3;j++)
-        fprintf(fp,"%d ",UC(color[UI(3*iV+j)]*255.0f));
+      for(j=0;j<3;j++) {
+        fb.putInt(UC(color[UI(3*iV+j)]*255.0f));
+        fb.put(' ');
+      }
     }
     if(ifs.hasTexCoordPerVertex()) {
-      for(j=0;j<2;j++)
-        fprintf(fp,"%f ",D(texCoord[UI(2*iV+j)]));
+      for(j=0;j<2;j++) {
+        fb.putFloat(texCoord[UI(2*iV+j)]);
+        fb.put(' ');
+      }
     }
-    fprintf(fp,"\n");
+    fb.put('\n');
 
     k1 = (10*(iV+1))/nVertices;
     if(k1>k0) {
@@ -1239,23 +1364,30 @@ SaverPly::writeAsciiData
       if(coordIndex[UI(i1)]<0) {
         nList = UC(i1-i0);
 
-        fprintf(fp,"%d ",nList);
-        for(i=i0;i<i1;i++)
-          fprintf(fp,"%d ",coordIndex[UI(i)]);
+        fb.putInt(nList);
+        fb.put(' ');
+        for(i=i0;i<i1;i++) {
+          fb.putInt(coordIndex[UI(i)]);
+          fb.put(' ');
+        }
         
         if(ifsHasNormalPerFace) {
           iN = (normalIndex.size()>0)?normalIndex[UI(iF)]:iF;
-          for(j=0;j<3;j++)
-            fprintf(fp,"%f ",D(normal[UI(iN)]));
+          for(j=0;j<3;j++) {
+            fb.putFloat(normal[UI(iN)]);
+            fb.put(' ');
+          }
         }
 
         if(ifsHasColorPerFace) {
           iC = (colorIndex.size()>0)?colorIndex[UI(iF)]:iF;
-          for(j=0;j<3;j++)
-            fprintf(fp,"%f ",D(color[UC(iC)]));
+          for(j=0;j<3;j++) {
+            fb.putFloat(color[UC(iC)]);
+            fb.put(' ');
+          }
         }
 
-        fprintf(fp,"\n");
+        fb.put('\n');
 
         k1 = (10*(iF+1))/nFaces;
         if(k1>k0) {
@@ -1273,10 +1405,12 @@ SaverPly::writeAsciiData
     }
   } // if(nFaces>0)
 
+  bool success = fb.flush();
+
   if(_ostrm!=nullptr) {
     *_ostrm << indent << "} SaverPly::writeAsciiData(IndexedFaceSet &)" << endl;
   }
-  return true;
+  return success;
 }
 
 //////////////////////////////////////////////////////////////////////
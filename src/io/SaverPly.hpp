@@ -48,6 +48,7 @@
 #include <wrl/IndexedFaceSet.hpp>
 #include <wrl/IndexedFaceSetPly.hpp>
 #include "Saver.hpp"
+#include "FormatBuffer.hpp"
 
 class SaverPly : public Saver {
 
@@ -81,23 +82,12 @@ public:
   static Ply::DataType systemEndian();
   static bool          sameAsSystemEndian(Ply::DataType fileEndian);
 
-  static bool writeBinaryValue
-  (FILE * fp, const Ply::Element::Property::Type listType,
-   const bool swapBytes, int nList);
-
-  static bool writeBinaryValue
-  (FILE * fp, const Ply::Element::Property::Type propertyType,
-   const bool swapBytes, void* value, int i);
-  
-  static bool writeBinaryColorValue
-  (FILE * fp, const bool swapBytes, void* value, int i);
-
   static bool writeAsciiValue
-  (FILE * fp, const Ply::Element::Property::Type propertyType,
+  (FormatBuffer& fb, const Ply::Element::Property::Type propertyType,
    void* value, int i);
   
   static bool writeAsciiColorValue
-  (FILE * fp, void* value, int i);
+  (FormatBuffer& fb, void* value, int i);
   
   static bool
   writeHeader(FILE * fp, Ply& ply, const string indent="",
@@ -35,9 +35,56 @@
 #include "SaverWrl.hpp"
 #include <wrl/IndexedLineSetVariables.hpp>
 #include <wrl/IndexedFaceSetVariables.hpp>
+#include "FormatBuffer.hpp"
 
 const char* SaverWrl::_ext = "wrl";
 
+// the large arrays of numbers are written through a FormatBuffer,
+// rather than with one fprintf() call per value; the output is the
+// same, including the indentation which precedes each value
+
+// as fprintf(fp,"%s%8.4f ",str,x) for each value x of the array,
+// and fprintf(fp,"%s\n",str) after every nPerLine values
+static void saveVecFloat
+(FormatBuffer& fb, const string& indent,
+ const vector<float>& vec, const int nPerLine) {
+  for(int i=0;i<(int)vec.size();i++) {
+    fb.put(indent);
+    fb.putFloat(vec[i],8,4);
+    fb.put(' ');
+    if(i%nPerLine==nPerLine-1) {
+      fb.put(indent);
+      fb.put('\n');
+    }
+  }
+}
+
+// as fprintf(fp,"%s%*d ",str,width,i) for each value i of the array,
+// and fprintf(fp,"%s\n",str) after each negative value
+static void saveVecInt
+(FormatBuffer& fb, const string& indent,
+ const vector<int>& vec, const int width) {
+  for(int i=0;i<(int)vec.size();i++) {
+    fb.put(indent);
+    fb.putInt(vec[i],width);
+    fb.put(' ');
+    if(vec[i]<0) {
+      fb.put(indent);
+      fb.put('\n');
+    }
+  }
+}
+
+// as fprintf(fp,"%s%6d\n",str,i) for each value i of the array
+static void saveSelection
+(FormatBuffer& fb, const string& indent, const vector<int>& vec) {
+  for(int i=0;i<(int)vec.size();i++) {
+    fb.put(indent);
+    fb.putInt(vec[i],6);
+    fb.put('\n');
+  }
+}
+
 //////////////////////////////////////////////////////////////////////
 void SaverWrl::saveMaterial
 (FILE* fp, string indent, Material* material) const {
@@ -175,6 +222,7 @@ void SaverWrl::saveIndexedFaceSet
   if(indexedFaceSet==(IndexedFaceSet*)0) return;
 
   const char* str = indent.c_str();
+  FormatBuffer fb(fp);
 
   // IndexedFaceSet {
   //   SFNode  color             NULL
@@ -195,9 +243,9 @@ void SaverWrl::saveIndexedFaceSet
 
   const string& name = indexedFaceSet->getName();
   if(name=="")
-    fprintf(fp,"%sIndexedFaceSet {\n",str);
+    fb.format("%sIndexedFaceSet {\n",str);
   else
-    fprintf(fp,"%sDEF %s IndexedFaceSet {\n",str,name.c_str());
+    fb.format("%sDEF %s IndexedFaceSet {\n",str,name.c_str());
 
   IndexedFaceSet& ifs = *indexedFaceSet;
   IndexedFaceSetVariables ifsv(ifs);
@@ -219,35 +267,27 @@ void SaverWrl::saveIndexedFaceSet
 
 
   // default ccw TRUE
-  if(ccw   ==false)   fprintf(fp,"%s ccw FALSE\n",str);
+  if(ccw   ==false)   fb.format("%s ccw FALSE\n",str);
   // default convex TRUE
-  if(convex==false)   fprintf(fp,"%s convex FALSE\n",str);
+  if(convex==false)   fb.format("%s convex FALSE\n",str);
   // default solid TRUE
-  if(solid ==false)   fprintf(fp,"%s solid FALSE\n",str);
+  if(solid ==false)   fb.format("%s solid FALSE\n",str);
   // default creaseAngle 0.0
-  if(creaseAngle>0.0) fprintf(fp,"%s creaseAngle %8.4f\n",str,creaseAngle);
+  if(creaseAngle>0.0) fb.format("%s creaseAngle %8.4f\n",str,creaseAngle);
 
   if(coordIndex.size()>0) {
-    int i;
-    fprintf(fp,"%s coordIndex [\n",str);
-    for(i=0;i<(int)coordIndex.size();i++) {
-      fprintf(fp,"%s%6d ",str,coordIndex[i]);
-      if(coordIndex[i]<0) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s ]\n",str);
+    fb.format("%s coordIndex [\n",str);
+    saveVecInt(fb,indent,coordIndex,6);
+    fb.format("%s ]\n",str);
   }
 
   // COORD_PER_VERTEX
   if(coord.size()>0) {
-    int i;
-    fprintf(fp,"%s coord Coordinate {\n",str);
-    fprintf(fp,"%s  point [\n",str);
-    for(i=0;i<(int)coord.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,coord[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    fb.format("%s coord Coordinate {\n",str);
+    fb.format("%s  point [\n",str);
+    saveVecFloat(fb,indent,coord,3);
+    fb.format("%s  ]\n",str);
+    fb.format("%s }\n",str);
   }
 
   // if(normal.size()==0)
@@ -268,26 +308,19 @@ void SaverWrl::saveIndexedFaceSet
   //     normal.size()/3==coord.size()/3
 
   if(normal.size()>0) {
-    int i;
-    fprintf(fp,"%s normalPerVertex %s\n",str,
-            (normalPerVertex==true)?"TRUE":"FALSE");
-
-    fprintf(fp,"%s normal Normal {\n",str);
-    fprintf(fp,"%s  vector [\n",str);
-    for(i=0;i<(int)normal.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,normal[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    fb.format("%s normalPerVertex %s\n",str,
+              (normalPerVertex==true)?"TRUE":"FALSE");
+
+    fb.format("%s normal Normal {\n",str);
+    fb.format("%s  vector [\n",str);
+    saveVecFloat(fb,indent,normal,3);
+    fb.format("%s  ]\n",str);
+    fb.format("%s }\n",str);
 
     if(normalIndex.size()>0) {
-      fprintf(fp,"%s normalIndex [\n",str);
-      for(i=0;i<(int)normalIndex.size();i++) {
-        fprintf(fp,"%s%d ",str,normalIndex[i]);
-        if(normalIndex[i]<0) fprintf(fp,"%s\n",str);
-      }
-      fprintf(fp,"%s ]\n",str);
+      fb.format("%s normalIndex [\n",str);
+      saveVecInt(fb,indent,normalIndex,0);
+      fb.format("%s ]\n",str);
     }
   }
 
@@ -309,26 +342,19 @@ void SaverWrl::saveIndexedFaceSet
   //     color.size()/3==coord.size()/3
 
   if(color.size()>0) {
-    int i;
-    fprintf(fp,"%s colorPerVertex %s\n",str,
-            (colorPerVertex==true)?"TRUE":"FALSE");
-
-    fprintf(fp,"%s color Color {\n",str);
-    fprintf(fp,"%s  color [\n",str);
-    for(i=0;i<(int)color.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,color[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    fb.format("%s colorPerVertex %s\n",str,
+              (colorPerVertex==true)?"TRUE":"FALSE");
+
+    fb.format("%s color Color {\n",str);
+    fb.format("%s  color [\n",str);
+    saveVecFloat(fb,indent,color,3);
+    fb.format("%s  ]\n",str);
+    fb.format("%s }\n",str);
 
     if(colorIndex.size()>0) {
-      fprintf(fp,"%s colorIndex [\n",str);
-      for(i=0;i<(int)colorIndex.size();i++) {
-        fprintf(fp,"%s%d ",str,colorIndex[i]);
-        if(colorIndex[i]<0) fprintf(fp,"%s\n",str);
-      }
-      fprintf(fp,"%s ]\n",str);
+      fb.format("%s colorIndex [\n",str);
+      saveVecInt(fb,indent,colorIndex,0);
+      fb.format("%s ]\n",str);
     }
   }
 
@@ -342,24 +368,16 @@ void SaverWrl::saveIndexedFaceSet
   //   texCoord.size()/2==coord.size()/3
 
   if(texCoord.size()>0) {
-    int i;
-
-    fprintf(fp,"%s texCoord TextureCoordinate {\n",str);
-    fprintf(fp,"%s  point [\n",str);
-    for(i=0;i<(int)texCoord.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,texCoord[i]);
-      if(i%2==1) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    fb.format("%s texCoord TextureCoordinate {\n",str);
+    fb.format("%s  point [\n",str);
+    saveVecFloat(fb,indent,texCoord,2);
+    fb.format("%s  ]\n",str);
+    fb.format("%s }\n",str);
 
     if(texCoordIndex.size()>0) {
-      fprintf(fp,"%s texCoordIndex [\n",str);
-      for(i=0;i<(int)texCoordIndex.size();i++) {
-        fprintf(fp,"%s%d ",str,texCoordIndex[i]);
-        if(texCoordIndex[i]<0) fprintf(fp,"%s\n",str);
-      }
-      fprintf(fp,"%s ]\n",str);
+      fb.format("%s texCoordIndex [\n",str);
+      saveVecInt(fb,indent,texCoordIndex,0);
+      fb.format("%s ]\n",str);
     }
   }
 
@@ -367,34 +385,30 @@ void SaverWrl::saveIndexedFaceSet
 
   if(ifsv.hasVertexSelection()) {
     vector<int>& vertexSelection = ifsv.getVertexSelection();
-    fprintf(fp,"%s vertexSelection [\n",str);
-    for(int i=0;i<(int)vertexSelection.size();i++)
-      fprintf(fp,"%s%6d\n",str,vertexSelection[i]);
-    fprintf(fp,"%s ]\n",str);
+    fb.format("%s vertexSelection [\n",str);
+    saveSelection(fb,indent,vertexSelection);
+    fb.format("%s ]\n",str);
   }
   if(ifsv.hasEdgeSelection()) {
     vector<int>& edgeSelection = ifsv.getEdgeSelection();
-    fprintf(fp,"%s edgeSelection [\n",str);
-    for(int i=0;i<(int)edgeSelection.size();i++)
-      fprintf(fp,"%s%6d\n",str,edgeSelection[i]);
-    fprintf(fp,"%s ]\n",str);
+    fb.format("%s edgeSelection [\n",str);
+    saveSelection(fb,indent,edgeSelection);
+    fb.format("%s ]\n",str);
   }
   if(ifsv.hasFaceSelection()) {
     vector<int>& faceSelection = ifsv.getFaceSelection();
-    fprintf(fp,"%s faceSelection [\n",str);
-    for(int i=0;i<(int)faceSelection.size();i++)
-      fprintf(fp,"%s%6d\n",str,faceSelection[i]);
-    fprintf(fp,"%s ]\n",str);
+    fb.format("%s faceSelection [\n",str);
+    saveSelection(fb,indent,faceSelection);
+    fb.format("%s ]\n",str);
   }
   if(ifsv.hasCornerSelection()) {
     vector<int>& cornerSelection = ifsv.getCornerSelection();
-    fprintf(fp,"%s cornerSelection [\n",str);
-    for(int i=0;i<(int)cornerSelection.size();i++)
-      fprintf(fp,"%s%6d\n",str,cornerSelection[i]);
-    fprintf(fp,"%s ]\n",str);
+    fb.format("%s cornerSelection [\n",str);
+    saveSelection(fb,indent,cornerSelection);
+    fb.format("%s ]\n",str);
   }
 
-  fprintf(fp,"%s}\n",str); // IndexedFaceSet
+  fb.format("%s}\n",str); // IndexedFaceSet
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -403,6 +417,7 @@ void SaverWrl::saveIndexedLineSet
   if(indexedLineSet==(IndexedLineSet*)0) return;
 
   const char* str = indent.c_str();
+  FormatBuffer fb(fp);
 
   // IndexedLineSet {
   //   SFNode  coord             NULL
@@ -414,9 +429,9 @@ void SaverWrl::saveIndexedLineSet
 
   const string& name = indexedLineSet->getName();
   if(name=="")
-    fprintf(fp,"%sIndexedLineSet {\n",str);
+    fb.format("%sIndexedLineSet {\n",str);
   else
-    fprintf(fp,"%sDEF %s IndexedLineSet {\n",str,name.c_str());
+    fb.format("%sDEF %s IndexedLineSet {\n",str,name.c_str());
 
   IndexedLineSet& ils = *indexedLineSet;
   IndexedLineSetVariables ilsv(ils);
@@ -428,49 +443,34 @@ void SaverWrl::saveIndexedLineSet
   bool&          colorPerVertex  = ils.getColorPerVertex();
 
   {
-    int i;
-    fprintf(fp,"%s coordIndex [\n",str);
-    for(i=0;i<(int)coordIndex.size();i++) {
-      fprintf(fp,"%s%6d ",str,coordIndex[i]);
-      if(coordIndex[i]<0) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s ]\n",str);
+    fb.format("%s coordIndex [\n",str);
+    saveVecInt(fb,indent,coordIndex,6);
+    fb.format("%s ]\n",str);
   }
 
   // COORD_PER_VERTEX
   {
-    int i;
-    fprintf(fp,"%s coord Coordinate {\n",str);
-    fprintf(fp,"%s  point [\n",str);
-    for(i=0;i<(int)coord.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,coord[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    fb.format("%s coord Coordinate {\n",str);
+    fb.format("%s  point [\n",str);
+    saveVecFloat(fb,indent,coord,3);
+    fb.format("%s  ]\n",str);
+    fb.format("%s }\n",str);
   }
 
   if(color.size()>0) {
-    int i;
-    fprintf(fp,"%s colorPerVertex %s\n",str,
-            (colorPerVertex==true)?"TRUE":"FALSE");
-
-    fprintf(fp,"%s color Color {\n",str);
-    fprintf(fp,"%s  color [\n",str);
-    for(i=0;i<(int)color.size();i++) {
-      fprintf(fp,"%s%8.4f ",str,color[i]);
-      if(i%3==2) fprintf(fp,"%s\n",str);
-    }
-    fprintf(fp,"%s  ]\n",str);
-    fprintf(fp,"%s }\n",str);
+    fb.format("%s colorPerVertex %s\n",str,
+              (colorPerVertex==true)?"TRUE":"FALSE");
+
+    fb.format("%s color Color {\n",str);
+    fb.format("%s  color [\n",str);
+    saveVecFloat(fb,indent,color,3);
+    fb.format("%s  ]\n",str);
+    fb.format("%s }\n",str);
 
     if(colorIndex.size()>0) {
-      fprintf(fp,"%s colorIndex [\n",str);
-      for(i=0;i<(int)colorIndex.size();i++) {
-        fprintf(fp,"%s%d ",str,colorIndex[i]);
-        if(colorIndex[i]<0) fprintf(fp,"%s\n",str);
-      }
-      fprintf(fp,"%s ]\n",str);
+      fb.format("%s colorIndex [\n",str);
+      saveVecInt(fb,indent,colorIndex,0);
+      fb.format("%s ]\n",str);
     }
   }
 
@@ -478,27 +478,24 @@ void SaverWrl::saveIndexedLineSet
 
   if(ilsv.hasVertexSelection()) {
     vector<int>& vertexSelection = ilsv.getVertexSelection();
-    fprintf(fp,"%s vertexSelection [\n",str);
-    for(int i=0;i<(int)vertexSelection.size();i++)
-      fprintf(fp,"%s%6d\n",str,vertexSelection[i]);
-    fprintf(fp,"%s ]\n",str);
+    fb.format("%s vertexSelection [\n",str);
+    saveSelection(fb,indent,vertexSelection);
+    fb.format("%s ]\n",str);
   }
   if(ilsv.hasEdgeSelection()) {
     vector<int>& edgeSelection = ilsv.getEdgeSelection();
-    fprintf(fp,"%s edgeSelection [\n",str);
-    for(int i=0;i<(int)edgeSelection.size();i++)
-      fprintf(fp,"%s%6d\n",str,edgeSelection[i]);
-    fprintf(fp,"%s ]\n",str);
+    fb.format("%s edgeSelection [\n",str);
+    saveSelection(fb,indent,edgeSelection);
+    fb.format("%s ]\n",str);
   }
   if(ilsv.hasPolylineSelection()) {
     vector<int>& polylineSelection = ilsv.getPolylineSelection();
-    fprintf(fp,"%s polylineSelection [\n",str);
-    for(int i=0;i<(int)polylineSelection.size();i++)
-      fprintf(fp,"%s%6d\n",str,polylineSelection[i]);
-    fprintf(fp,"%s ]\n",str);
+    fb.format("%s polylineSelection [\n",str);
+    saveSelection(fb,indent,polylineSelection);
+    fb.format("%s ]\n",str);
   }
   
-  fprintf(fp,"%s}\n",str); // IndexedLineSet
+  fb.format("%s}\n",str); // IndexedLineSet
 }
 
 //////////////////////////////////////////////////////////////////////
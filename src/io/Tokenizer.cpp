@@ -161,6 +161,32 @@ bool Tokenizer::getVec2f(Vec2f& v) {
   return success;
 }
 
+bool Tokenizer::getVecFloat(vector<float>& vec) {
+  float value;
+  while(get()) {
+    if(equals("]"))
+      return true; // done
+    else if(sscanf(&((*this)[0]),"%f",&value)==1)
+      vec.push_back(value);
+    else
+      throw new StrException("expecting float value");
+  }
+  return false;
+}
+
+bool Tokenizer::getVecInt(vector<int>& vec) {
+  int value;
+  while(get()) {
+    if(equals("]"))
+      return true; // done
+    else if(sscanf(&((*this)[0]),"%d",&value)==1)
+      vec.push_back(value);
+    else
+      throw new StrException("expecting int value");
+  }
+  return false;
+}
+
 bool Tokenizer::equals(const char* str) {
   return ((*this)==str);
 }
@@ -49,15 +49,18 @@
 // use TokenizerFile or TokenizerString instead
 class Tokenizer : public string {
 
-private:
+protected:
 
   bool _skip;
 
+private:
+
   virtual char getc() = 0;
 
 public:
 
   Tokenizer();
+  virtual ~Tokenizer() {}
 
   bool get();
   void get(const string& errMsg);
@@ -71,6 +74,14 @@ public:
   bool getVec3f(Vec3f& v);
   bool getVec4f(Vec4f& v);
   bool getVec2f(Vec2f& v);
+
+  // read values, appending them to vec, until a "]" token is found;
+  // return false if the end of file is found first, and throw a
+  // StrException if a token cannot be parsed as a number; derived
+  // classes may override these methods to parse the numbers in place
+  virtual bool getVecFloat(vector<float>& vec);
+  virtual bool getVecInt(vector<int>& vec);
+
   bool equals(const char* str);
   bool expecting(const string& str);
   bool expecting(const char* str);
@@ -0,0 +1,303 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// TokenizerBuffer.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <charconv>
+#include "TokenizerBuffer.hpp"
+#include "StrException.hpp"
+#include <util/Parallel.hpp>
+
+// same separators as in Tokenizer::get()
+static inline bool isBlank(const char c) {
+  return (c==' ' || c=='\t' || c=='\n' || c==',' || c=='\015');
+}
+
+// sscanf() accepts a leading '+' sign, but std::from_chars() does not
+static inline const char* skipPlus(const char* begin, const char* end) {
+  return (end-begin>1 && begin[0]=='+' && begin[1]!='+' && begin[1]!='-')?
+    begin+1:begin;
+}
+
+// copies the token into a null terminated buffer, so that the C
+// library functions can be used on it
+static inline void copyToken
+(const char* begin, const char* end, char* buff, const size_t buffSize) {
+  size_t n = static_cast<size_t>(end-begin);
+  if(n>buffSize-1) n = buffSize-1;
+  memcpy(buff,begin,n);
+  buff[n] = '\0';
+}
+
+// minimum number of bytes parsed by each thread
+static const size_t minBytesPerThread = 1<<20;
+
+// parses all the tokens contained in [begin:end), which should not
+// contain comments, appending the values to vec; the range is split
+// into nThreads chunks, which start and end at separators, the chunks
+// are parsed concurrently into separate vectors, and the vectors are
+// concatenated in order; returns false if a token cannot be parsed
+template<class T>
+static bool parseArray
+(const char* begin, const char* end, vector<T>& vec,
+ bool (*parse)(const char*, const char*, T&), const int nThreads) {
+  const size_t nBytes = static_cast<size_t>(end-begin);
+  vector< vector<T> > chunkValue(nThreads);
+  vector<char>        chunkFailed(nThreads,0);
+  Parallel::forEachRange
+    (nThreads,nBytes,[&](int iT, size_t i0, size_t i1) {
+      // move both ends forward to the next separator; a token which
+      // straddles a boundary belongs to the chunk where it starts
+      const char* p  = begin+i0;
+      const char* p1 = begin+i1;
+      if(iT>0) while(p<end && isBlank(p[-1])==false) p++;
+      while(p1<end && isBlank(p1[-1])==false) p1++;
+      vector<T>& value = chunkValue[iT];
+      value.reserve((p1-p)/4);
+      T v;
+      while(p<p1) {
+        while(p<p1 && isBlank(*p)) p++;
+        if(p==p1) break;
+        const char* q = p;
+        while(q<end && isBlank(*q)==false) q++;
+        if(parse(p,q,v)==false) { chunkFailed[iT] = 1; return; }
+        value.push_back(v);
+        p = q;
+      }
+    });
+  vector<size_t> first(nThreads+1,0);
+  for(int iT=0;iT<nThreads;iT++) {
+    if(chunkFailed[iT]) return false;
+    first[iT+1] = first[iT]+chunkValue[iT].size();
+  }
+  const size_t n0 = vec.size();
+  vec.resize(n0+first[nThreads]);
+  Parallel::forEachRange
+    (nThreads,nThreads,[&](int /*iT*/, size_t iT0, size_t iT1) {
+      for(size_t iT=iT0;iT<iT1;iT++)
+        std::copy(chunkValue[iT].begin(),chunkValue[iT].end(),
+                  vec.begin()+n0+first[iT]);
+    });
+  return true;
+}
+
+TokenizerBuffer::TokenizerBuffer(const char* data, const size_t size):
+  Tokenizer(),
+  _begin(data),
+  _pos(data),
+  _end(data+size) {
+}
+
+char TokenizerBuffer::getc() {
+  return (_pos<_end)?*_pos++:static_cast<char>(EOF);
+}
+
+bool TokenizerBuffer::getline(const char*& begin, const char*& end) {
+  begin = _pos;
+  const char* nl =
+    static_cast<const char*>(memchr(_pos,'\n',static_cast<size_t>(_end-_pos)));
+  end  = (nl!=nullptr)?nl:_end;
+  _pos = (nl!=nullptr)?nl+1:_end;
+  return (end>begin);
+}
+
+bool TokenizerBuffer::getToken(const char*& begin, const char*& end) {
+  for(;;) {
+    // skip blank space
+    while(_pos<_end && isBlank(*_pos)) _pos++;
+    if(_pos==_end) return false;
+    // collect token characters
+    begin = _pos;
+    while(_pos<_end && isBlank(*_pos)==false) _pos++;
+    end = _pos;
+    // the separator following the token is consumed, as in get()
+    bool endOfLine = (_pos<_end && *_pos=='\n');
+    if(_pos<_end) _pos++;
+    if(*begin!='#') return true;
+    // if comment, the token extends to the end of the line
+    if(endOfLine==false) {
+      const char* nl =
+        static_cast<const char*>(memchr(_pos,'\n',
+                                        static_cast<size_t>(_end-_pos)));
+      end  = (nl!=nullptr)?nl:_end;
+      _pos = (nl!=nullptr)?nl+1:_end;
+    }
+    if(_skip==false) return true;
+  }
+}
+
+// returns the position of the "]" token which closes the array
+// starting at the current position, or nullptr if a comment is found
+// first, or if there is no such token
+const char* TokenizerBuffer::_findArrayEnd() const {
+  bool tokenStart = true;
+  for(const char* p=_pos;p<_end;p++) {
+    if(isBlank(*p)) {
+      tokenStart = true;
+    } else if(tokenStart) {
+      if(*p=='#') return nullptr;
+      if(*p==']' && (p+1==_end || isBlank(p[1]))) return p;
+      tokenStart = false;
+    }
+  }
+  return nullptr;
+}
+
+// if the array is large enough and the default number of threads is
+// larger than 1, parses the values in parallel, consumes the closing
+// "]", and returns true; otherwise returns false without consuming
+// any input
+template<class T>
+bool TokenizerBuffer::_getVecParallel
+(vector<T>& vec, bool (*parse)(const char*, const char*, T&),
+ const char* errMsg) {
+  const size_t nBytes = static_cast<size_t>(_end-_pos);
+  if(Parallel::getNumberOfThreads(0,nBytes,minBytesPerThread)<=1)
+    return false;
+  const char* close = _findArrayEnd();
+  if(close==nullptr) return false;
+  const int nThreads =
+    Parallel::getNumberOfThreads(0,static_cast<size_t>(close-_pos),
+                                 minBytesPerThread);
+  if(nThreads<=1) return false;
+  if(parseArray(_pos,close,vec,parse,nThreads)==false)
+    throw new StrException(errMsg);
+  // consume the "]" and the separator following it, as in get()
+  _pos = close+1;
+  if(_pos<_end) _pos++;
+  assign("]");
+  return true;
+}
+
+bool TokenizerBuffer::getVecFloat(vector<float>& vec) {
+  if(_skip && _getVecParallel(vec,parseFloat,"expecting float value"))
+    return true;
+  const char *begin,*end;
+  float value;
+  while(getToken(begin,end)) {
+    if(end-begin==1 && *begin==']') {
+      assign(begin,end);
+      return true; // done
+    } else if(parseFloat(begin,end,value)) {
+      vec.push_back(value);
+    } else {
+      throw new StrException("expecting float value");
+    }
+  }
+  clear();
+  return false;
+}
+
+bool TokenizerBuffer::getVecInt(vector<int>& vec) {
+  if(_skip && _getVecParallel(vec,parseInt,"expecting int value"))
+    return true;
+  const char *begin,*end;
+  int value;
+  while(getToken(begin,end)) {
+    if(end-begin==1 && *begin==']') {
+      assign(begin,end);
+      return true; // done
+    } else if(parseInt(begin,end,value)) {
+      vec.push_back(value);
+    } else {
+      throw new StrException("expecting int value");
+    }
+  }
+  clear();
+  return false;
+}
+
+// static
+bool TokenizerBuffer::parseInt(const char* begin, const char* end, int& i) {
+  std::from_chars_result r = std::from_chars(skipPlus(begin,end),end,i);
+  if(r.ec==std::errc()) return true;
+  if(r.ec==std::errc::invalid_argument) return false;
+  // out of range
+  long l;
+  if(parseLong(begin,end,l)==false) return false;
+  i = static_cast<int>(l);
+  return true;
+}
+
+// static
+bool TokenizerBuffer::parseLong(const char* begin, const char* end, long& l) {
+  std::from_chars_result r = std::from_chars(skipPlus(begin,end),end,l);
+  if(r.ec==std::errc()) return true;
+  if(r.ec==std::errc::invalid_argument) return false;
+  // out of range
+  char buff[128],*last;
+  copyToken(begin,end,buff,sizeof(buff));
+  l = strtol(buff,&last,10);
+  return (last!=buff);
+}
+
+// the floating point std::from_chars() functions are not available
+// in all the standard libraries; when they are not, or when they
+// reject a token that the C library accepts (such as hexadecimal
+// values or values out of range), strtof() and strtod() are used
+// instead
+
+// static
+bool TokenizerBuffer::parseFloat(const char* begin, const char* end, float& f) {
+#ifdef __cpp_lib_to_chars
+  std::from_chars_result r = std::from_chars(skipPlus(begin,end),end,f);
+  if(r.ec==std::errc() &&
+     (r.ptr==end || (*r.ptr!='x' && *r.ptr!='X'))) return true;
+#endif
+  char buff[128],*last;
+  copyToken(begin,end,buff,sizeof(buff));
+  f = strtof(buff,&last);
+  return (last!=buff);
+}
+
+// static
+bool TokenizerBuffer::parseDouble(const char* begin, const char* end, double& d) {
+#ifdef __cpp_lib_to_chars
+  std::from_chars_result r = std::from_chars(skipPlus(begin,end),end,d);
+  if(r.ec==std::errc() &&
+     (r.ptr==end || (*r.ptr!='x' && *r.ptr!='X'))) return true;
+#endif
+  char buff[128],*last;
+  copyToken(begin,end,buff,sizeof(buff));
+  d = strtod(buff,&last);
+  return (last!=buff);
+}
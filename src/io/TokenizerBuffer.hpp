@@ -0,0 +1,103 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin / 3D Shape Tech LLC
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// TokenizerBuffer.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef TOKENIZER_BUFFER_HPP
+#define TOKENIZER_BUFFER_HPP
+
+#include "Tokenizer.hpp"
+
+// Tokenizer over a block of memory, such as the contents of a
+// MappedFile; the buffer is not copied, and must remain valid while
+// the tokenizer is in use; in addition to the string based interface
+// of the base class, lines and tokens can be obtained in place, as
+// ranges [begin:end) of the buffer, and numbers are parsed in place,
+// without creating a string per token
+
+class TokenizerBuffer : public Tokenizer {
+
+private:
+
+  const char* _begin;
+  const char* _pos;
+  const char* _end;
+
+  virtual char getc();
+
+  const char* _findArrayEnd() const;
+
+  template<class T>
+  bool        _getVecParallel
+              (vector<T>& vec, bool (*parse)(const char*, const char*, T&),
+               const char* errMsg);
+
+public:
+
+  TokenizerBuffer(const char* data, const size_t size);
+
+  // number of bytes consumed so far
+  size_t getPosition() const { return static_cast<size_t>(_pos-_begin); }
+
+  using Tokenizer::getline;
+
+  // same as getline(), but the line is returned in place
+  bool getline(const char*& begin, const char*& end);
+
+  // same as get(), including the handling of comments, but the token
+  // is returned in place
+  bool getToken(const char*& begin, const char*& end);
+
+  // large arrays without comments are split into chunks, which are
+  // parsed in parallel using the default number of threads (see
+  // util/Parallel.hpp)
+  virtual bool getVecFloat(vector<float>& vec);
+  virtual bool getVecInt(vector<int>& vec);
+
+  // parse a number from the beginning of the character range
+  // [begin:end), as sscanf() would do from a string containing the
+  // same characters; return false if no number can be parsed
+  static bool parseInt(const char* begin, const char* end, int& i);
+  static bool parseLong(const char* begin, const char* end, long& l);
+  static bool parseFloat(const char* begin, const char* end, float& f);
+  static bool parseDouble(const char* begin, const char* end, double& d);
+
+};
+
+#endif // TOKENIZER_BUFFER_HPP
@@ -32,25 +32,41 @@
 // (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
 #include <string>
+#include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
+#include <chrono>
+#include <functional>
 
 using namespace std;
 
+#include <wrl/SceneGraphProcessor.hpp>
 #include <wrl/SceneGraphTraversal.hpp>
 
 #include <io/AppLoader.hpp>
 #include <io/AppSaver.hpp>
+#include <io/LoaderDgp.hpp>
 #include <io/LoaderPly.hpp>
 #include <io/LoaderStl.hpp>
 #include <io/LoaderWrl.hpp>
+#include <io/SaverDgp.hpp>
 #include <io/SaverPly.hpp>
 #include <io/SaverStl.hpp>
 #include <io/SaverWrl.hpp>
 
+#include <core/Graph.hpp>
+#include <core/HexGridPartition.hpp>
 #include <core/PolygonMesh.hpp>
 #include <core/PolygonMeshTest.hpp>
 
+#include <util/DgpFile.hpp>
+#include <util/Parallel.hpp>
+
 #include "dgpPrt.hpp"
 
 enum Operation {
@@ -82,6 +98,17 @@ public:
   bool   _debug;
   bool   _binaryOutput;
   bool   _removeProperties;
+  bool   _reorder;
+  bool   _benchmarkEdges;
+  bool   _benchmarkCC;
+  bool   _benchmarkUpdate;
+  bool   _benchmarkCache;
+  bool   _benchmarkIndex64;
+  int    _benchmarkStream;
+  int    _nThreads;
+  bool   _weldStl;
+  float  _weldEpsilon;
+  string _cacheDir;
 
   // TODO Mon Mar 6 2023
   // - add variables to specify the operation to be performed
@@ -94,6 +121,17 @@ public:
     _debug(false),
     _binaryOutput(false),
     _removeProperties(false),
+    _reorder(false),
+    _benchmarkEdges(false),
+    _benchmarkCC(false),
+    _benchmarkUpdate(false),
+    _benchmarkCache(false),
+    _benchmarkIndex64(false),
+    _benchmarkStream(0),
+    _nThreads(1),
+    _weldStl(false),
+    _weldEpsilon(0.0f),
+    _cacheDir(""),
     _operation(NONE),
     _inFile(""),
     _outFile("")
@@ -101,9 +139,20 @@ public:
 };
 
 void options(Data& D) {
-  cout << "   -d|-debug               [" << tv(D._debug)            << "]" << endl;
-  cout << "   -b|-binaryOutput        [" << tv(D._binaryOutput)     << "]" << endl;
-  cout << "   -r|-removeProperties    [" << tv(D._removeProperties) << "]" << endl;
+  cout << "     -d|-debug               [" << tv(D._debug)            << "]" << endl;
+  cout << "     -b|-binaryOutput        [" << tv(D._binaryOutput)     << "]" << endl;
+  cout << "     -r|-removeProperties    [" << tv(D._removeProperties) << "]" << endl;
+  cout << "    -ro|-reorder             [" << tv(D._reorder)          << "]" << endl;
+  cout << "    -be|-benchmarkEdges      [" << tv(D._benchmarkEdges)   << "]" << endl;
+  cout << "   -bcc|-benchmarkCC         [" << tv(D._benchmarkCC)      << "]" << endl;
+  cout << "    -bu|-benchmarkUpdate     [" << tv(D._benchmarkUpdate)  << "]" << endl;
+  cout << "   -bca|-benchmarkCache      [" << tv(D._benchmarkCache)   << "]" << endl;
+  cout << "  -bi64|-benchmarkIndex64    [" << tv(D._benchmarkIndex64) << "]" << endl;
+  cout << "    -bs|-benchmarkStream N   [" << D._benchmarkStream      << "]" << endl;
+  cout << "     -t|-threads n           [" << D._nThreads             << "]" << endl;
+  cout << "     -w|-weldStl             [" << tv(D._weldStl)          << "]" << endl;
+  cout << "    -we|-weldEpsilon eps     [" << D._weldEpsilon          << "]" << endl;
+  cout << "     -c|-cacheDir dir        [" << D._cacheDir             << "]" << endl;
 
   // TODO Mon Mar 6 2023
   // - add line(s) to explain how to specify the operation to be performed
@@ -114,7 +163,7 @@ void options(Data& D) {
 
 void usage(Data& D) {
   cout << "USAGE: dgpTest3 [options] inFile outFile" << endl;
-  cout << "   -h|-help" << endl;
+  cout << "     -h|-help" << endl;
   options(D);
   cout << endl;
   exit(0);
@@ -124,7 +173,570 @@ void error(const char *msg) {
   cout << "ERROR: dgpTest3 | " << ((msg)?msg:"") << endl;
   exit(0);
 }
-
+
+// calls f(iIfs,ifs) for each IndexedFaceSet ifs of the scene graph,
+// numbered 0<=iIfs in traversal order
+void forEachIndexedFaceSet
+(SceneGraph& wrl, const function<void(int,IndexedFaceSet&)>& f) {
+  Node* node;
+  SceneGraphTraversal sgt(wrl);
+  for(int iIfs=0;(node=sgt.next())!=(Node*)0;) {
+    Shape* shape = dynamic_cast<Shape*>(node);
+    if(shape==(Shape*)0) continue;
+    IndexedFaceSet* ifs = dynamic_cast<IndexedFaceSet*>(shape->getGeometry());
+    if(ifs==(IndexedFaceSet*)0) continue;
+    f(iIfs++,*ifs);
+  }
+}
+
+// returns the time taken by f() in milliseconds
+double timeMs(const function<void()>& f) {
+  auto t0 = chrono::steady_clock::now();
+  f();
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<double,milli>(t1-t0).count();
+}
+
+// prints the results of a benchmark for one IndexedFaceSet, as a
+// block of "name = value" lines, followed by one line for each
+// failed check, and closed when the report is destroyed
+class IfsReport {
+public:
+  IfsReport(const int iIfs, const string& indent):
+    _indent(indent) {
+    cout << _indent << "  IndexedFaceSet[" << iIfs << "] {" << endl;
+  }
+  ~IfsReport() {
+    cout << _indent << "  }" << endl;
+  }
+  template<class T>
+  void value(const string& name, const T& value) {
+    cout << _indent << "    " << name;
+    if(name.size()<14) cout << string(14-name.size(),' ');
+    cout << " = " << value << endl;
+  }
+  void check(const bool ok, const string& error) {
+    if(ok==false) cout << _indent << "    ERROR " << error << endl;
+  }
+private:
+  const string _indent;
+};
+
+// inserts the edges of all the faces of the IndexedFaceSet into a
+// Graph, the same way the HalfEdges constructor does, and returns the
+// elapsed time in milliseconds
+double timeEdgesBuild
+(const int nV, const vector<int>& coordIndex,
+ const Edges::Backend backend, int& nE) {
+  return timeMs([&]() {
+      Graph graph(nV,backend);
+      int nC = static_cast<int>(coordIndex.size());
+      int iC,iC0,iV0,iV1;
+      for(iC0=iC=0;iC<nC;iC++) {
+        if(coordIndex[iC]>=0) continue;
+        // face loop [iC0:iC)
+        for(int jC=iC0;jC<iC;jC++) {
+          iV0 = coordIndex[jC];
+          iV1 = coordIndex[(jC+1<iC)?jC+1:iC0];
+          graph.insertEdge(iV0,iV1);
+        }
+        iC0 = iC+1;
+      }
+      nE = graph.getNumberOfEdges();
+    });
+}
+
+// same as the previous function, but using the bulk sort-based
+// Graph::buildFromFaces() method
+double timeEdgesBuildFromFaces
+(const int nV, const vector<int>& coordIndex, int& nE) {
+  return timeMs([&]() {
+      Graph graph(nV);
+      graph.buildFromFaces(nV,coordIndex);
+      nE = graph.getNumberOfEdges();
+    });
+}
+
+void benchmarkEdges(SceneGraph& wrl, const string& indent) {
+  cout << indent << "benchmarkEdges {" << endl;
+  forEachIndexedFaceSet(wrl,[&](int iIfs, IndexedFaceSet& ifs) {
+      int nV = ifs.getNumberOfCoord();
+      vector<int>& coordIndex = ifs.getCoordIndex();
+      int nEList=0,nEHash=0,nESort=0;
+      double tList = timeEdgesBuild(nV,coordIndex,Edges::LINKED_LIST,nEList);
+      double tHash = timeEdgesBuild(nV,coordIndex,Edges::HASH_TABLE,nEHash);
+      double tSort = timeEdgesBuildFromFaces(nV,coordIndex,nESort);
+      IfsReport report(iIfs,indent);
+      report.value("nV",nV);
+      report.value("nC",coordIndex.size());
+      report.value("nE",nEList);
+      report.value("LINKED_LIST ms",tList);
+      report.value("HASH_TABLE  ms",tHash);
+      report.value("BULK_SORT   ms",tSort);
+      report.check(nEHash==nEList,"nE(HASH_TABLE) = "+to_string(nEHash));
+      report.check(nESort==nEList,"nE(BULK_SORT) = "+to_string(nESort));
+    });
+  cout << indent << "} benchmarkEdges" << endl;
+}
+
+// computes the connected components of the primal graph with one
+// thread, and with nThreads threads, and compares the results; the
+// PolygonMesh construction is not included in the times
+void benchmarkConnectedComponents
+(SceneGraph& wrl, const int nThreads, const string& indent) {
+  cout << indent << "benchmarkConnectedComponents {" << endl;
+  forEachIndexedFaceSet(wrl,[&](int iIfs, IndexedFaceSet& ifs) {
+      int nV = ifs.getNumberOfCoord();
+      vector<int>& coordIndex = ifs.getCoordIndex();
+      PolygonMesh pmesh1(nV,coordIndex,Edges::LINKED_LIST,1);
+      PolygonMesh pmeshN(nV,coordIndex,Edges::LINKED_LIST,nThreads);
+      vector<int> faceLabel1,faceLabelN;
+      int nCC1 = 0,nCCN = 0;
+      double t1 = timeMs([&]() {
+          nCC1 = pmesh1.computeConnectedComponentsPrimal(faceLabel1);
+        });
+      double tN = timeMs([&]() {
+          nCCN = pmeshN.computeConnectedComponentsPrimal(faceLabelN);
+        });
+      IfsReport report(iIfs,indent);
+      report.value("nV",nV);
+      report.value("nF",pmesh1.getNumberOfFaces());
+      report.value("nCC",nCC1);
+      report.value("1 thread    ms",t1);
+      report.value(to_string(nThreads)+" threads   ms",tN);
+      report.check(nCCN==nCC1 && faceLabelN==faceLabel1,
+                   "results differ, nCC = "+to_string(nCCN));
+    });
+  cout << indent << "} benchmarkConnectedComponents" << endl;
+}
+
+// returns true if the two meshes have the same edges, twins, vertex
+// stars, and classification tables; the two meshes may have
+// different index types
+template<class Mesh0, class Mesh1>
+bool sameTopology(const Mesh0& pm0, const Mesh1& pm1) {
+  int64_t nV = pm0.getNumberOfVertices();
+  int64_t nE = pm0.getNumberOfEdges();
+  int64_t nC = pm0.getNumberOfCorners();
+  if(pm1.getNumberOfVertices()!=nV || pm1.getNumberOfEdges()!=nE ||
+     pm1.getNumberOfCorners()!=nC)
+    return false;
+  int64_t iV,iE,iC,j;
+  for(iC=0;iC<nC;iC++)
+    if(pm0.getTwin(iC)!=pm1.getTwin(iC)) return false;
+  for(iE=0;iE<nE;iE++) {
+    if(pm0.getVertex0(iE)!=pm1.getVertex0(iE) ||
+       pm0.getVertex1(iE)!=pm1.getVertex1(iE) ||
+       pm0.getNumberOfEdgeHalfEdges(iE)!=pm1.getNumberOfEdgeHalfEdges(iE))
+      return false;
+    for(j=0;j<pm0.getNumberOfEdgeHalfEdges(iE);j++)
+      if(pm0.getEdgeHalfEdge(iE,j)!=pm1.getEdgeHalfEdge(iE,j)) return false;
+  }
+  for(iV=0;iV<nV;iV++) {
+    if(pm0.getNumberOfVertexCorners(iV)!=pm1.getNumberOfVertexCorners(iV) ||
+       pm0.getNumberOfVertexEdges(iV)!=pm1.getNumberOfVertexEdges(iV) ||
+       pm0.isBoundaryVertex(iV)!=pm1.isBoundaryVertex(iV) ||
+       pm0.isSingularVertex(iV)!=pm1.isSingularVertex(iV) ||
+       pm0.isIsolatedVertex(iV)!=pm1.isIsolatedVertex(iV))
+      return false;
+    for(j=0;j<pm0.getNumberOfVertexCorners(iV);j++)
+      if(pm0.getVertexCorner(iV,j)!=pm1.getVertexCorner(iV,j)) return false;
+    for(j=0;j<pm0.getNumberOfVertexEdges(iV);j++)
+      if(pm0.getVertexEdge(iV,j)!=pm1.getVertexEdge(iV,j)) return false;
+  }
+  return true;
+}
+
+// flips one out of every 16 faces of a copy of each IndexedFaceSet,
+// and compares the time required to patch a PolygonMesh with the
+// time required to build a new one; the same is done after adding
+// isolated vertices, and removing them
+void benchmarkUpdate
+(SceneGraph& wrl, const int nThreads, const string& indent) {
+  cout << indent << "benchmarkUpdate {" << endl;
+  forEachIndexedFaceSet(wrl,[&](int iIfs, IndexedFaceSet& ifs) {
+      int nV = ifs.getNumberOfCoord();
+      vector<int> coordIndex(ifs.getCoordIndex());
+      PolygonMesh pmesh(nV,coordIndex,Edges::LINKED_LIST,nThreads);
+      int nF = pmesh.getNumberOfFaces();
+      int nC = pmesh.getNumberOfCorners();
+
+      // flip the faces in place
+      vector<bool> flipped(nF,false);
+      int iF,iC,iC0,iC1;
+      for(iF=0;iF<nF;iF+=16) flipped[iF] = true;
+      for(iF=iC0=iC1=0;iC1<=nC;iC1++) {
+        if(iC1<nC && coordIndex[iC1]>=0) continue;
+        if(iF<nF && flipped[iF])
+          for(iC=iC0;iC<iC0+(iC1-iC0)/2;iC++)
+            swap(coordIndex[iC],coordIndex[iC0+iC1-1-iC]);
+        iC0 = iC1+1; iF++;
+      }
+      bool flipOk = false;
+      unique_ptr<PolygonMesh> pmeshFlip;
+      double tFlipUpdate = timeMs([&]() {
+          flipOk = pmesh.updateFlippedFaces(flipped);
+        });
+      double tFlipBuild = timeMs([&]() {
+          pmeshFlip.reset
+            (new PolygonMesh(nV,coordIndex,Edges::LINKED_LIST,nThreads));
+        });
+      flipOk = flipOk && sameTopology(pmesh,*pmeshFlip);
+
+      // add one isolated vertex out of every 16, and remove them
+      int nVadd = nV+nV/16;
+      vector<int> vMap(nV);
+      for(int iV=0;iV<nV;iV++) vMap[iV] = iV+iV/16;
+      for(iC=0;iC<nC;iC++)
+        if(coordIndex[iC]>=0) coordIndex[iC] = vMap[coordIndex[iC]];
+      PolygonMesh pmeshAdd(nVadd,coordIndex,Edges::LINKED_LIST,nThreads);
+      vector<int> coordMap,coordIndexOut;
+      pmeshAdd.removeIsolatedVertices(coordMap,coordIndexOut);
+      // the update must be rejected, leaving the tables unchanged,
+      // while coordIndex has not been renumbered yet
+      bool rejectOk = true;
+      for(int iVout=0;iVout<static_cast<int>(coordMap.size());iVout++)
+        if(coordMap[iVout]!=iVout) {
+          rejectOk = (pmeshAdd.updateRemovedVertices(coordMap)==false);
+          break;
+        }
+      coordIndex.swap(coordIndexOut);
+      bool removeOk = false;
+      unique_ptr<PolygonMesh> pmeshRemove;
+      double tRemoveUpdate = timeMs([&]() {
+          removeOk = pmeshAdd.updateRemovedVertices(coordMap);
+        });
+      int nVremove = static_cast<int>(coordMap.size());
+      double tRemoveBuild = timeMs([&]() {
+          pmeshRemove.reset
+            (new PolygonMesh(nVremove,coordIndex,Edges::LINKED_LIST,nThreads));
+        });
+      removeOk = removeOk && rejectOk && sameTopology(pmeshAdd,*pmeshRemove);
+
+      IfsReport report(iIfs,indent);
+      report.value("nV",nV);
+      report.value("nF",nF);
+      report.value("flip update ms",tFlipUpdate);
+      report.value("flip build  ms",tFlipBuild);
+      report.value("remove update ms",tRemoveUpdate);
+      report.value("remove build  ms",tRemoveBuild);
+      report.check(flipOk,"flipped faces update");
+      report.check(removeOk,"removed vertices update");
+    });
+  cout << indent << "} benchmarkUpdate" << endl;
+}
+
+// one value of an int section of a DgpFile, to be overwritten in
+// place
+struct CachePatch {
+  const char* tag;
+  size_t      index;
+  int         value;
+};
+
+// overwrites the values of the patches in the DgpFile filename, which
+// is assumed to have the byte order of the system; returns false if a
+// section is not found, or if an index is out of range
+bool patchCacheFile(const string& filename, const vector<CachePatch>& patch) {
+  // the positions of the values are looked up in the section table,
+  // and the mapping is closed before the file is written
+  vector<size_t> position;
+  {
+    DgpFile dgp;
+    if(dgp.open(filename.c_str())==false) return false;
+    for(const CachePatch& p : patch) {
+      if(p.index>=dgp.getSectionCount(p.tag)) return false;
+      position.push_back(dgp.getSectionOffset(p.tag)+sizeof(int)*p.index);
+    }
+  }
+  fstream file(filename.c_str(),ios::in|ios::out|ios::binary);
+  if(!file) return false;
+  for(size_t iP=0;iP<patch.size();iP++) {
+    file.seekp(static_cast<streamoff>(position[iP]));
+    if(!file.write(reinterpret_cast<const char*>(&patch[iP].value),
+                   sizeof(int)))
+      return false;
+  }
+  return true;
+}
+
+bool readFile(const string& filename, vector<char>& bytes) {
+  ifstream file(filename.c_str(),ios::binary);
+  if(!file) return false;
+  bytes.assign(istreambuf_iterator<char>(file),istreambuf_iterator<char>());
+  return true;
+}
+
+// writes the topology cache file of each IndexedFaceSet, and reads it
+// back; the file is then corrupted in several ways, by overwriting a
+// few values of the twin and half-edge tables; each corrupted file
+// must be rejected, so that the tables are rebuilt, the same as the
+// ones built without the cache, and the file is rewritten with its
+// original contents
+void benchmarkCache
+(SceneGraph& wrl, const int nThreads, const string& indent) {
+  cout << indent << "benchmarkCache {" << endl;
+  const string cacheDirectory = PolygonMesh::getCacheDirectory();
+  if(cacheDirectory.empty()) {
+    cout << indent << "  ERROR no cache directory, use -c dir" << endl;
+    cout << indent << "} benchmarkCache" << endl;
+    return;
+  }
+  forEachIndexedFaceSet(wrl,[&](int iIfs, IndexedFaceSet& ifs) {
+      int nV = ifs.getNumberOfCoord();
+      vector<int>& coordIndex = ifs.getCoordIndex();
+      int nC = static_cast<int>(coordIndex.size());
+      char name[32];
+      snprintf(name,32,"%016llx.topo",static_cast<unsigned long long>
+               (PolygonMesh::hashTopology(nV,coordIndex)));
+      const string filename = cacheDirectory+"/"+name;
+      remove(filename.c_str());
+
+      PolygonMesh::setCacheDirectory("");
+      PolygonMesh pmesh(nV,coordIndex,Edges::LINKED_LIST,nThreads);
+      PolygonMesh::setCacheDirectory(cacheDirectory);
+      unique_ptr<PolygonMesh> pmeshWrite,pmeshRead;
+      double tWrite = timeMs([&]() {
+          pmeshWrite.reset
+            (new PolygonMesh(nV,coordIndex,Edges::LINKED_LIST,nThreads));
+        });
+      double tRead = timeMs([&]() {
+          pmeshRead.reset
+            (new PolygonMesh(nV,coordIndex,Edges::LINKED_LIST,nThreads));
+        });
+      vector<char> original,rewritten;
+      bool readOk = readFile(filename,original) &&
+        sameTopology(pmesh,*pmeshWrite) && sameTopology(pmesh,*pmeshRead);
+
+      // a corner iC0 with a twin, the first corner iC1 of a different
+      // edge with a twin, and a separator
+      int iC,iC0 = -1,iC1 = -1,iCsep = -1;
+      for(iC=0;iC<nC;iC++) {
+        if(coordIndex[iC]<0) {
+          if(iCsep<0) iCsep = iC;
+        } else if(pmesh.getTwin(iC)>=0) {
+          if(iC0<0) iC0 = iC;
+          else if(iC1<0 && iC!=pmesh.getTwin(iC0)) iC1 = iC;
+        }
+      }
+      vector< vector<CachePatch> > corruption;
+      if(iC0>=0 && iCsep>=0) {
+        // twin on a separator
+        corruption.push_back({{"he.twin",static_cast<size_t>(iC0),iCsep}});
+        // half edge of an edge on a separator
+        corruption.push_back({{"he.cornerEdge",0,iCsep}});
+      }
+      if(iC0>=0) {
+        // twins which are not mutual
+        corruption.push_back({{"he.twin",static_cast<size_t>(iC0),-1}});
+      }
+      if(iC0>=0 && iC1>=0) {
+        // mutual twins on two different edges
+        corruption.push_back({{"he.twin",static_cast<size_t>(iC0),iC1},
+                              {"he.twin",static_cast<size_t>(iC1),iC0}});
+      }
+      int nRebuilt = 0;
+      for(const vector<CachePatch>& patch : corruption) {
+        if(patchCacheFile(filename,patch)==false) continue;
+        PolygonMesh pmeshRebuild(nV,coordIndex,Edges::LINKED_LIST,nThreads);
+        if(sameTopology(pmesh,pmeshRebuild) &&
+           readFile(filename,rewritten) && rewritten==original)
+          nRebuilt++;
+      }
+
+      IfsReport report(iIfs,indent);
+      report.value("nV",nV);
+      report.value("nC",nC);
+      report.value("build+write ms",tWrite);
+      report.value("read        ms",tRead);
+      report.value("corrupted files rebuilt",
+                   to_string(nRebuilt)+"/"+to_string(corruption.size()));
+      report.check(readOk,"cached tables differ");
+      report.check(nRebuilt==static_cast<int>(corruption.size()),
+                   "corrupted cache file not rebuilt");
+    });
+  cout << indent << "} benchmarkCache" << endl;
+}
+
+// returns true if the two arrays have the same values
+template<class T0, class T1>
+bool sameValues(const vector<T0>& a0, const vector<T1>& a1) {
+  return a0.size()==a1.size() && equal(a0.begin(),a0.end(),a1.begin());
+}
+
+// builds a PolygonMesh and a PolygonMesh64 on each IndexedFaceSet, and
+// compares the tables, the connected components, and the orientation;
+// if a cache directory is specified, the .topo64 cache file is also
+// written and read back
+void benchmarkIndex64
+(SceneGraph& wrl, const int nThreads, const string& indent) {
+  cout << indent << "benchmarkIndex64 {" << endl;
+  const string cacheDirectory = PolygonMesh::getCacheDirectory();
+  forEachIndexedFaceSet(wrl,[&](int iIfs, IndexedFaceSet& ifs) {
+      int nV = ifs.getNumberOfCoord();
+      vector<int>& coordIndex = ifs.getCoordIndex();
+      string filename = "";
+      if(cacheDirectory.empty()==false) {
+        char name[32];
+        snprintf(name,32,"%016llx.topo64",static_cast<unsigned long long>
+                 (PolygonMesh64::hashTopology(nV,coordIndex)));
+        filename = cacheDirectory+"/"+name;
+        remove(filename.c_str());
+      }
+
+      PolygonMesh::setCacheDirectory("");
+      unique_ptr<PolygonMesh>   pmesh;
+      unique_ptr<PolygonMesh64> pmesh64;
+      double t32 = timeMs([&]() {
+          pmesh.reset
+            (new PolygonMesh(nV,coordIndex,Edges::LINKED_LIST,nThreads));
+        });
+      double t64 = timeMs([&]() {
+          pmesh64.reset
+            (new PolygonMesh64(nV,coordIndex,Edges64::LINKED_LIST,nThreads));
+        });
+      PolygonMesh::setCacheDirectory(cacheDirectory);
+      bool topologyOk = sameTopology(*pmesh,*pmesh64);
+
+      vector<int>     faceLabel,ccIndex;
+      vector<int64_t> faceLabel64,ccIndex64;
+      vector<bool>    invertFace,invertFace64;
+      bool ccOk =
+        pmesh->computeConnectedComponentsPrimal(faceLabel)==
+        pmesh64->computeConnectedComponentsPrimal(faceLabel64) &&
+        sameValues(faceLabel,faceLabel64) &&
+        pmesh->computeConnectedComponentsDual(faceLabel)==
+        pmesh64->computeConnectedComponentsDual(faceLabel64) &&
+        sameValues(faceLabel,faceLabel64);
+      bool orientOk =
+        pmesh->isOriented()==pmesh64->isOriented() &&
+        pmesh->isOrientable()==pmesh64->isOrientable() &&
+        pmesh->orient(ccIndex,invertFace)==
+        pmesh64->orient(ccIndex64,invertFace64) &&
+        sameValues(ccIndex,ccIndex64) && invertFace==invertFace64;
+
+      bool cacheOk = true;
+      if(filename.empty()==false) {
+        PolygonMesh64 pmeshWrite(nV,coordIndex,Edges64::LINKED_LIST,nThreads);
+        PolygonMesh64 pmeshRead(nV,coordIndex,Edges64::LINKED_LIST,nThreads);
+        vector<char> bytes;
+        cacheOk = readFile(filename,bytes) && bytes.empty()==false &&
+          sameTopology(*pmesh,pmeshWrite) && sameTopology(*pmesh,pmeshRead);
+      }
+
+      IfsReport report(iIfs,indent);
+      report.value("nV",nV);
+      report.value("nC",coordIndex.size());
+      report.value("int     build ms",t32);
+      report.value("int64_t build ms",t64);
+      report.check(topologyOk,"tables differ");
+      report.check(ccOk,"connected components differ");
+      report.check(orientOk,"orientation differs");
+      report.check(cacheOk,"cached 64-bit tables differ");
+    });
+  cout << indent << "} benchmarkIndex64" << endl;
+}
+
+// returns true if the samples are one per occupied cell of hgp, in
+// the order of the cells, each one contained in its own cell; the
+// samples are inserted into a second partition with the same grid,
+// which must have the same cells, with one point each
+bool samplesInCells(HexGridPartition& hgp, const vector<float>& coordSample) {
+  const int nCells = hgp.getNumberOfCells();
+  if(static_cast<int>(coordSample.size())!=3*nCells) return false;
+  HexGridPartition check(hgp.getMin(),hgp.getMax(),hgp.getResolution());
+  if(check.insertPoints(coordSample)==false ||
+     check.getNumberOfCells()!=nCells) return false;
+  for(int i=0;i<nCells;i++)
+    if(check.getCellId(i)!=hgp.getCellId(i) ||
+       check.getCellNumberOfPoints(i)!=1) return false;
+  return true;
+}
+
+// samples the vertices of each IndexedFaceSet on a grid of the given
+// resolution, once with HexGridPartition::sample(), and once by
+// feeding the points in chunks of 4096 through the streaming
+// interface; both must produce one sample per occupied cell, in the
+// same cell order; the streaming samples are approximations, and the
+// number of them equal to the in-memory samples is reported
+void benchmarkStream
+(SceneGraph& wrl, const int resolution, const int nThreads,
+ const string& indent) {
+  cout << indent << "benchmarkStream {" << endl;
+  const int chunkSize = 4096;
+  forEachIndexedFaceSet(wrl,[&](int iIfs, IndexedFaceSet& ifs) {
+      const vector<float>& coord  = ifs.getCoord();
+      const vector<float>& normal = ifs.getNormal();
+      const int nPoints = static_cast<int>(coord.size()/3);
+      if(nPoints==0) return;
+      const bool hasNormal =
+        ifs.getNormalBinding()==IndexedFaceSet::PB_PER_VERTEX &&
+        normal.size()==coord.size();
+
+      // grid slightly larger than the bounding box of the points
+      Vec3f min(coord[0],coord[1],coord[2]),max(min);
+      for(int iP=1;iP<nPoints;iP++) {
+        const float* p = coord.data()+3*iP;
+        if(p[0]<min.x) min.x = p[0];
+        if(p[0]>max.x) max.x = p[0];
+        if(p[1]<min.y) min.y = p[1];
+        if(p[1]>max.y) max.y = p[1];
+        if(p[2]<min.z) min.z = p[2];
+        if(p[2]>max.z) max.z = p[2];
+      }
+      Vec3f center((min.x+max.x)/2.0f,(min.y+max.y)/2.0f,(min.z+max.z)/2.0f);
+      Vec3f size(max.x-min.x,max.y-min.y,max.z-min.z);
+      HexGridPartition hgp(center,size,resolution,1.05f,true);
+
+      vector<float> coordSample,normalSample,coordStream,normalStream;
+      bool sampleOk = false,streamOk = false;
+      double tSample = timeMs([&]() {
+          sampleOk = (hasNormal)?
+            (hgp.insertPoints(coord,normal) &&
+             hgp.sample(coordSample,normalSample,nullptr,nThreads)):
+            (hgp.insertPoints(coord) &&
+             hgp.sample(coordSample,nullptr,nThreads));
+        });
+      int nInside = 0,nStreamCells = 0;
+      double tStream = timeMs([&]() {
+          hgp.beginStream();
+          for(int iP=0;iP<nPoints;iP+=chunkSize) {
+            const int n = (nPoints-iP<chunkSize)?nPoints-iP:chunkSize;
+            nInside += hgp.insertStreamPoints
+              (coord.data()+3*static_cast<size_t>(iP),
+               (hasNormal)?normal.data()+3*static_cast<size_t>(iP):nullptr,n);
+          }
+          nStreamCells = hgp.getNumberOfStreamCells();
+          streamOk =
+            hgp.endStream(coordStream,(hasNormal)?&normalStream:nullptr);
+        });
+
+      const int nCells = hgp.getNumberOfCells();
+      int nInsideCells = 0;
+      for(int i=0;i<nCells;i++) nInsideCells += hgp.getCellNumberOfPoints(i);
+      sampleOk = sampleOk && samplesInCells(hgp,coordSample);
+      streamOk = streamOk && nStreamCells==nCells && nInside==nInsideCells &&
+        normalStream.size()==normalSample.size() &&
+        samplesInCells(hgp,coordStream);
+      int nEqual = 0;
+      if(coordStream.size()==coordSample.size())
+        for(int i=0;i<nCells;i++)
+          if(coordStream[3*i  ]==coordSample[3*i  ] &&
+             coordStream[3*i+1]==coordSample[3*i+1] &&
+             coordStream[3*i+2]==coordSample[3*i+2]) nEqual++;
+
+      IfsReport report(iIfs,indent);
+      report.value("nPoints",nPoints);
+      report.value("nCells",nCells);
+      report.value("equal samples",nEqual);
+      report.value("sample ms",tSample);
+      report.value("stream ms",tStream);
+      report.check(sampleOk,"in-memory samples");
+      report.check(streamOk,"streaming samples");
+    });
+  cout << indent << "} benchmarkStream" << endl;
+}
+
 //////////////////////////////////////////////////////////////////////
 int main(int argc, char **argv) {
 
@@ -146,6 +758,34 @@ int main(int argc, char **argv) {
       // - add code to parse the desired operation to be performed
       // - from the command line
 
+    } else if(string(argv[i])=="-ro" || string(argv[i])=="-reorder") {
+      D._reorder = !D._reorder;
+    } else if(string(argv[i])=="-be" || string(argv[i])=="-benchmarkEdges") {
+      D._benchmarkEdges = !D._benchmarkEdges;
+    } else if(string(argv[i])=="-bcc" || string(argv[i])=="-benchmarkCC") {
+      D._benchmarkCC = !D._benchmarkCC;
+    } else if(string(argv[i])=="-bu" || string(argv[i])=="-benchmarkUpdate") {
+      D._benchmarkUpdate = !D._benchmarkUpdate;
+    } else if(string(argv[i])=="-bca" || string(argv[i])=="-benchmarkCache") {
+      D._benchmarkCache = !D._benchmarkCache;
+    } else if(string(argv[i])=="-bi64" || string(argv[i])=="-benchmarkIndex64") {
+      D._benchmarkIndex64 = !D._benchmarkIndex64;
+    } else if(string(argv[i])=="-bs" || string(argv[i])=="-benchmarkStream") {
+      if(++i>=argc) error("missing grid resolution");
+      D._benchmarkStream = atoi(argv[i]);
+    } else if(string(argv[i])=="-t" || string(argv[i])=="-threads") {
+      if(++i>=argc) error("missing number of threads");
+      D._nThreads = atoi(argv[i]);
+      if(D._nThreads<=0) D._nThreads = Parallel::getHardwareConcurrency();
+    } else if(string(argv[i])=="-w" || string(argv[i])=="-weldStl") {
+      D._weldStl = !D._weldStl;
+    } else if(string(argv[i])=="-we" || string(argv[i])=="-weldEpsilon") {
+      if(++i>=argc) error("missing weld epsilon");
+      D._weldEpsilon = static_cast<float>(atof(argv[i]));
+      D._weldStl = true;
+    } else if(string(argv[i])=="-c" || string(argv[i])=="-cacheDir") {
+      if(++i>=argc) error("missing cache directory");
+      D._cacheDir = string(argv[i]);
     } else if(string(argv[i])=="-ccp" || string(argv[i])=="-ccPrimal") {
       D._operation = Operation::COMPUTE_CC_PRIMAL;
 
@@ -175,6 +815,10 @@ int main(int argc, char **argv) {
   }
 
   bool success;
+
+  // number of threads used to build the PolygonMesh topology
+  Parallel::setDefaultNumberOfThreads(D._nThreads);
+  PolygonMesh::setCacheDirectory(D._cacheDir);
 
   //////////////////////////////////////////////////////////////////////
   // create loader and saver factories
@@ -186,8 +830,12 @@ int main(int argc, char **argv) {
   loaderFactory.registerLoader(plyLoader);
   LoaderStl* stlLoader = new LoaderStl();
   loaderFactory.registerLoader(stlLoader);
+  LoaderStl::setWeldVertices(D._weldStl);
+  LoaderStl::setWeldEpsilon(D._weldEpsilon);
   LoaderWrl* wrlLoader = new LoaderWrl();
   loaderFactory.registerLoader(wrlLoader);
+  LoaderDgp* dgpLoader = new LoaderDgp();
+  loaderFactory.registerLoader(dgpLoader);
 
   //  If SaverPly::setDefaultDataType is used, it must be called
   //  before the Saver constructor; otherwise SaverPly::setDataType
@@ -202,6 +850,8 @@ int main(int argc, char **argv) {
   saverFactory.registerSaver(stlSaver);
   SaverWrl* wrlSaver = new SaverWrl();
   saverFactory.registerSaver(wrlSaver);
+  SaverDgp* dgpSaver = new SaverDgp();
+  saverFactory.registerSaver(dgpSaver);
 
   SaverStl::FileType stlFt =
     (D._binaryOutput)?SaverStl::FileType::BINARY:SaverStl::FileType::ASCII;
@@ -257,6 +907,44 @@ int main(int argc, char **argv) {
     if(D._debug) cout << endl;
   }
 
+  if(D._reorder) {
+    if(D._debug) cout << "  reordering faces and vertices {" << endl;
+    SceneGraphProcessor sgp(wrl);
+    sgp.reorderMesh();
+    if(D._debug) cout << "  } reordering faces and vertices" << endl;
+    if(D._debug) cout << endl;
+  }
+
+  if(D._benchmarkEdges) {
+    benchmarkEdges(wrl,"  ");
+    cout << endl;
+  }
+
+  if(D._benchmarkCC) {
+    benchmarkConnectedComponents(wrl,D._nThreads,"  ");
+    cout << endl;
+  }
+
+  if(D._benchmarkUpdate) {
+    benchmarkUpdate(wrl,D._nThreads,"  ");
+    cout << endl;
+  }
+
+  if(D._benchmarkCache) {
+    benchmarkCache(wrl,D._nThreads,"  ");
+    cout << endl;
+  }
+
+  if(D._benchmarkIndex64) {
+    benchmarkIndex64(wrl,D._nThreads,"  ");
+    cout << endl;
+  }
+
+  if(D._benchmarkStream>0) {
+    benchmarkStream(wrl,D._benchmarkStream,D._nThreads,"  ");
+    cout << endl;
+  }
+
   // print PolygonMesh info before processing
   if(D._debug) {
     cout << "  before processing" << endl;
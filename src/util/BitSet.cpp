@@ -0,0 +1,142 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// BitSet.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include "BitSet.hpp"
+#include "Parallel.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+BitSet::BitSet(const size_t n):
+  _size(0),
+  _word() {
+  resize(n);
+}
+
+size_t BitSet::size() const {
+  return _size;
+}
+
+void BitSet::resize(const size_t n) {
+  _size = n;
+  _word.assign((n+63)>>6,0);
+}
+
+void BitSet::set(const size_t i) {
+  _word[i>>6] |= (static_cast<uint64_t>(1)<<(i&63));
+}
+
+void BitSet::reset(const size_t i) {
+  _word[i>>6] &= ~(static_cast<uint64_t>(1)<<(i&63));
+}
+
+size_t BitSet::getNumberOfWords() const {
+  return _word.size();
+}
+
+uint64_t BitSet::getWord(const size_t iW) const {
+  return _word[iW];
+}
+
+void BitSet::setWord(const size_t iW, const uint64_t word) {
+  const size_t nLast = _size&63;
+  _word[iW] = (iW+1==_word.size() && nLast>0)?
+    (word&((static_cast<uint64_t>(1)<<nLast)-1)):word;
+}
+
+size_t BitSet::count(const int nThreads) const {
+  const size_t nW = _word.size();
+  const int nT = Parallel::getNumberOfThreads(nThreads,nW,1<<14);
+  vector<size_t> rangeCount(nT,0);
+  Parallel::forEachRange(nT,nW,[&](int iT, size_t i0, size_t i1) {
+      size_t n = 0;
+      for(size_t iW=i0;iW<i1;iW++)
+        n += static_cast<size_t>(popcount(_word[iW]));
+      rangeCount[iT] = n;
+    });
+  size_t n = 0;
+  for(int iT=0;iT<nT;iT++) n += rangeCount[iT];
+  return n;
+}
+
+void BitSet::getIndices(vector<int>& index) const {
+  index.clear();
+  const size_t nW = _word.size();
+  for(size_t iW=0;iW<nW;iW++)
+    for(uint64_t w=_word[iW];w!=0;w&=w-1)
+      index.push_back(static_cast<int>((iW<<6)+countTrailingZeros(w)));
+}
+
+void BitSet::getIndices(vector<int64_t>& index) const {
+  index.clear();
+  const size_t nW = _word.size();
+  for(size_t iW=0;iW<nW;iW++)
+    for(uint64_t w=_word[iW];w!=0;w&=w-1)
+      index.push_back(static_cast<int64_t>((iW<<6)+countTrailingZeros(w)));
+}
+
+int BitSet::popcount(const uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  return static_cast<int>(__popcnt64(word));
+#else
+  uint64_t w = word-((word>>1)&0x5555555555555555ULL);
+  w = (w&0x3333333333333333ULL)+((w>>2)&0x3333333333333333ULL);
+  w = (w+(w>>4))&0x0F0F0F0F0F0F0F0FULL;
+  return static_cast<int>((w*0x0101010101010101ULL)>>56);
+#endif
+}
+
+int BitSet::countTrailingZeros(const uint64_t word) {
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  unsigned long i;
+  _BitScanForward64(&i,word);
+  return static_cast<int>(i);
+#else
+  int i = 0;
+  while(((word>>i)&1)==0) i++;
+  return i;
+#endif
+}
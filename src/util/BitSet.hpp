@@ -0,0 +1,101 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// BitSet.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef _BITSET_HPP_
+#define _BITSET_HPP_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+using namespace std;
+
+// array of bits packed into 64-bit words; bit i is bit (i&63) of word
+// (i>>6), and the unused bits of the last word are always 0, so that
+// whole words can be counted and scanned
+//
+// the bits can be filled by multiple threads with setWord(), as long
+// as each thread writes its own range of words
+
+class BitSet {
+
+public:
+
+           BitSet(const size_t n=0);
+
+  // number of bits; resize() clears all the bits
+
+  size_t   size() const;
+  void     resize(const size_t n);
+
+  // single bits; there are no range checks
+
+  bool     test(const size_t i) const {
+    return ((_word[i>>6]>>(i&63))&1)!=0;
+  }
+  void     set(const size_t i);
+  void     reset(const size_t i);
+
+  // whole words; the bits beyond size() are cleared by setWord()
+
+  size_t   getNumberOfWords() const;
+  uint64_t getWord(const size_t iW) const;
+  void     setWord(const size_t iW, const uint64_t word);
+
+  // number of bits set to 1
+  size_t   count(const int nThreads=0) const;
+
+  // fills the array with the indices of the bits set to 1, in
+  // increasing order
+  void     getIndices(vector<int>& index) const;
+  void     getIndices(vector<int64_t>& index) const;
+
+  static int popcount(const uint64_t word);
+  static int countTrailingZeros(const uint64_t word); // word!=0
+
+private:
+
+  size_t           _size;
+  vector<uint64_t> _word;
+
+};
+
+#endif /* _BITSET_HPP_ */
@@ -0,0 +1,298 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// DgpFile.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <cstdio>
+#include <cstring>
+#include "DgpFile.hpp"
+
+#include "Endian.hpp"
+#include "Parallel.hpp"
+
+static const char     dgpMagic[8]   = { 'D','G','P','2','0','2','5','\0' };
+static const uint32_t dgpVersion    = 1;
+static const uint32_t dgpByteOrder  = 0x01020304;
+static const uint32_t dgpByteSwap   = 0x04030201;
+static const size_t   dgpHeaderSize = 64;
+static const size_t   dgpEntrySize  = 40;
+static const size_t   dgpAlignment  = 64;
+
+static size_t alignOffset(const size_t offset) {
+  return (offset+dgpAlignment-1)/dgpAlignment*dgpAlignment;
+}
+
+// number of bytes of each value of a section
+static size_t typeSize(const DgpFile::Type type) {
+  return (type==DgpFile::CHAR8)?1:(type==DgpFile::INT64)?8:4;
+}
+
+static uint32_t readUInt32(const char* src, const bool swapBytes) {
+  uint32_t value;
+  memcpy(&value,src,4);
+  if(swapBytes) Endian::swapArray(&value,1,4);
+  return value;
+}
+
+static uint64_t readUInt64(const char* src, const bool swapBytes) {
+  uint64_t value;
+  memcpy(&value,src,8);
+  if(swapBytes) Endian::swapArray(&value,1,8);
+  return value;
+}
+
+DgpFile::DgpFile():
+  _sections(),
+  _file(),
+  _swapBytes(false) {
+}
+
+DgpFile::~DgpFile() {
+  close();
+}
+
+void DgpFile::_addSection
+(const char* tag, const Type type, const size_t count, const void* data) {
+  Section section;
+  section.tag    = string(tag).substr(0,maxTagLength);
+  section.type   = type;
+  section.count  = count;
+  section.offset = 0;
+  section.data   = data;
+  _sections.push_back(section);
+}
+
+void DgpFile::addSection(const char* tag, const vector<int>& values) {
+  _addSection(tag,INT32,values.size(),values.data());
+}
+
+void DgpFile::addSection(const char* tag, const vector<int64_t>& values) {
+  _addSection(tag,INT64,values.size(),values.data());
+}
+
+void DgpFile::addSection(const char* tag, const vector<float>& values) {
+  _addSection(tag,FLOAT32,values.size(),values.data());
+}
+
+void DgpFile::addSection(const char* tag, const string& value) {
+  _addSection(tag,CHAR8,value.size(),value.data());
+}
+
+bool DgpFile::save(const char* filename) const {
+  if(filename==(const char*)0) return false;
+  FILE* fp = fopen(filename,"wb");
+  if(fp==(FILE*)0) return false;
+
+  const uint32_t nSections = static_cast<uint32_t>(_sections.size());
+
+  // header and section table are assembled in memory
+  size_t offset = alignOffset(dgpHeaderSize+nSections*dgpEntrySize);
+  vector<char> head(offset,0);
+  memcpy(&head[0],dgpMagic,8);
+  memcpy(&head[ 8],&dgpVersion  ,4);
+  memcpy(&head[12],&dgpByteOrder,4);
+  memcpy(&head[16],&nSections   ,4);
+  vector<uint64_t> sectionOffset(nSections);
+  for(uint32_t iS=0;iS<nSections;iS++) {
+    const Section& section = _sections[iS];
+    char* entry = &head[dgpHeaderSize+iS*dgpEntrySize];
+    const uint32_t type   = static_cast<uint32_t>(section.type);
+    const uint64_t count  = static_cast<uint64_t>(section.count);
+    memcpy(entry,section.tag.c_str(),section.tag.size());
+    memcpy(entry+16,&type  ,4);
+    memcpy(entry+24,&count ,8);
+    memcpy(entry+32,&offset,8);
+    sectionOffset[iS] = offset;
+    offset = alignOffset(offset+typeSize(section.type)*section.count);
+  }
+
+  // the section data is written directly from the arrays
+  bool success = (fwrite(head.data(),1,head.size(),fp)==head.size());
+  size_t position = head.size();
+  const char padding[dgpAlignment] = { 0 };
+  for(uint32_t iS=0;success && iS<nSections;iS++) {
+    const Section& section = _sections[iS];
+    const size_t nPad = static_cast<size_t>(sectionOffset[iS])-position;
+    if(nPad>0 && fwrite(padding,1,nPad,fp)!=nPad) success = false;
+    const size_t nBytes = typeSize(section.type)*section.count;
+    if(nBytes>0 && fwrite(section.data,1,nBytes,fp)!=nBytes) success = false;
+    position = static_cast<size_t>(sectionOffset[iS])+nBytes;
+  }
+
+  if(fclose(fp)!=0) success = false;
+  return success;
+}
+
+bool DgpFile::open(const char* filename) {
+  close();
+  if(_file.open(filename)==false) return false;
+  if(_readSectionTable()==false) {
+    close();
+    return false;
+  }
+  return true;
+}
+
+bool DgpFile::_readSectionTable() {
+  const char*  data = _file.getData();
+  const size_t size = _file.getSize();
+  if(size<dgpHeaderSize || memcmp(data,dgpMagic,8)!=0) return false;
+  const uint32_t byteOrder = readUInt32(data+12,false);
+  if(byteOrder!=dgpByteOrder && byteOrder!=dgpByteSwap) return false;
+  _swapBytes = (byteOrder==dgpByteSwap);
+  if(readUInt32(data+8,_swapBytes)!=dgpVersion) return false;
+  const size_t nSections = readUInt32(data+16,_swapBytes);
+  if(size<dgpHeaderSize+nSections*dgpEntrySize) return false;
+  for(size_t iS=0;iS<nSections;iS++) {
+    const char* entry = data+dgpHeaderSize+iS*dgpEntrySize;
+    Section section;
+    section.tag    = string(entry,strnlen(entry,16));
+    section.type   = static_cast<Type>(readUInt32(entry+16,_swapBytes));
+    section.count  = static_cast<size_t>(readUInt64(entry+24,_swapBytes));
+    section.offset = static_cast<size_t>(readUInt64(entry+32,_swapBytes));
+    section.data   = (const void*)0;
+    if(section.type!=INT32 && section.type!=FLOAT32 &&
+       section.type!=CHAR8 && section.type!=INT64) return false;
+    // the section data should be aligned and fit within the file
+    if(section.offset%dgpAlignment!=0 || section.offset>size ||
+       section.count>(size-section.offset)/typeSize(section.type))
+      return false;
+    _sections.push_back(section);
+  }
+  return true;
+}
+
+void DgpFile::close() {
+  _file.close();
+  _sections.clear();
+  _swapBytes = false;
+}
+
+int DgpFile::getNumberOfSections() const {
+  return static_cast<int>(_sections.size());
+}
+
+bool DgpFile::hasSection(const char* tag) const {
+  for(const Section& section : _sections)
+    if(section.tag==tag) return true;
+  return false;
+}
+
+size_t DgpFile::getSectionCount(const char* tag) const {
+  for(const Section& section : _sections)
+    if(section.tag==tag) return section.count;
+  return 0;
+}
+
+size_t DgpFile::getSectionOffset(const char* tag) const {
+  for(const Section& section : _sections)
+    if(section.tag==tag) return section.offset;
+  return 0;
+}
+
+const DgpFile::Section* DgpFile::_findSection
+(const char* tag, const Type type) const {
+  if(_file.isOpen()==false) return (const Section*)0;
+  for(const Section& section : _sections)
+    if(section.tag==tag)
+      return (section.type==type)?&section:(const Section*)0;
+  return (const Section*)0;
+}
+
+// the pages of the mapping are faulted in by several threads, which
+// copy disjoint ranges of the section
+bool DgpFile::_copySection(const Section* section, void* dst) const {
+  if(section==(const Section*)0) return false;
+  const char* src = _file.getData()+section->offset;
+  char*       out = static_cast<char*>(dst);
+  const size_t n  = section->count;
+  const size_t w  = typeSize(section->type);
+  const bool swapBytes = _swapBytes;
+  const int nT = Parallel::getNumberOfThreads(0,n,1<<20);
+  Parallel::forEachRange(nT,n,[&](int, size_t i0, size_t i1) {
+      if(i1<=i0) return;
+      memcpy(out+w*i0,src+w*i0,w*(i1-i0));
+      if(swapBytes) Endian::swapArray(out+w*i0,i1-i0,static_cast<int>(w));
+    });
+  return true;
+}
+
+bool DgpFile::getSection(const char* tag, vector<int>& values) const {
+  const Section* section = _findSection(tag,INT32);
+  if(section==(const Section*)0) return false;
+  values.resize(section->count);
+  return _copySection(section,values.data());
+}
+
+bool DgpFile::getSection(const char* tag, vector<int64_t>& values) const {
+  const Section* section = _findSection(tag,INT64);
+  if(section==(const Section*)0) return false;
+  values.resize(section->count);
+  return _copySection(section,values.data());
+}
+
+bool DgpFile::getSection(const char* tag, vector<float>& values) const {
+  const Section* section = _findSection(tag,FLOAT32);
+  if(section==(const Section*)0) return false;
+  values.resize(section->count);
+  return _copySection(section,values.data());
+}
+
+bool DgpFile::getSection(const char* tag, string& value) const {
+  const Section* section = _findSection(tag,CHAR8);
+  if(section==(const Section*)0) return false;
+  value.assign(_file.getData()+section->offset,section->count);
+  return true;
+}
+
+const int* DgpFile::getIntData(const char* tag, size_t& count) const {
+  count = 0;
+  const Section* section = _findSection(tag,INT32);
+  if(section==(const Section*)0 || _swapBytes) return (const int*)0;
+  count = section->count;
+  return reinterpret_cast<const int*>(_file.getData()+section->offset);
+}
+
+const float* DgpFile::getFloatData(const char* tag, size_t& count) const {
+  count = 0;
+  const Section* section = _findSection(tag,FLOAT32);
+  if(section==(const Section*)0 || _swapBytes) return (const float*)0;
+  count = section->count;
+  return reinterpret_cast<const float*>(_file.getData()+section->offset);
+}
@@ -0,0 +1,171 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// DgpFile.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef DGP_FILE_HPP
+#define DGP_FILE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "MappedFile.hpp"
+
+using namespace std;
+
+// Binary container used by the native mesh format, and by any other
+// file which needs to store large arrays of int, int64_t or float
+// values, and possibly a few short strings.
+//
+// The file starts with a 64 bytes header
+//
+//   char     magic[8];    // "DGP2025\0"
+//   uint32_t version;     // 1
+//   uint32_t byteOrder;   // 0x01020304, as written by the saving system
+//   uint32_t nSections;
+//   char     padding[44];
+//
+// followed by a table of nSections entries of 40 bytes each
+//
+//   char     tag[16];     // zero padded section name
+//   uint32_t type;        // DgpFile::Type
+//   uint32_t reserved;
+//   uint64_t count;       // number of values
+//   uint64_t offset;      // from the beginning of the file
+//
+// and by the section data, each one starting at an offset which is a
+// multiple of 64 bytes; the count of a CHAR8 section is its number
+// of bytes, without a terminating zero; all the values are written
+// in the byte order of the saving system.
+//
+// The file is memory mapped for reading; if the byte order of the
+// file matches the byte order of the system, the section data can be
+// accessed in place, without copying it.
+
+class DgpFile {
+
+public:
+
+  enum Type {
+    INT32   = 1,
+    FLOAT32 = 2,
+    CHAR8   = 3,
+    INT64   = 4
+  };
+
+  static const size_t maxTagLength = 15;
+
+public:
+
+  DgpFile();
+  ~DgpFile();
+
+  // writing : the sections are recorded by reference, and written by
+  // save(); the arrays must not be modified before save() returns
+
+  void        addSection(const char* tag, const vector<int>&     values);
+  void        addSection(const char* tag, const vector<int64_t>& values);
+  void        addSection(const char* tag, const vector<float>&   values);
+  void        addSection(const char* tag, const string&          value);
+
+  // returns false if the file cannot be written
+  bool        save(const char* filename) const;
+
+  // reading : returns false if the file cannot be opened, or if its
+  // header or section table are not valid; any previously opened
+  // file is closed first
+
+  bool        open(const char* filename);
+  void        close();
+  bool        isOpen() const { return _file.isOpen(); }
+
+  int         getNumberOfSections() const;
+  bool        hasSection(const char* tag) const;
+
+  // returns the number of values of the section, or 0 if the file
+  // does not have a section with the given tag
+  size_t      getSectionCount(const char* tag) const;
+
+  // returns the offset of the section values from the beginning of
+  // the file, or 0 if the file does not have a section with the given
+  // tag; meant for tools which modify a file in place
+  size_t      getSectionOffset(const char* tag) const;
+
+  // copies the values of the section onto the array; returns false if
+  // the section is not found, or if it has a different type
+  bool        getSection(const char* tag, vector<int>&     values) const;
+  bool        getSection(const char* tag, vector<int64_t>& values) const;
+  bool        getSection(const char* tag, vector<float>&   values) const;
+  bool        getSection(const char* tag, string&          value) const;
+
+  // returns a pointer to the section values in the mapped file, and
+  // the number of values in count, or a null pointer if the section
+  // is not found, if it has a different type, or if the byte order of
+  // the file is not the byte order of the system
+  const int*   getIntData(const char* tag, size_t& count) const;
+  const float* getFloatData(const char* tag, size_t& count) const;
+
+private:
+
+  struct Section {
+    string      tag;
+    Type        type;
+    size_t      count;
+    size_t      offset; // only used for reading
+    const void* data;   // only used for writing
+  };
+
+  // copies are not allowed
+  DgpFile(const DgpFile&);
+  DgpFile& operator=(const DgpFile&);
+
+  void           _addSection(const char* tag, const Type type,
+                             const size_t count, const void* data);
+  bool           _readSectionTable();
+  const Section* _findSection(const char* tag, const Type type) const;
+  bool           _copySection(const Section* section, void* dst) const;
+
+  vector<Section> _sections;
+  MappedFile      _file;
+  bool            _swapBytes;
+
+};
+
+#endif // DGP_FILE_HPP
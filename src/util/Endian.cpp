@@ -39,6 +39,8 @@
 // USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
 // DAMAGE.
 
+#include <cstdint>
+#include <cstring>
 #include "Endian.hpp"
 
 bool Endian::toBool(const char b[/*1*/]) {
@@ -87,6 +89,42 @@ Endian::SingleValueBuffer& Endian::swap8
   return buff;
 }
 
+// the shift and mask expressions are recognized by the compiler as
+// byte swaps, and the loops are vectorized
+void Endian::swapArray
+(void* data, const size_t nValues, const int nBytesValue) {
+  uchar* b = static_cast<uchar*>(data);
+  size_t i;
+  switch(nBytesValue) {
+  case 2:
+    for(i=0;i<nValues;i++) {
+      uint16_t v; memcpy(&v,b+2*i,2);
+      v = static_cast<uint16_t>((v>>8)|(v<<8));
+      memcpy(b+2*i,&v,2);
+    }
+    break;
+  case 4:
+    for(i=0;i<nValues;i++) {
+      uint32_t v; memcpy(&v,b+4*i,4);
+      v = ((v>>24)&0x000000ffu)|((v>> 8)&0x0000ff00u)|
+          ((v<< 8)&0x00ff0000u)|((v<<24)&0xff000000u);
+      memcpy(b+4*i,&v,4);
+    }
+    break;
+  case 8:
+    for(i=0;i<nValues;i++) {
+      uint64_t v; memcpy(&v,b+8*i,8);
+      v = ((v>>56)&0x00000000000000ffull)|((v>>40)&0x000000000000ff00ull)|
+          ((v>>24)&0x0000000000ff0000ull)|((v>> 8)&0x00000000ff000000ull)|
+          ((v<< 8)&0x000000ff00000000ull)|((v<<24)&0x0000ff0000000000ull)|
+          ((v<<40)&0x00ff000000000000ull)|((v<<56)&0xff00000000000000ull);
+      memcpy(b+8*i,&v,8);
+    }
+    break;
+  default:
+    break;
+  }
+}
 
 //////////////////////////////////////////////////////////////////////
 // static
@@ -42,6 +42,8 @@
 #ifndef ENDIAN_HPP
 #define ENDIAN_HPP
 
+#include <cstddef>
+
 typedef unsigned char  uchar;
 typedef unsigned short ushort;
 typedef unsigned int   uint;
@@ -85,6 +87,10 @@ namespace Endian {
 #define swapLong   swap8
 #define swapDouble swap8
 
+  // reverses in place the byte order of each one of the nValues
+  // values of size nBytesValue (2, 4, or 8) stored in data
+  void swapArray(void* data, const size_t nValues, const int nBytesValue);
+
   bool isLittleEndianSystem();
 
 };
@@ -0,0 +1,168 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// MappedFile.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <cstdio>
+#include "MappedFile.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+MappedFile::MappedFile():
+  _data(nullptr),
+  _size(0),
+  _open(false),
+  _mapped(false),
+  _buffer()
+#ifdef _WIN32
+  ,_hFile(nullptr)
+  ,_hMapping(nullptr)
+#endif
+{
+}
+
+MappedFile::~MappedFile() {
+  close();
+}
+
+bool MappedFile::open(const char* filename) {
+  close();
+  if(filename==nullptr) return false;
+
+#ifdef _WIN32
+  HANDLE hFile = CreateFileA(filename,GENERIC_READ,FILE_SHARE_READ,nullptr,
+                             OPEN_EXISTING,FILE_ATTRIBUTE_NORMAL,nullptr);
+  if(hFile!=INVALID_HANDLE_VALUE) {
+    LARGE_INTEGER size;
+    HANDLE hMapping = nullptr;
+    void*  data     = nullptr;
+    if(GetFileSizeEx(hFile,&size) && size.QuadPart==0) {
+      CloseHandle(hFile);
+      _open = true;
+      return true;
+    } else if(GetFileSizeEx(hFile,&size)) {
+      hMapping = CreateFileMappingA(hFile,nullptr,PAGE_READONLY,0,0,nullptr);
+      if(hMapping!=nullptr)
+        data = MapViewOfFile(hMapping,FILE_MAP_READ,0,0,0);
+    }
+    if(data!=nullptr) {
+      _hFile    = hFile;
+      _hMapping = hMapping;
+      _data     = static_cast<const char*>(data);
+      _size     = static_cast<size_t>(size.QuadPart);
+      _open     = true;
+      _mapped   = true;
+      return true;
+    }
+    if(hMapping!=nullptr) CloseHandle(hMapping);
+    CloseHandle(hFile);
+  }
+#else
+  int fd = ::open(filename,O_RDONLY);
+  if(fd>=0) {
+    struct stat st;
+    if(fstat(fd,&st)==0 && S_ISREG(st.st_mode)) {
+      if(st.st_size==0) {
+        ::close(fd);
+        _open = true;
+        return true;
+      }
+      void* data = mmap(nullptr,static_cast<size_t>(st.st_size),
+                        PROT_READ,MAP_PRIVATE,fd,0);
+      // the mapping remains valid after the file is closed
+      ::close(fd);
+      if(data!=MAP_FAILED) {
+        // the file is decoded sequentially
+        madvise(data,static_cast<size_t>(st.st_size),MADV_SEQUENTIAL);
+        _data   = static_cast<const char*>(data);
+        _size   = static_cast<size_t>(st.st_size);
+        _open   = true;
+        _mapped = true;
+        return true;
+      }
+    } else {
+      ::close(fd);
+    }
+  }
+#endif
+
+  // fall back on reading the whole file into memory
+  FILE* fp = fopen(filename,"rb");
+  if(fp==nullptr) return false;
+  char   chunk[1<<16];
+  size_t n;
+  while((n=fread(chunk,1,sizeof(chunk),fp))>0)
+    _buffer.insert(_buffer.end(),chunk,chunk+n);
+  bool success = (ferror(fp)==0);
+  fclose(fp);
+  if(success==false) {
+    vector<char>().swap(_buffer);
+    return false;
+  }
+  _data = (_buffer.size()>0)?_buffer.data():nullptr;
+  _size = _buffer.size();
+  _open = true;
+  return true;
+}
+
+void MappedFile::close() {
+  if(_mapped) {
+#ifdef _WIN32
+    UnmapViewOfFile(static_cast<LPCVOID>(_data));
+    CloseHandle(static_cast<HANDLE>(_hMapping));
+    CloseHandle(static_cast<HANDLE>(_hFile));
+    _hFile    = nullptr;
+    _hMapping = nullptr;
+#else
+    munmap(const_cast<char*>(_data),_size);
+#endif
+  }
+  vector<char>().swap(_buffer);
+  _data   = nullptr;
+  _size   = 0;
+  _open   = false;
+  _mapped = false;
+}
@@ -0,0 +1,113 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// Parallel.cpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#include <exception>
+#include <thread>
+#include "Parallel.hpp"
+
+static int _defaultNumberOfThreads = 1;
+
+int Parallel::getDefaultNumberOfThreads() {
+  return _defaultNumberOfThreads;
+}
+
+void Parallel::setDefaultNumberOfThreads(const int nThreads) {
+  _defaultNumberOfThreads = (nThreads>0)?nThreads:1;
+}
+
+int Parallel::getHardwareConcurrency() {
+  unsigned n = std::thread::hardware_concurrency();
+  return (n>0)?static_cast<int>(n):1;
+}
+
+int Parallel::getNumberOfThreads
+(const int nThreads, const size_t n, const size_t minRangeSize) {
+  int nT = (nThreads>0)?nThreads:_defaultNumberOfThreads;
+  size_t nMax = (minRangeSize>0)?n/minRangeSize:n;
+  if(static_cast<size_t>(nT)>nMax) nT = static_cast<int>(nMax);
+  return (nT>0)?nT:1;
+}
+
+size_t Parallel::rangeBegin
+(const int nThreads, const size_t n, const int iThread) {
+  return (n/nThreads)*iThread+((static_cast<size_t>(iThread)<n%nThreads)?
+                               iThread:n%nThreads);
+}
+
+size_t Parallel::rangeEnd
+(const int nThreads, const size_t n, const int iThread) {
+  return rangeBegin(nThreads,n,iThread+1);
+}
+
+void Parallel::forEachRange
+(const int nThreads, const size_t n,
+ const function<void(int,size_t,size_t)>& f) {
+  if(nThreads<=1) {
+    f(0,0,n);
+    return;
+  }
+  // an exception thrown by f is caught within its own range, so that
+  // every thread is joined before the first one is rethrown
+  vector<exception_ptr> error(nThreads);
+  auto run = [&](const int iThread) {
+    try {
+      f(iThread,rangeBegin(nThreads,n,iThread),rangeEnd(nThreads,n,iThread));
+    } catch(...) {
+      error[iThread] = current_exception();
+    }
+  };
+  vector<std::thread> worker;
+  worker.reserve(nThreads-1);
+  for(int iThread=1;iThread<nThreads;iThread++) {
+    try {
+      worker.emplace_back(run,iThread);
+    } catch(...) {
+      // the range is processed by the calling thread if a new thread
+      // cannot be created
+      run(iThread);
+    }
+  }
+  // the calling thread processes the first range
+  run(0);
+  for(auto& w : worker) w.join();
+  for(const exception_ptr& e : error)
+    if(e) rethrow_exception(e);
+}
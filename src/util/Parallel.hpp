@@ -0,0 +1,121 @@
+//------------------------------------------------------------------------
+//  Copyright (C) Gabriel Taubin
+//  Time-stamp: <2025-10-17 10:12:31 taubin>
+//------------------------------------------------------------------------
+//
+// Parallel.hpp
+//
+// Software developed for the course
+// Digital Geometry Processing
+// Copyright (c) 2025, Gabriel Taubin
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without
+// modification, are permitted provided that the following conditions
+// are met:
+//
+//     * Redistributions of source code must retain the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer.
+//     * Redistributions in binary form must reproduce the above
+//       copyright notice, this list of conditions and the following
+//       disclaimer in the documentation and/or other materials
+//       provided with the distribution.
+//     * Neither the name of the Brown University nor the names of its
+//       contributors may be used to endorse or promote products
+//       derived from this software without specific prior written
+//       permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+// FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL GABRIEL
+// TAUBIN BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+// OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+// (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE
+// USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH
+// DAMAGE.
+
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <cstddef>
+#include <vector>
+#include <functional>
+
+using namespace std;
+
+// minimal support for the data parallel algorithms; work is split into
+// contiguous ranges, one per thread, and each range is processed on
+// its own std::thread; with a single thread the work is done on the
+// calling thread
+
+namespace Parallel {
+
+  // number of threads used when an algorithm is called with
+  // nThreads<=0; the initial value is 1, so that all the algorithms
+  // run serially unless requested otherwise
+  int  getDefaultNumberOfThreads();
+  void setDefaultNumberOfThreads(const int nThreads);
+
+  // number of concurrent threads supported by the hardware, or 1 if
+  // it cannot be determined
+  int  getHardwareConcurrency();
+
+  // returns nThreads if nThreads>0, and the default number of threads
+  // otherwise; the value is also clamped so that each thread gets at
+  // least minRangeSize out of the n work items
+  int  getNumberOfThreads
+  (const int nThreads, const size_t n, const size_t minRangeSize=1);
+
+  // the range [0:n) is split into nThreads contiguous ranges of
+  // almost equal size; these functions return the bounds of range
+  // iThread
+  size_t rangeBegin(const int nThreads, const size_t n, const int iThread);
+  size_t rangeEnd  (const int nThreads, const size_t n, const int iThread);
+
+  // calls f(iThread,begin,end) for each one of the nThreads ranges
+  // [begin:end) of [0:n), and waits for all of them to return;
+  // nThreads should be the value returned by getNumberOfThreads(); if
+  // f throws an exception in one or more ranges, the exception of the
+  // first such range is rethrown after all the ranges are done
+  void forEachRange
+  (const int nThreads, const size_t n,
+   const function<void(int,size_t,size_t)>& f);
+
+  // converts an array of counts into an array of offsets; on input
+  // first[i+1] is the number of elements in bucket i, for 0<=i<n, and
+  // first[0] is ignored; on output first[0]==0 and
+  // first[i+1]==first[i]+count[i]; this is the layout used by all the
+  // arrays of arrays in the core classes
+  template<class T>
+  void prefixSum(vector<T>& first, const int nThreads) {
+    const size_t n = (first.size()>0)?first.size()-1:0;
+    if(n==0) { if(first.size()>0) first[0] = 0; return; }
+    const int nT = getNumberOfThreads(nThreads,n,1<<16);
+    first[0] = 0;
+    if(nT<=1) {
+      for(size_t i=0;i<n;i++) first[i+1] += first[i];
+      return;
+    }
+    // 1) partial sums within each range
+    vector<T> rangeSum(nT+1,0);
+    forEachRange(nT,n,[&](int iT, size_t i0, size_t i1) {
+        for(size_t i=i0+1;i<i1;i++) first[i+1] += first[i];
+        rangeSum[iT+1] = first[i1];
+      });
+    // 2) offset of each range
+    for(int iT=0;iT<nT;iT++) rangeSum[iT+1] += rangeSum[iT];
+    // 3) add the offsets
+    forEachRange(nT,n,[&](int iT, size_t i0, size_t i1) {
+        const T offset = rangeSum[iT];
+        for(size_t i=i0;i<i1;i++) first[i+1] += offset;
+      });
+  }
+
+};
+
+#endif // PARALLEL_HPP
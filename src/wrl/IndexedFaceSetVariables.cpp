@@ -75,6 +75,24 @@ PolygonMesh* IndexedFaceSetVariables::getPolygonMesh(const bool rebuild) {
   return (PolygonMesh*)(var->getValue());
 }
 
+CoordSoA& IndexedFaceSetVariables::getCoordSoA(const bool update) {
+  vector<float>& coord = _ifs.getCoord();
+  Variable* var = _ifs.getVariable("coordSoA");
+  if(var==(Variable*)0) { // not found
+    var = new VariableCoordSoA(coord);
+    _ifs.setVariable(var);
+    return *((CoordSoA*)(var->getValue()));
+  }
+  CoordSoA& coordSoA = *((CoordSoA*)(var->getValue()));
+  if(update || coordSoA.isSynchronized(coord)==false)
+    coordSoA.set(coord);
+  return coordSoA;
+}
+
+void IndexedFaceSetVariables::deleteCoordSoA() {
+  _ifs.eraseVariable("coordSoA");
+}
+
 int IndexedFaceSetVariables::getNumberOfEdges() {
   PolygonMesh* pmesh = getPolygonMesh(true);
   return pmesh->getNumberOfEdges();
@@ -36,6 +36,7 @@
 #define _INDEXED_FACE_SET_UTILS_h_
 
 #include <core/PolygonMesh.hpp>
+#include <core/CoordSoA.hpp>
 #include "Types.hpp"
 #include "Material.hpp"
 #include "IndexedFaceSet.hpp"
@@ -50,6 +51,16 @@ public:
   void            deletePolygonMesh();
   PolygonMesh*    getPolygonMesh(const bool rebuild=false);
 
+  // structure-of-arrays copy of the coordinates, created on the first
+  // call; it is copied again from getCoord() if update==true, or if
+  // the coord array has been resized or reallocated since the last
+  // copy; modifications of the coordinate values in place, and arrays
+  // swapped into the same address, are not detected, so callers
+  // which cannot rule them out, such as the normal computations of
+  // SceneGraphProcessor, should pass update==true
+  CoordSoA&       getCoordSoA(const bool update=false);
+  void            deleteCoordSoA();
+
   int             getNumberOfEdges();
 
   Material**      getMaterial();
@@ -960,6 +960,9 @@ void Ply::Element::Property::pushBackList(const int nList) {
   int index = _first.back()+nList;
   _first.push_back(index);
 }
+void Ply::Element::Property::reserveList(const int nLists) {
+  if(nLists>0) _first.reserve(_first.size()+static_cast<size_t>(nLists));
+}
 int Ply::Element::Property::getListFirst(const int i) {
   if(i<0) return -1;
   uint ui = static_cast<uint>(i);
@@ -111,6 +111,7 @@ public:
       const string     getPropertyTypeName();
       int              getPropertyTypeSize();
       void             pushBackList(const int nList);
+      void             reserveList(const int nLists);
       int              getListFirst(const int i);
       Element&         element();
 
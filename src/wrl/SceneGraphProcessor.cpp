@@ -33,15 +33,21 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include <math.h>
+#include <map>
+#include <cmath>
+#include <cstdint>
 // #include <iostream>
 #include "SceneGraphProcessor.hpp"
 #include "SceneGraphTraversal.hpp"
 #include "Shape.hpp"
 #include "IndexedFaceSet.hpp"
 #include "IndexedLineSet.hpp"
+#include "IndexedFaceSetVariables.hpp"
 #include "Appearance.hpp"
 #include "Material.hpp"
 #include "core/Graph.hpp"
+#include "core/Geometry.hpp"
+#include "util/Parallel.hpp"
 
 const int SceneGraphProcessor::_hexGridEdge[12][2] = {
   {0,4}, {1,5}, {2,6}, {3,7},
@@ -138,6 +144,10 @@ void SceneGraphProcessor::computeNormalPerCorner() {
   _applyToIndexedFaceSet(_computeNormalPerCorner);
 }
 
+void SceneGraphProcessor::reorderMesh() {
+  _applyToIndexedFaceSet(_reorderMesh);
+}
+
 void SceneGraphProcessor::_applyToIndexedFaceSet(IndexedFaceSet::Operator o) {
   SceneGraphTraversal sgt(_wrl);
   Node* node;
@@ -153,6 +163,195 @@ void SceneGraphProcessor::_applyToIndexedFaceSet(IndexedFaceSet::Operator o) {
   }
 }
 
+// spreads the 21 low order bits of x, so that there are two zero bits
+// between consecutive bits; used to interleave three coordinates
+static uint64_t spreadBits21(uint64_t x) {
+  x &= 0x1fffffULL;
+  x = (x|(x<<32))&0x1f00000000ffffULL;
+  x = (x|(x<<16))&0x1f0000ff0000ffULL;
+  x = (x|(x<< 8))&0x100f00f00f00f00fULL;
+  x = (x|(x<< 4))&0x10c30c30c30c30c3ULL;
+  x = (x|(x<< 2))&0x1249249249249249ULL;
+  return x;
+}
+
+// newToOld[iNew] is the old index of the new element iNew; values
+// are dim-dimensional, and elements with negative old indices, or
+// beyond the end of the values array, are left unchanged
+static void permuteValues
+(vector<float>& values, const int dim, const vector<int>& newToOld) {
+  const size_t nOld = values.size()/dim;
+  if(newToOld.size()!=nOld) return;
+  vector<float> valuesOld(values);
+  const int nT = Parallel::getNumberOfThreads(0,nOld,1<<16);
+  Parallel::forEachRange(nT,nOld,[&](int, size_t i0, size_t i1) {
+      for(size_t iNew=i0;iNew<i1;iNew++) {
+        const int iOld = newToOld[iNew];
+        if(iOld<0) continue;
+        for(int k=0;k<dim;k++)
+          values[dim*iNew+k] = valuesOld[dim*static_cast<size_t>(iOld)+k];
+      }
+    });
+}
+
+static void permuteIndices
+(vector<int>& index, const vector<int>& newToOld) {
+  if(index.size()!=newToOld.size()) return;
+  vector<int> indexOld(index);
+  const size_t n = index.size();
+  const int nT = Parallel::getNumberOfThreads(0,n,1<<16);
+  Parallel::forEachRange(nT,n,[&](int, size_t i0, size_t i1) {
+      for(size_t iNew=i0;iNew<i1;iNew++)
+        index[iNew] = (newToOld[iNew]<0)?-1:indexOld[newToOld[iNew]];
+    });
+}
+
+// permutes the values, or the index array, of a property according
+// to its binding
+static void permuteProperty
+(const IndexedFaceSet::Binding binding,
+ vector<float>& values, const int dim, vector<int>& index,
+ const vector<int>& vertexNewToOld,
+ const vector<int>& faceNewToOld,
+ const vector<int>& cornerNewToOld) {
+  switch(binding) {
+  case IndexedFaceSet::PB_PER_VERTEX:
+    permuteValues(values,dim,vertexNewToOld);
+    break;
+  case IndexedFaceSet::PB_PER_FACE:
+    permuteValues(values,dim,faceNewToOld);
+    break;
+  case IndexedFaceSet::PB_PER_FACE_INDEXED:
+    permuteIndices(index,faceNewToOld);
+    break;
+  case IndexedFaceSet::PB_PER_CORNER:
+    permuteIndices(index,cornerNewToOld);
+    break;
+  case IndexedFaceSet::PB_NONE:
+  default:
+    break;
+  }
+}
+
+void SceneGraphProcessor::_reorderMesh(IndexedFaceSet& ifs) {
+  vector<float>& coord      = ifs.getCoord();
+  vector<int>&   coordIndex = ifs.getCoordIndex();
+  const int nV = ifs.getNumberOfCoord();
+  const int nC = static_cast<int>(coordIndex.size());
+  // every face should be terminated by a -1
+  if(nC==0 || coordIndex[nC-1]>=0) return;
+
+  // 1) first corner of each face
+  vector<int> faceFirstCorner;
+  faceFirstCorner.push_back(0);
+  for(int iC=0;iC<nC;iC++)
+    if(coordIndex[iC]<0) faceFirstCorner.push_back(iC+1);
+  const int nF = static_cast<int>(faceFirstCorner.size())-1;
+
+  // 2) Morton code of each face centroid, quantized to 21 bits per
+  //    coordinate within the bounding box of the centroids
+  vector<float> faceCentroid;
+  Geometry::computeFaceCentroids(coord,coordIndex,faceCentroid);
+  float xMin[3] = {  HUGE_VALF, HUGE_VALF, HUGE_VALF };
+  float xMax[3] = { -HUGE_VALF,-HUGE_VALF,-HUGE_VALF };
+  for(int iF=0;iF<nF;iF++)
+    for(int k=0;k<3;k++) {
+      const float x = faceCentroid[3*iF+k];
+      if(std::isfinite(x)==false) continue;
+      if(x<xMin[k]) xMin[k] = x;
+      if(x>xMax[k]) xMax[k] = x;
+    }
+  float scale[3];
+  for(int k=0;k<3;k++)
+    scale[k] = (xMax[k]>xMin[k])?2097151.0f/(xMax[k]-xMin[k]):0.0f;
+  vector<uint64_t> key(nF);
+  const int nT = Parallel::getNumberOfThreads(0,nF,1<<16);
+  Parallel::forEachRange(nT,nF,[&](int, size_t i0, size_t i1) {
+      for(size_t iF=i0;iF<i1;iF++) {
+        uint64_t code = 0;
+        for(int k=0;k<3;k++) {
+          const float x = faceCentroid[3*iF+k];
+          // empty faces have no centroid
+          const uint64_t q = (std::isfinite(x))?
+            static_cast<uint64_t>((x-xMin[k])*scale[k]):0;
+          code |= spreadBits21(q)<<k;
+        }
+        key[iF] = code;
+      }
+    });
+
+  // 3) LSD radix sort of the faces by key, with 16-bit digits; the
+  //    sort is stable, so that faces with the same key keep their
+  //    relative order
+  vector<int> faceNewToOld(nF),faceSorted(nF);
+  for(int iF=0;iF<nF;iF++) faceNewToOld[iF] = iF;
+  vector<int> count(1<<16);
+  for(int shift=0;shift<64;shift+=16) {
+    count.assign(count.size(),0);
+    for(int iF=0;iF<nF;iF++)
+      count[(key[iF]>>shift)&0xffff]++;
+    for(int d=0,sum=0;d<(1<<16);d++) {
+      const int c = count[d]; count[d] = sum; sum += c;
+    }
+    for(int i=0;i<nF;i++) {
+      const int iF = faceNewToOld[i];
+      faceSorted[count[(key[iF]>>shift)&0xffff]++] = iF;
+    }
+    faceNewToOld.swap(faceSorted);
+  }
+
+  // 4) corners in the new face order, and vertices in order of first
+  //    use by the reordered faces; unused vertices go last
+  vector<int> cornerNewToOld(nC);
+  vector<int> vertexOldToNew(nV,-1);
+  vector<int> vertexNewToOld;
+  vertexNewToOld.reserve(nV);
+  for(int iFnew=0,iCnew=0;iFnew<nF;iFnew++) {
+    const int iF = faceNewToOld[iFnew];
+    for(int iC=faceFirstCorner[iF];iC<faceFirstCorner[iF+1];iC++,iCnew++) {
+      const int iV = coordIndex[iC];
+      cornerNewToOld[iCnew] = (iV<0)?-1:iC;
+      if(iV>=0 && iV<nV && vertexOldToNew[iV]<0) {
+        vertexOldToNew[iV] = static_cast<int>(vertexNewToOld.size());
+        vertexNewToOld.push_back(iV);
+      }
+    }
+  }
+  for(int iV=0;iV<nV;iV++)
+    if(vertexOldToNew[iV]<0) {
+      vertexOldToNew[iV] = static_cast<int>(vertexNewToOld.size());
+      vertexNewToOld.push_back(iV);
+    }
+
+  // 5) properties are permuted according to their bindings, before
+  //    coordIndex is modified, since the bindings depend on it
+  permuteProperty(ifs.getNormalBinding(),ifs.getNormal(),3,ifs.getNormalIndex(),
+                  vertexNewToOld,faceNewToOld,cornerNewToOld);
+  permuteProperty(ifs.getColorBinding(),ifs.getColor(),3,ifs.getColorIndex(),
+                  vertexNewToOld,faceNewToOld,cornerNewToOld);
+  permuteProperty(ifs.getTexCoordBinding(),ifs.getTexCoord(),2,ifs.getTexCoordIndex(),
+                  vertexNewToOld,faceNewToOld,cornerNewToOld);
+
+  // 6) coordinates, and coordIndex with the new vertex indices
+  permuteValues(coord,3,vertexNewToOld);
+  permuteIndices(coordIndex,cornerNewToOld);
+  const int nTC = Parallel::getNumberOfThreads(0,nC,1<<16);
+  Parallel::forEachRange(nTC,nC,[&](int, size_t i0, size_t i1) {
+      for(size_t iC=i0;iC<i1;iC++) {
+        const int iV = coordIndex[iC];
+        if(iV>=0 && iV<nV) coordIndex[iC] = vertexOldToNew[iV];
+      }
+    });
+
+  // 7) the topology and the selections refer to the old indices
+  ifs.eraseVariable("PolygonMesh");
+  ifs.eraseVariable("coordSoA");
+  ifs.eraseVariable("vertexSelection");
+  ifs.eraseVariable("edgeSelection");
+  ifs.eraseVariable("faceSelection");
+  ifs.eraseVariable("cornerSelection");
+}
+
 void SceneGraphProcessor::_normalClear(IndexedFaceSet& ifs) {
   vector<float>& normal      = ifs.getNormal();
   vector<int>&   normalIndex = ifs.getNormalIndex();
@@ -167,161 +366,33 @@ void SceneGraphProcessor::_normalInvert(IndexedFaceSet& ifs) {
     normal[i] = -normal[i];
 }
 
-void SceneGraphProcessor::_computeFaceNormal
-(vector<float>& coord, vector<int>& coordIndex,
- int i0, int i1, Vec3f& n, bool normalize) {
-  int niF,iV,i;
-  Vec3f p,pi,ni,v1,v2;
-  niF = i1-i0; // number of face corners
-  // n << 0,0,0;
-  n[0] = n[1] = n[2] = 0.0f;
-  if(niF==3) { // triangle
-    // triangle
-    iV = coordIndex[i0];
-    // p << coord[3*iV  ],coord[3*iV+1],coord[3*iV+2];
-    p[0] = coord[3*iV  ]; p[1] = coord[3*iV+1]; p[2] = coord[3*iV+2];
-    iV = coordIndex[i0+1];
-    // v1 << coord[3*iV  ],coord[3*iV+1],coord[3*iV+2];
-    v1[0] = coord[3*iV  ]; v1[1] = coord[3*iV+1]; v1[2] = coord[3*iV+2];
-    iV = coordIndex[i0+2];
-    // v2 << coord[3*iV  ],coord[3*iV+1],coord[3*iV+2];
-    v2[0] = coord[3*iV  ]; v2[1] = coord[3*iV+1]; v2[2] = coord[3*iV+2];
-
-    // v1 -= p;
-    v1[0] -= p[0]; v1[1] -= p[1]; v1[2] -= p[2];
-    // v2 -= p;
-    v2[0] -= p[0]; v2[1] -= p[1]; v2[2] -= p[2];
-    // n = v1.cross(v2);
-    n[0] = v1[1]*v2[2]-v1[2]*v2[1];
-    n[1] = v1[2]*v2[0]-v1[0]*v2[2];
-    n[2] = v1[0]*v2[1]-v1[1]*v2[0];
-
-    if(normalize) {
-      // n.normalize();
-      float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
-      if(nn>0.0f) {
-        nn = (float)sqrt(nn);
-        n[0] /= nn; n[1] /= nn; n[2] /= nn;
-      }
-    }
-  } else if(niF>3) { // polygon
-    // compute face centroid
-    // p << 0,0,0;
-    p[0] = p[1] = p[2] = 0.0f;
-    for(i=i0;i<i1;i++) {
-      iV = coordIndex[i];
-      // pi << coord[3*iV  ],coord[3*iV+1],coord[3*iV+2];
-      pi[0] = coord[3*iV  ]; pi[1] = coord[3*iV+1]; pi[2] = coord[3*iV+2];
-      // p += pi;
-      p[0] += pi[0]; p[1] += pi[1]; p[2] += pi[2];
-    }
-    // p /= ((float)niF);
-    p[0] /= ((float)niF); p[1] /= ((float)niF); p[2] /= ((float)niF);
-    // accumulate face normal
-    iV = coordIndex[i1-1];
-    // v1 << coord[3*iV  ],coord[3*iV+1],coord[3*iV+2];
-    v1[0] = coord[3*iV  ]; v1[1] = coord[3*iV+1]; v1[2] = coord[3*iV+2];
-    // v1 -= p;
-    v1[0] -= p[0]; v1[1] -= p[1]; v1[2] -= p[2];
-    for(i=i0;i<i1;i++) {
-      iV = coordIndex[i];
-      // v2 << coord[3*iV  ],coord[3*iV+1],coord[3*iV+2];
-      v2[0] = coord[3*iV  ]; v2[1] = coord[3*iV+1]; v2[2] = coord[3*iV+2];
-      // v2 -= p;
-      v2[0] -= p[0]; v2[1] -= p[1]; v2[2] -= p[2];
-
-      // ni = v1.cross(v2);
-      ni[0] = v1[1]*v2[2]-v1[2]*v2[1];
-      ni[1] = v1[2]*v2[0]-v1[0]*v2[2];
-      ni[2] = v1[0]*v2[1]-v1[1]*v2[0];
-
-      // n += ni;
-      n[0] += ni[0]; n[1] += ni[1]; n[2] += ni[2];
-
-      // v1.swap(v2);
-      v1[0] = v2[0]; v1[1] = v2[1]; v1[2] = v2[2];
-    }
-    if(normalize) {
-      // n.normalize();
-      float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
-      if(nn>0.0f) {
-        nn = (float)sqrt(nn);
-        n[0] /= nn; n[1] /= nn; n[2] /= nn;
-      }
-    }
-  } else /* if(n<3) */{ // face with less than 3 vertices
-    // throw exception ?
-    // n == (0,0,0)
-  }
-}
-
 void SceneGraphProcessor::_computeNormalPerFace(IndexedFaceSet& ifs) {
   if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_FACE) return;
-  vector<float>& coord       = ifs.getCoord();
   vector<int>&   coordIndex  = ifs.getCoordIndex();
   vector<float>& normal      = ifs.getNormal();
   vector<int>&   normalIndex = ifs.getNormalIndex();
   ifs.setNormalPerVertex(false);
   normal.clear();
   normalIndex.clear();
-  Vec3f n;
-  int /*iF,*/ i0,i1;
-  for(i0=i1=0;i1<(int)coordIndex.size();i1++) {
-    if(coordIndex[i1]<0) {
-      _computeFaceNormal(coord,coordIndex,i0,i1,n,true);
-      normal.push_back((float)(n[0]));
-      normal.push_back((float)(n[1]));
-      normal.push_back((float)(n[2]));
-      i0=i1+1; /* iF++; */
-    }
-  }
+  // the SIMD kernels operate on separate x, y, and z arrays; the
+  // storage is kept with the IndexedFaceSet, but the values are copied
+  // again, since the coordinates may have been modified in place
+  CoordSoA& coordSoA = IndexedFaceSetVariables(ifs).getCoordSoA(true);
+  Geometry::computeNormalsPerFace(coordSoA,coordIndex,normal);
 }
 
 void SceneGraphProcessor::_computeNormalPerVertex(IndexedFaceSet& ifs) {
   if(ifs.getNormalBinding()==IndexedFaceSet::PB_PER_VERTEX) return;
-  vector<float>& coord       = ifs.getCoord();
   vector<int>&   coordIndex  = ifs.getCoordIndex();
   vector<float>& normal      = ifs.getNormal();
   vector<int>&   normalIndex = ifs.getNormalIndex();
   ifs.setNormalPerVertex(true);
   normal.clear();
   normalIndex.clear();
-  Vec3f n;
-  int /*iF,*/ nV,i,i0,i1,iV;
-  float x0,x1,x2;
-  nV = (int)(coord.size()/3);
-  // initialize accumulators
-  normal.insert(normal.end(),coord.size(),0.0f);
-  // accumulate face normals
-  for(i0=i1=0;i1<(int)coordIndex.size();i1++) {
-    if(coordIndex[i1]<0) {
-      _computeFaceNormal(coord,coordIndex,i0,i1,n,false);
-      // accumulate
-      for(i=i0;i<i1;i++) {
-        iV = coordIndex[i];
-        x0 = normal[3*iV  ];
-        x1 = normal[3*iV+1];
-        x2 = normal[3*iV+2];
-        normal[3*iV  ] = x0+((float)(n[0]));
-        normal[3*iV+1] = x1+((float)(n[1]));
-        normal[3*iV+2] = x2+((float)(n[2]));
-      }
-      i0=i1+1; /* iF++; */
-    }
-  }
-  for(iV=0;iV<nV;iV++) {
-    n[0] = normal[3*iV  ];
-    n[1] = normal[3*iV+1];
-    n[2] = normal[3*iV+2];
-    float nn = n[0]*n[0]+n[1]*n[1]+n[2]*n[2];
-    if(nn>0.0f) {
-      nn = (float)sqrt(nn);
-      n[0] /= nn; n[1] /= nn; n[2] /= nn;
-    }
-    normal[3*iV  ] = n[0];
-    normal[3*iV+1] = n[1];
-    normal[3*iV+2] = n[2];
-  }
+  // the SIMD kernels operate on separate x, y, and z arrays, copied
+  // again from the coordinates, as in _computeNormalPerFace()
+  CoordSoA& coordSoA = IndexedFaceSetVariables(ifs).getCoordSoA(true);
+  Geometry::computeNormalsPerVertex(coordSoA,coordIndex,normal);
 }
 
 void SceneGraphProcessor::_computeNormalPerCorner(IndexedFaceSet& ifs) {
@@ -595,29 +666,25 @@ void SceneGraphProcessor::gridAdd(HexGridPartition& hgp) {
   x0 = gridMin.x; y0 = gridMin.y; z0 = gridMin.z;
   x1 = gridMax.x; y1 = gridMax.y; z1 = gridMax.z;
 
-  map<int,int> vMap;
+  map<int64_t,int> vMap;
   Graph graph;
 
-  // int iPointFirst;
-  int h,iCell,iC,iCx,iCy,iCz,iVx,iVy,iVz,iVertex,iV[8],iV0,iV1,iE;
-  map<int,int> first =  hgp.getFirstMap();
-  map<int,int>::iterator iMap;
+  int h,iCx,iCy,iCz,iVx,iVy,iVz,iV[8],iV0,iV1,iE;
+  int64_t iVertex,N1 = N+1;
+  HexGridPartition::CellIterator iCell;
 
-  for(iMap=first.begin();iMap!=first.end();iMap++) {
-    iCell       = iMap->first;
-    iC = iCell; iCx = iC%N; iC/=N; iCy = iC%N; iC/=N; iCz = iC;
-
-    // iPointFirst = iMap->second;
+  for(iCell=hgp.cellsBegin();iCell!=hgp.cellsEnd();iCell++) {
+    hgp.getCellIndices(*iCell,iCx,iCy,iCz);
 
     // vertices
-    //
-    // 0 ---- 1
-    // |\     |\
-    // | 2 ---- 3
-    // 4 +--- 5 |
-    //  \|     \|
-    //   6 ---- 7
-    //
+    /*            */
+    /* 0 ---- 1   */
+    /* |\     |\  */
+    /* | 2 ---- 3 */
+    /* 4 +--- 5 | */
+    /*  \|     \| */
+    /*   6 ---- 7 */
+    /*            */
     // 0 : (iCx  ,iCy  ,iCz  )
     // 1 : (iCx+1,iCy  ,iCz  )
     // 2 : (iCx  ,iCy+1,iCz  )
@@ -630,7 +697,7 @@ void SceneGraphProcessor::gridAdd(HexGridPartition& hgp) {
       iVx   = iCx+((h  )%2);
       iVy   = iCy+((h/2)%2);
       iVz   = iCz+((h/4)%2);      
-      iVertex = iVx+(N+1)*(iVy+(N+1)*iVz);
+      iVertex = iVx+N1*(iVy+N1*iVz);
       if(vMap.count(iVertex)==0) {
         iV[h] = static_cast<int>(coord.size()/3);
         x = (((float)(N-iVx))*x0+((float)iVx)*x1)/((float)N);
@@ -657,7 +724,7 @@ void SceneGraphProcessor::gridAdd(HexGridPartition& hgp) {
       }
     }
     
-  } // for(iMap=first.begin();iMap!=first.end();iMap++)
+  } // for(iCell=hgp.cellsBegin();iCell!=hgp.cellsEnd();iCell++)
 }
 
 void SceneGraphProcessor::gridRemove() {
@@ -730,26 +797,16 @@ void SceneGraphProcessor::edgesAdd() {
         coordIls.insert(coordIls.end(),
                         coordIfs.begin(),coordIfs.end());
 
-        int i,i0,i1,nV,iV,iV0,iV1/*,iF*/;
-        nV = static_cast<int>(coordIfs.size()/3);
-        for(iV=0;iV<nV;iV++) {
-          coordIls.push_back(coordIfs[3*iV  ]);
-          coordIls.push_back(coordIfs[3*iV+1]);
-          coordIls.push_back(coordIfs[3*iV+2]);
-        }
-
-        for(/* iF= */ i0=i1=0;i1<(int)coordIndexIfs.size();i1++) {
-          if(coordIndexIfs[i1]<0) {
-            iV0 = coordIndexIfs[i1-1];
-            for(i=i0;i<i1;i++) {
-              iV1 = coordIndexIfs[i];
-              coordIndexIls.push_back(iV0);
-              coordIndexIls.push_back(iV1);
-              coordIndexIls.push_back(-1);
-              iV0 = iV1;
-            }
-            i0 = i1+1; /* iF++; */
-          }
+        // one polyline per edge, rather than one per half edge
+        int nV = static_cast<int>(coordIfs.size()/3);
+        Graph graph(nV);
+        graph.buildFromFaces(nV,coordIndexIfs);
+        int iE,nE = graph.getNumberOfEdges();
+        coordIndexIls.reserve(3*nE);
+        for(iE=0;iE<nE;iE++) {
+          coordIndexIls.push_back(graph.getVertex0(iE));
+          coordIndexIls.push_back(graph.getVertex1(iE));
+          coordIndexIls.push_back(-1);
         }
 
 
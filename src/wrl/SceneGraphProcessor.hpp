@@ -57,6 +57,18 @@ public:
   void computeNormalPerVertex();
   void computeNormalPerCorner();
 
+  // reorders the faces of each IndexedFaceSet along a Morton
+  // (Z-order) curve over the face centroids, renumbers the vertices
+  // in the order of first use by the reordered faces, and permutes
+  // all the per-vertex, per-face, and per-corner properties
+  // accordingly; the geometry and the properties of the mesh are not
+  // modified, but consecutive faces and vertices become close to
+  // each other in space, and so in memory; vertices not used by any
+  // face keep their relative order, after all the used ones; the
+  // PolygonMesh and the selections attached to the IndexedFaceSet
+  // are deleted
+  void reorderMesh();
+
   void gridAdd(int depth=0, float scale=1.0f, bool isCube=true);
   void gridAdd(HexGridPartition& hgp);
   void gridRemove();
@@ -94,14 +106,14 @@ public:
 private:
 
   // edges of hexahedron
-  //
-  // 0 ---- 1
-  // |\     |\
-  // | 2 ---- 3
-  // 4 +--- 5 |
-  //  \|     \|
-  //   6 ---- 7
-  //
+  /*            */
+  /* 0 ---- 1   */
+  /* |\     |\  */
+  /* | 2 ---- 3 */
+  /* 4 +--- 5 | */
+  /*  \|     \| */
+  /*   6 ---- 7 */
+  /*            */
   static const int _hexGridEdge[12][2];
 
   SceneGraph&    _wrl;
@@ -125,10 +137,7 @@ private:
   static void _computeNormalPerFace(IndexedFaceSet& ifs);
   static void _computeNormalPerVertex(IndexedFaceSet& ifs);
   static void _computeNormalPerCorner(IndexedFaceSet& ifs);
-
-  static void _computeFaceNormal
-              (vector<float>& coord, vector<int>&   coordIndex,
-               int i0, int i1, Vec3f& n, bool normalize);
+  static void _reorderMesh(IndexedFaceSet& ifs);
 
   bool        _hasShapeProperty(Shape::Property p);
   bool        _hasIndexedFaceSetProperty(IndexedFaceSet::Property p);